@@ -0,0 +1,277 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#ifndef BOOST_MP_ARENA_ALLOCATOR_HPP
+#define BOOST_MP_ARENA_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <boost/config.hpp>
+#include <boost/assert.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#ifndef BOOST_NO_CXX11_HDR_TYPE_TRAITS
+#include <type_traits>
+#endif
+
+//
+// The size of the first block an arena allocates, each further block is twice the size of the last:
+//
+#ifndef BOOST_MP_ARENA_BLOCK_SIZE
+#define BOOST_MP_ARENA_BLOCK_SIZE 4096
+#endif
+
+namespace boost{ namespace multiprecision{
+
+//
+// A monotonic arena: allocation just bumps a pointer through a list of blocks, deallocation only
+// reclaims the most recent allocation, and release() makes all the blocks available again without
+// returning them to the system.  So a loop which calls release() on each pass stops allocating
+// from the heap once its first pass is complete:
+//
+class arena : private boost::noncopyable
+{
+   union max_align_type
+   {
+      long double ld;
+      double d;
+      boost::long_long_type ll;
+      void* p;
+      void (*pf)();
+   };
+   struct block
+   {
+      block*      next;
+      std::size_t size;
+      max_align_type pad;  // Data starts here, suitably aligned.
+   };
+   BOOST_STATIC_CONSTANT(std::size_t, alignment = boost::alignment_of<max_align_type>::value);
+public:
+   explicit arena(std::size_t block_size = BOOST_MP_ARENA_BLOCK_SIZE)
+      : m_first(0), m_current(0), m_top(0), m_end(0), m_block_size(block_size ? block_size : 1), m_used(0) {}
+   ~arena()
+   {
+      while(m_first)
+      {
+         block* b = m_first;
+         m_first = b->next;
+         ::operator delete(b);
+      }
+   }
+   void* allocate(std::size_t bytes)
+   {
+      bytes = round_up(bytes);
+      if(static_cast<std::size_t>(m_end - m_top) < bytes)
+         next_block(bytes);
+      void* result = m_top;
+      m_top += bytes;
+      m_used += bytes;
+      return result;
+   }
+   void deallocate(void* p, std::size_t bytes) BOOST_NOEXCEPT
+   {
+      bytes = round_up(bytes);
+      if(static_cast<char*>(p) + bytes == m_top)
+      {
+         m_top -= bytes;
+         m_used -= bytes;
+      }
+   }
+   //
+   // Makes all the memory in the arena available for reuse, any values still using it must be
+   // destroyed (or be of no further interest) first:
+   //
+   void release() BOOST_NOEXCEPT
+   {
+      m_current = m_first;
+      if(m_current)
+      {
+         m_top = data(m_current);
+         m_end = m_top + m_current->size;
+      }
+      m_used = 0;
+   }
+   std::size_t used()const BOOST_NOEXCEPT { return m_used; }
+   std::size_t capacity()const BOOST_NOEXCEPT
+   {
+      std::size_t result = 0;
+      for(const block* b = m_first; b; b = b->next)
+         result += b->size;
+      return result;
+   }
+
+private:
+   static std::size_t round_up(std::size_t bytes) BOOST_NOEXCEPT
+   {
+      return bytes ? (bytes + alignment - 1) & ~(alignment - 1) : alignment;
+   }
+   static char* data(block* b) BOOST_NOEXCEPT
+   {
+      return reinterpret_cast<char*>(&b->pad);
+   }
+   void next_block(std::size_t bytes)
+   {
+      //
+      // Reuse the next block if it's big enough, otherwise insert a new one after the current
+      // block, so that after a release() the same sequence of requests is met from the same blocks:
+      //
+      block* next = m_current ? m_current->next : m_first;
+      if(!next || (next->size < bytes))
+      {
+         std::size_t size = m_block_size;
+         while(size < bytes)
+            size *= 2;
+         block* b = static_cast<block*>(::operator new(offsetof(block, pad) + size));
+         b->size = size;
+         b->next = next;
+         if(m_current)
+            m_current->next = b;
+         else
+            m_first = b;
+         next = b;
+         m_block_size = size * 2;
+      }
+      m_current = next;
+      m_top = data(next);
+      m_end = m_top + next->size;
+   }
+
+   block*      m_first;
+   block*      m_current;
+   char*       m_top;
+   char*       m_end;
+   std::size_t m_block_size;
+   std::size_t m_used;
+};
+
+namespace detail{
+
+inline arena*& current_arena() BOOST_NOEXCEPT
+{
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+   static thread_local arena* a = 0;
+#else
+   static arena* a = 0;
+#endif
+   return a;
+}
+
+}
+
+//
+// Makes an arena the current one for this thread, so that default constructed arena_allocators
+// (and hence default constructed numbers that use them) allocate from it, restores the previous
+// arena (if any) on destruction:
+//
+class arena_scope : private boost::noncopyable
+{
+public:
+   explicit arena_scope(arena& a) BOOST_NOEXCEPT : m_previous(detail::current_arena())
+   {
+      detail::current_arena() = &a;
+   }
+   ~arena_scope()
+   {
+      detail::current_arena() = m_previous;
+   }
+   static arena* current() BOOST_NOEXCEPT { return detail::current_arena(); }
+private:
+   arena* m_previous;
+};
+
+//
+// The allocator itself: copies share the same arena, default construction picks up the current arena
+// for the thread, or allocates from the heap if there is none:
+//
+template <class T>
+class arena_allocator
+{
+public:
+   typedef T                 value_type;
+   typedef T*                pointer;
+   typedef const T*          const_pointer;
+   typedef T&                reference;
+   typedef const T&          const_reference;
+   typedef std::size_t       size_type;
+   typedef std::ptrdiff_t    difference_type;
+#ifndef BOOST_NO_CXX11_HDR_TYPE_TRAITS
+   typedef std::false_type   propagate_on_container_copy_assignment;
+   typedef std::true_type    propagate_on_container_move_assignment;
+   typedef std::true_type    propagate_on_container_swap;
+#endif
+
+   template <class U>
+   struct rebind
+   {
+      typedef arena_allocator<U> other;
+   };
+
+   arena_allocator() BOOST_NOEXCEPT : m_arena(arena_scope::current()) {}
+   explicit arena_allocator(arena* a) BOOST_NOEXCEPT : m_arena(a) {}
+   template <class U>
+   arena_allocator(const arena_allocator<U>& o) BOOST_NOEXCEPT : m_arena(o.get_arena()) {}
+
+   arena* get_arena()const BOOST_NOEXCEPT { return m_arena; }
+
+   pointer address(reference x)const BOOST_NOEXCEPT { return &x; }
+   const_pointer address(const_reference x)const BOOST_NOEXCEPT { return &x; }
+   pointer allocate(size_type n, const void* = 0)
+   {
+      return static_cast<pointer>(m_arena ? m_arena->allocate(n * sizeof(T)) : ::operator new(n * sizeof(T)));
+   }
+   void deallocate(pointer p, size_type n) BOOST_NOEXCEPT
+   {
+      if(m_arena)
+         m_arena->deallocate(p, n * sizeof(T));
+      else
+         ::operator delete(p);
+   }
+   size_type max_size()const BOOST_NOEXCEPT { return ~static_cast<size_type>(0u) / sizeof(T); }
+   void construct(pointer p, const T& val) { new (static_cast<void*>(p)) T(val); }
+   void destroy(pointer p) { p->~T(); }
+
+private:
+   arena* m_arena;
+};
+
+template <>
+class arena_allocator<void>
+{
+public:
+   typedef void              value_type;
+   typedef void*             pointer;
+   typedef const void*       const_pointer;
+
+   template <class U>
+   struct rebind
+   {
+      typedef arena_allocator<U> other;
+   };
+
+   arena_allocator() BOOST_NOEXCEPT : m_arena(arena_scope::current()) {}
+   explicit arena_allocator(arena* a) BOOST_NOEXCEPT : m_arena(a) {}
+   template <class U>
+   arena_allocator(const arena_allocator<U>& o) BOOST_NOEXCEPT : m_arena(o.get_arena()) {}
+
+   arena* get_arena()const BOOST_NOEXCEPT { return m_arena; }
+
+private:
+   arena* m_arena;
+};
+
+template <class T, class U>
+inline bool operator == (const arena_allocator<T>& a, const arena_allocator<U>& b) BOOST_NOEXCEPT
+{
+   return a.get_arena() == b.get_arena();
+}
+template <class T, class U>
+inline bool operator != (const arena_allocator<T>& a, const arena_allocator<U>& b) BOOST_NOEXCEPT
+{
+   return a.get_arena() != b.get_arena();
+}
+
+}} // namespaces
+
+#endif
@@ -11,6 +11,19 @@
 #include <boost/math/special_functions/trunc.hpp>
 #include <boost/multiprecision/detail/float_string_cvt.hpp>
 
+//
+// Division of values with at least BOOST_MP_CPP_BIN_FLOAT_NEWTON_DIVIDE_CUTOFF bits uses a reciprocal of the divisor
+// found by Newton iteration.  The iteration and the multiplications which use its result are carried out in an arbitrary
+// precision cpp_int, so that they pick up the Karatsuba and Toom-3 multiplication code.  When the reciprocal is reused
+// by a cpp_bin_float_reciprocal it pays for itself at a much lower precision, BOOST_MP_CPP_BIN_FLOAT_RECIPROCAL_CUTOFF bits:
+//
+#ifndef BOOST_MP_CPP_BIN_FLOAT_NEWTON_DIVIDE_CUTOFF
+#define BOOST_MP_CPP_BIN_FLOAT_NEWTON_DIVIDE_CUTOFF 1500
+#endif
+#ifndef BOOST_MP_CPP_BIN_FLOAT_RECIPROCAL_CUTOFF
+#define BOOST_MP_CPP_BIN_FLOAT_RECIPROCAL_CUTOFF 150
+#endif
+
 namespace boost{ namespace multiprecision{ namespace backends{
 
 enum digit_base_type
@@ -40,6 +53,7 @@ public:
    static const unsigned bit_count = DigitBase == digit_base_2 ? Digits : (Digits * 1000uL) / 301uL + (((Digits * 1000uL) % 301) ? 2u : 1u);
    typedef cpp_int_backend<is_void<Allocator>::value ? bit_count : 0, bit_count, is_void<Allocator>::value ? unsigned_magnitude : signed_magnitude, unchecked, Allocator> rep_type;
    typedef cpp_int_backend<is_void<Allocator>::value ? 2 * bit_count : 0, 2 * bit_count, is_void<Allocator>::value ? unsigned_magnitude : signed_magnitude, unchecked, Allocator> double_rep_type;
+   typedef typename detail::scratch_type<double_rep_type>::type   double_scratch_type;  // For temporaries.
 
    typedef typename rep_type::signed_types                        signed_types;
    typedef typename rep_type::unsigned_types                      unsigned_types;
@@ -76,20 +90,14 @@ public:
    cpp_bin_float(const cpp_bin_float<D, B, A, E, MinE, MaxE> &o, typename boost::enable_if_c<(bit_count >= cpp_bin_float<D, B, A, E, MinE, MaxE>::bit_count)>::type const* = 0)
       : m_exponent(o.exponent()), m_sign(o.sign()) 
    {
-      typename cpp_bin_float<D, B, A, E, MinE, MaxE>::rep_type b(o.bits());
-      this->sign() = o.sign();
-      this->exponent() = o.exponent() + (int)bit_count - (int)cpp_bin_float<D, B, A, E, MinE, MaxE>::bit_count;
-      copy_and_round(*this, b);
+      *this = o;
    }
 
    template <unsigned D, digit_base_type B, class A, class E, E MinE, E MaxE>
    explicit cpp_bin_float(const cpp_bin_float<D, B, A, E, MinE, MaxE> &o, typename boost::disable_if_c<(bit_count >= cpp_bin_float<D, B, A, E, MinE, MaxE>::bit_count)>::type const* = 0)
       : m_exponent(o.exponent()), m_sign(o.sign()) 
    {
-      typename cpp_bin_float<D, B, A, E, MinE, MaxE>::rep_type b(o.bits());
-      this->sign() = o.sign();
-      this->exponent() = o.exponent() - (int)(cpp_bin_float<D, B, A, E, MinE, MaxE>::bit_count - bit_count);
-      copy_and_round(*this, b);
+      *this = o;
    }
 
    template <class Float>
@@ -115,9 +123,42 @@ public:
    template <unsigned D, digit_base_type B, class A, class E, E MinE, E MaxE>
    cpp_bin_float& operator=(const cpp_bin_float<D, B, A, E, MinE, MaxE> &o)
    {
-      typename cpp_bin_float<D, B, A, E, MinE, MaxE>::rep_type b(o.bits());
-      this->exponent() = o.exponent() + (int)bit_count - (int)cpp_bin_float<D, B, A, E, MinE, MaxE>::bit_count;
-      this->sign() = o.sign();
+      typedef cpp_bin_float<D, B, A, E, MinE, MaxE> other_type;
+      m_sign = o.sign();
+      //
+      // Special values, and values outside our exponent range (o may have a wider exponent type than ours),
+      // carry over without going through copy_and_round:
+      //
+      switch(o.exponent())
+      {
+      case other_type::exponent_zero:
+         m_data = static_cast<limb_type>(0u);
+         m_exponent = exponent_zero;
+         return *this;
+      case other_type::exponent_nan:
+         m_data = static_cast<limb_type>(0u);
+         m_exponent = exponent_nan;
+         return *this;
+      case other_type::exponent_infinity:
+         m_data = static_cast<limb_type>(0u);
+         m_exponent = exponent_infinity;
+         return *this;
+      }
+      if(o.exponent() > max_exponent)
+      {
+         m_data = static_cast<limb_type>(0u);
+         m_exponent = exponent_infinity;
+         return *this;
+      }
+      if(o.exponent() < min_exponent - 1)
+      {
+         m_data = static_cast<limb_type>(0u);
+         m_exponent = exponent_zero;
+         m_sign = false;
+         return *this;
+      }
+      typename other_type::rep_type b(o.bits());
+      m_exponent = static_cast<exponent_type>(o.exponent()) + (int)bit_count - (int)other_type::bit_count;
       copy_and_round(*this, b);
       return *this;
    }
@@ -458,13 +499,214 @@ inline void copy_and_round(cpp_bin_float<Digits, DigitBase, Allocator, Exponent,
    }
 }
 
+namespace detail{
+
+template <class Allocator>
+struct bin_float_newton_int
+{
+   typedef cpp_int_backend<0, 0, signed_magnitude, unchecked, Allocator> type;
+};
+template <>
+struct bin_float_newton_int<void>
+{
+   typedef cpp_int_backend<> type;
+};
+//
+// The reciprocal carries this many bits more than the divisor:
+//
+static const unsigned bin_float_newton_guard_bits = 64;
+//
+// Sets r to within a few units of 2^(2p) / d, where d has exactly p bits.  The reciprocal of the leading
+// p / 2 + 8 bits of d is found first, then one Newton step r = r + r (1 - d r) doubles its precision:
+//
+template <class Int>
+void newton_reciprocal(Int& r, const Int& d, unsigned p)
+{
+   using default_ops::eval_left_shift;
+   using default_ops::eval_right_shift;
+   if(p <= 512)
+   {
+      Int t;
+      t = static_cast<limb_type>(1u);
+      eval_left_shift(t, 2 * p);
+      eval_divide(r, t, d);
+      return;
+   }
+   unsigned h = p / 2 + 8;
+   Int t, e;
+   eval_right_shift(t, d, p - h);
+   newton_reciprocal(r, t, h);
+   //
+   // d r is close to 2^(p + h), the error e = 2^(p + h) - d r may have either sign:
+   //
+   eval_multiply(t, d, r);
+   e = static_cast<limb_type>(1u);
+   eval_left_shift(e, p + h);
+   eval_subtract(e, t);
+   eval_multiply(t, r, e);
+   eval_right_shift(t, 2 * h);
+   eval_left_shift(r, p - h);
+   eval_add(r, t);
+}
+//
+// Sets inverse to the reciprocal of the mantissa v, scaled by 2^(2 * Bits + bin_float_newton_guard_bits):
+//
+template <unsigned Bits, class Int, class Rep>
+void newton_inverse(Int& inverse, const Rep& v)
+{
+   using default_ops::eval_left_shift;
+   Int d;
+   d = v;
+   eval_left_shift(d, bin_float_newton_guard_bits);
+   newton_reciprocal(inverse, d, Bits + bin_float_newton_guard_bits);
+}
+//
+// Sets q and r to the quotient and remainder of u * 2^Bits / v, given the inverse of v from newton_inverse.
+// The estimate of the quotient is at most a couple of units out, and is corrected using the exact remainder:
+//
+template <unsigned Bits, class DoubleRep, class Rep, class Int>
+void newton_qr(DoubleRep& q, DoubleRep& r, const Rep& u, const Rep& v, const Int& inverse)
+{
+   using default_ops::eval_left_shift;
+   using default_ops::eval_right_shift;
+   using default_ops::eval_get_sign;
+   using default_ops::eval_increment;
+   using default_ops::eval_decrement;
+   Int a, b, qi, ri;
+   a = u;
+   b = v;
+   eval_multiply(qi, a, inverse);
+   eval_right_shift(qi, Bits + bin_float_newton_guard_bits);
+   eval_left_shift(a, Bits);
+   eval_multiply(ri, qi, b);
+   eval_subtract(ri, a, ri);
+   while(eval_get_sign(ri) < 0)
+   {
+      eval_decrement(qi);
+      eval_add(ri, b);
+   }
+   while(ri.compare(b) >= 0)
+   {
+      eval_increment(qi);
+      eval_subtract(ri, b);
+   }
+   q = qi;
+   r = ri;
+}
+//
+// Sets y to within a few units of 2^p / sqrt(a), where a holds a value in [1, 4) with p fraction bits.  The estimate
+// starts from double precision, and each step y = y + y (1 - a y^2) / 2 doubles the number of correct bits:
+//
+template <class Int>
+void newton_rsqrt(Int& y, const Int& a, unsigned p)
+{
+   using default_ops::eval_left_shift;
+   using default_ops::eval_right_shift;
+   using default_ops::eval_convert_to;
+   if(p <= 48)
+   {
+      double d;
+      eval_convert_to(&d, a);
+      d = std::ldexp(1 / std::sqrt(std::ldexp(d, -static_cast<int>(p))), static_cast<int>(p));
+      y = static_cast<boost::ulong_long_type>(d);
+      return;
+   }
+   unsigned h = p / 2 + 8;
+   Int t, e;
+   eval_right_shift(t, a, p - h);
+   newton_rsqrt(y, t, h);
+   //
+   // a y^2 is close to 2^(p + 2h), the error e = 2^(p + 2h) - a y^2 may have either sign:
+   //
+   eval_multiply(t, y, y);
+   eval_multiply(e, a, t);
+   t = static_cast<limb_type>(1u);
+   eval_left_shift(t, p + 2 * h);
+   eval_subtract(e, t, e);
+   eval_multiply(t, y, e);
+   eval_right_shift(t, 3 * h + 1);
+   eval_left_shift(y, p - h);
+   eval_add(y, t);
+}
+//
+// Sets s to within a few units of 2^p sqrt(a), with a as above.  1 / sqrt(a) is needed to only half the
+// precision, as the final step s = a y + y (a - (a y)^2) / 2 (due to Karp and Markstein) doubles the
+// precision of s = a y:
+//
+template <class Int>
+void newton_sqrt(Int& s, const Int& a, unsigned p)
+{
+   using default_ops::eval_left_shift;
+   using default_ops::eval_right_shift;
+   unsigned h = p / 2 + 8;
+   Int y, t, d;
+   eval_right_shift(t, a, p - h);
+   newton_rsqrt(y, t, h);
+   eval_multiply(s, t, y);
+   eval_right_shift(s, h);
+   eval_multiply(t, s, s);
+   eval_left_shift(d, a, 2 * h - p);
+   eval_subtract(d, t);
+   eval_multiply(t, y, d);
+   eval_right_shift(t, 3 * h + 1 - p);
+   eval_left_shift(s, p - h);
+   eval_add(s, t);
+}
+//
+// Sets s = floor(sqrt(x)) and r = x - s^2 for x > 0:
+//
+template <class Int>
+void newton_sqrt_rem(Int& s, Int& r, const Int& x)
+{
+   using default_ops::eval_left_shift;
+   using default_ops::eval_right_shift;
+   using default_ops::eval_get_sign;
+   using default_ops::eval_increment;
+   using default_ops::eval_decrement;
+   using default_ops::eval_msb;
+   //
+   // x = a 2^(2m - 2) with a in [1, 4), and the fraction of a carries the guard bits:
+   //
+   unsigned m = (eval_msb(x) + 2) / 2;
+   unsigned p = m + bin_float_newton_guard_bits;
+   Int a, t;
+   if(p >= 2 * m - 2)
+      eval_left_shift(a, x, p + 2 - 2 * m);
+   else
+      eval_right_shift(a, x, 2 * m - 2 - p);
+   newton_sqrt(s, a, p);
+   eval_right_shift(s, p + 1 - m);
+   //
+   // s is at most a couple of units out, correct it using the exact remainder:
+   //
+   eval_multiply(r, s, s);
+   eval_subtract(r, x, r);
+   while(eval_get_sign(r) < 0)
+   {
+      eval_decrement(s);
+      eval_add(r, s);
+      eval_add(r, s);
+      eval_increment(r);
+   }
+   eval_left_shift(t, s, 1u);
+   while(r.compare(t) > 0)
+   {
+      eval_subtract(r, t);
+      eval_decrement(r);
+      eval_increment(s);
+      eval_left_shift(t, s, 1u);
+   }
+}
+
+}
+
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
 inline void do_eval_add(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &a, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &b)
 {
    using default_ops::eval_add;
    using default_ops::eval_bit_test;
 
-   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type dt;
+   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_scratch_type dt;
 
    // Special cases first:
    switch(a.exponent())
@@ -538,7 +780,7 @@ inline void do_eval_subtract(cpp_bin_float<Digits, DigitBase, Allocator, Exponen
    using default_ops::eval_subtract;
    using default_ops::eval_bit_test;
 
-   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type dt;
+   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_scratch_type dt;
    
    // Special cases first:
    switch(a.exponent())
@@ -703,7 +945,7 @@ inline void eval_multiply(cpp_bin_float<Digits, DigitBase, Allocator, Exponent,
       }
    }
 
-   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type dt;
+   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_scratch_type dt;
    eval_multiply(dt, a.bits(), b.bits());
    res.exponent() = a.exponent() + b.exponent() - cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count + 1;
    copy_and_round(res, dt);
@@ -740,7 +982,7 @@ inline typename enable_if_c<is_unsigned<U>::value>::type eval_multiply(cpp_bin_f
       return;
    }
 
-   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type dt;
+   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_scratch_type dt;
    typedef typename boost::multiprecision::detail::canonical<U, typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type>::type canon_ui_type;
    eval_multiply(dt, a.bits(), static_cast<canon_ui_type>(b));
    res.exponent() = a.exponent();
@@ -770,8 +1012,53 @@ inline typename enable_if_c<is_signed<S>::value>::type eval_multiply(cpp_bin_flo
    eval_multiply(res, res, b);
 }
 
+//
+// Adds a*b to an accumulator with at least twice our precision: the product of the mantissas fits in the
+// accumulator exactly, so only the addition rounds.  Special values, and products outside the accumulator's
+// exponent range, go the long way round via eval_multiply in the accumulator's type:
+//
+template <unsigned D, digit_base_type B, class A, class E, E MinE2, E MaxE2, unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+inline typename enable_if_c<(cpp_bin_float<D, B, A, E, MinE2, MaxE2>::bit_count >= 2 * cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count)>::type
+   eval_accumulate_product(cpp_bin_float<D, B, A, E, MinE2, MaxE2> &acc, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &a, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &b, bool subtract)
+{
+   typedef cpp_bin_float<D, B, A, E, MinE2, MaxE2> accumulator_type;
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   using default_ops::eval_multiply;
+
+   accumulator_type t;
+   E ea = a.exponent();
+   E eb = b.exponent();
+   bool slow = (a.exponent() > float_type::max_exponent) || (b.exponent() > float_type::max_exponent)
+      || ((ea > 0) && (eb > 0) && (accumulator_type::max_exponent - ea < eb + 1))
+      || ((ea < 0) && (eb < 0) && (accumulator_type::min_exponent - ea > eb + 1));
+   if(slow)
+   {
+      accumulator_type x(a), y(b);
+      eval_multiply(t, x, y);
+   }
+   else
+   {
+      typename accumulator_type::rep_type dt;
+      eval_multiply(dt, a.bits(), b.bits());
+      //
+      // copy_and_round takes the exponent relative to the accumulator's bit_count, which may be more than
+      // the 2 * bit_count bits of the product:
+      //
+      t.exponent() = ea + eb + 1 + static_cast<E>(accumulator_type::bit_count - 2 * float_type::bit_count);
+      copy_and_round(t, dt);
+      t.sign() = a.sign() != b.sign();
+   }
+   if(subtract)
+      eval_subtract(acc, t);
+   else
+      eval_add(acc, t);
+}
+
+//
+// Divides u by v, if inverse is non-null it holds the reciprocal of the mantissa of v as set by detail::newton_inverse:
+//
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
-inline void eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &u, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &v)
+inline void do_eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &u, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &v, const typename detail::bin_float_newton_int<Allocator>::type* inverse)
 {
 #ifdef BOOST_MSVC
 #pragma warning(push)
@@ -852,9 +1139,23 @@ inline void eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, Mi
    //
    // Now get the quotient and remainder:
    //
-   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type t(u.bits()), t2(v.bits()), q, r;
-   eval_left_shift(t, cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count);
-   eval_qr(t, t2, q, r);
+   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_scratch_type q, r;
+   if(inverse)
+   {
+      detail::newton_qr<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count>(q, r, u.bits(), v.bits(), *inverse);
+   }
+   else if(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count >= BOOST_MP_CPP_BIN_FLOAT_NEWTON_DIVIDE_CUTOFF)
+   {
+      typename detail::scratch_type<typename detail::bin_float_newton_int<Allocator>::type>::type inv;
+      detail::newton_inverse<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count>(inv, v.bits());
+      detail::newton_qr<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count>(q, r, u.bits(), v.bits(), inv);
+   }
+   else
+   {
+      typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_scratch_type t(u.bits()), t2(v.bits());
+      eval_left_shift(t, cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count);
+      eval_qr(t, t2, q, r);
+   }
    //
    // We now have either "cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count" 
    // or "cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count+1" significant 
@@ -902,6 +1203,12 @@ inline void eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, Mi
 #endif
 }
 
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+inline void eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &u, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &v)
+{
+   do_eval_divide(res, u, v, static_cast<const typename detail::bin_float_newton_int<Allocator>::type*>(0));
+}
+
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
 inline void eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
 {
@@ -970,7 +1277,7 @@ inline typename enable_if_c<is_unsigned<U>::value>::type eval_divide(cpp_bin_flo
    //
    // Now get the quotient and remainder:
    //
-   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type t(u.bits()), q, r;
+   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_scratch_type t(u.bits()), q, r;
    eval_left_shift(t, gb + 1);
    eval_qr(t, number<typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type>::canonical_value(v), q, r);
    //
@@ -1278,7 +1585,6 @@ inline int eval_fpclassify(const cpp_bin_float<Digits, DigitBase, Allocator, Exp
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
 inline void eval_sqrt(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
 {
-   using default_ops::eval_integer_sqrt;
    using default_ops::eval_bit_test;
    using default_ops::eval_increment;
    switch(arg.exponent())
@@ -1297,9 +1603,17 @@ inline void eval_sqrt(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE
       return;
    }
 
-   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type t(arg.bits()), r, s;
+   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_scratch_type t(arg.bits()), r, s;
    eval_left_shift(t, arg.exponent() & 1 ? cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count : cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count - 1);
-   eval_integer_sqrt(s, r, t);
+   //
+   // The square root and remainder come from a Newton iteration which starts from a double and doubles
+   // its precision at each step, this is much quicker than a bit-by-bit integer square root at any precision:
+   //
+   typename detail::scratch_type<typename detail::bin_float_newton_int<Allocator>::type>::type ti, si, ri;
+   ti = t;
+   detail::newton_sqrt_rem(si, ri, ti);
+   s = si;
+   r = ri;
 
    if(!eval_bit_test(s, cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count))
    {
@@ -1316,6 +1630,51 @@ inline void eval_sqrt(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE
    copy_and_round(res, s);
 }
 
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+inline void eval_rsqrt(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   using default_ops::eval_left_shift;
+   switch(arg.exponent())
+   {
+   case cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::exponent_zero:
+      res = std::numeric_limits<number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> > >::infinity().backend();
+      res.sign() = arg.sign();
+      return;
+   case cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::exponent_nan:
+      res = arg;
+      return;
+   case cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::exponent_infinity:
+      if(arg.sign())
+         res = std::numeric_limits<number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> > >::quiet_NaN().backend();
+      else
+         res = limb_type(0u);
+      return;
+   }
+   if(arg.sign())
+   {
+      res = std::numeric_limits<number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> > >::quiet_NaN().backend();
+      return;
+   }
+   //
+   // arg = a 2^e with a in [1, 4) and e even, a is held with p fraction bits, of which
+   // bin_float_newton_guard_bits are guard bits:
+   //
+   static const unsigned p = cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count + detail::bin_float_newton_guard_bits;
+   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::exponent_type e = arg.exponent();
+   typename detail::bin_float_newton_int<Allocator>::type a, y;
+   a = arg.bits();
+   eval_left_shift(a, p + 1 - cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count + (e & 1));
+   e -= e & 1;
+   detail::newton_rsqrt(y, a, p);
+   //
+   // y has p fraction bits and is at most a few units out, so the result is faithfully rounded, and
+   // correctly rounded unless arg lies within a few units in the 64th guard bit of a halfway case:
+   //
+   res.exponent() = static_cast<int>(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count) - 1 - static_cast<int>(p) - e / 2;
+   res.sign() = false;
+   copy_and_round(res, y);
+}
+
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
 inline void eval_floor(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
 {
@@ -1397,6 +1756,72 @@ inline void eval_ceil(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE
    eval_left_shift(res.bits(), shift);
 }
 
+//
+// cpp_bin_float has no guard digits, so the AGM based log is carried out with 64 extra bits to absorb
+// the cancellation in its final subtraction:
+//
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+inline void eval_log_agm(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   typedef cpp_bin_float<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count + 64, digit_base_2, Allocator, Exponent, MinE, MaxE> guarded_type;
+   guarded_type x(arg), r;
+   default_ops::eval_log_agm(r, x);
+   res = r;
+}
+
+//
+// Holds a divisor together with the reciprocal of its mantissa, so that repeated division by the same value
+// need only carry out the Newton iteration once.  Below BOOST_MP_CPP_BIN_FLOAT_RECIPROCAL_CUTOFF bits no
+// reciprocal is stored and long division is used as normal.  Either way the results are correctly rounded:
+//
+template <class Float>
+class cpp_bin_float_reciprocal;
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+class cpp_bin_float_reciprocal<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >
+{
+public:
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   typedef typename detail::bin_float_newton_int<Allocator>::type int_type;
+
+   cpp_bin_float_reciprocal() : m_has_inverse(false) {}
+   explicit cpp_bin_float_reciprocal(const float_type& v)
+   {
+      assign(v);
+   }
+   template <expression_template_option ExpressionTemplates>
+   explicit cpp_bin_float_reciprocal(const number<float_type, ExpressionTemplates>& v)
+   {
+      assign(v.backend());
+   }
+
+   void assign(const float_type& v)
+   {
+      m_divisor = v;
+      m_has_inverse = (float_type::bit_count >= BOOST_MP_CPP_BIN_FLOAT_RECIPROCAL_CUTOFF) && (eval_fpclassify(v) == FP_NORMAL);
+      if(m_has_inverse)
+         detail::newton_inverse<float_type::bit_count>(m_inverse, v.bits());
+   }
+   const float_type& divisor()const { return m_divisor; }
+   const int_type* inverse()const { return m_has_inverse ? &m_inverse : 0; }
+private:
+   float_type m_divisor;
+   int_type m_inverse;
+   bool m_has_inverse;
+};
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+inline void eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &u, const cpp_bin_float_reciprocal<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> > &v)
+{
+   do_eval_divide(res, u, v.divisor(), v.inverse());
+}
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+inline void eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float_reciprocal<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> > &v)
+{
+   do_eval_divide(res, res, v.divisor(), v.inverse());
+}
+
 } // namespace backends
 
 #ifdef BOOST_NO_SFINAE_EXPR
@@ -1413,6 +1838,7 @@ struct is_explicitly_convertible<backends::cpp_bin_float<D1, B1, A1, E1, M1, M2>
 using backends::cpp_bin_float;
 using backends::digit_base_2;
 using backends::digit_base_10;
+using backends::cpp_bin_float_reciprocal;
 
 template<unsigned Digits, backends::digit_base_type DigitBase, class Exponent, Exponent MinE, Exponent MaxE, class Allocator>
 struct number_category<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> > : public boost::mpl::int_<boost::multiprecision::number_kind_floating_point>{};
@@ -1423,6 +1849,73 @@ struct expression_template_default<cpp_bin_float<Digits, DigitBase, Allocator, E
    static const expression_template_option value = is_void<Allocator>::value ? et_off : et_on;
 };
 
+namespace detail{
+//
+// The sum_of_products accumulator has twice the precision, and when possible a wider exponent type
+// so that it covers our whole exponent range.  If neither that, nor a type with the same explicit
+// exponent limits as ours, is possible we accumulate in our own type:
+//
+template <class Float, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, bool = (sizeof(Exponent) < sizeof(boost::long_long_type))>
+struct bin_float_accumulator
+{
+   typedef backends::cpp_bin_float<2 * Float::bit_count, backends::digit_base_2, Allocator, boost::long_long_type> type;
+};
+template <class Float, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+struct bin_float_accumulator<Float, Allocator, Exponent, MinE, MaxE, false>
+{
+   static const bool fits = (MinE != 0) && (MaxE != 0)
+      && (MaxE <= boost::integer_traits<Exponent>::const_max - 4 * static_cast<Exponent>(Float::bit_count))
+      && (MinE >= boost::integer_traits<Exponent>::const_min + 4 * static_cast<Exponent>(Float::bit_count));
+   typedef typename mpl::if_c<fits, backends::cpp_bin_float<2 * Float::bit_count, backends::digit_base_2, Allocator, Exponent, MinE, MaxE>, Float>::type type;
+};
+
+}
+
+template<unsigned Digits, backends::digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+struct sum_of_products_accumulator<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >
+   : public detail::bin_float_accumulator<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>, Allocator, Exponent, MinE, MaxE> {};
+
+namespace default_ops{
+//
+// Constants are evaluated by binary splitting in cpp_int:
+//
+template<unsigned Digits, backends::digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+struct constant_integer<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >
+{
+   typedef backends::cpp_int_backend<> type;
+   static void convert(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>& result, const type& i)
+   {
+      type t(i);
+      bool neg = eval_get_sign(t) < 0;
+      if(neg)
+         t.negate();
+      result.sign() = false;
+      result.exponent() = cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count - 1;
+      copy_and_round(result, t);
+      if(neg)
+         result.negate();
+   }
+   static void truncate(type& result, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>& f)
+   {
+      typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+      typedef typename mpl::front<typename type::unsigned_types>::type ui_type;
+      if((eval_fpclassify(f) != FP_NORMAL) || (f.exponent() < 0))
+      {
+         result = ui_type(0u);
+         return;
+      }
+      result = f.bits();
+      if(f.exponent() < static_cast<Exponent>(float_type::bit_count) - 1)
+         eval_right_shift(result, static_cast<unsigned>(float_type::bit_count - 1 - f.exponent()));
+      else
+         eval_left_shift(result, static_cast<unsigned>(f.exponent() - static_cast<Exponent>(float_type::bit_count) + 1));
+      if(f.sign())
+         result.negate();
+   }
+};
+
+}
+
 typedef number<backends::cpp_bin_float<50> > cpp_bin_float_50;
 typedef number<backends::cpp_bin_float<100> > cpp_bin_float_100;
 
@@ -1431,10 +1924,35 @@ typedef number<backends::cpp_bin_float<53, backends::digit_base_2, void, boost::
 typedef number<backends::cpp_bin_float<64, backends::digit_base_2, void, boost::int16_t, -16382, 16383>, et_off> cpp_bin_float_double_extended;
 typedef number<backends::cpp_bin_float<113, backends::digit_base_2, void, boost::int16_t, -16382, 16383>, et_off> cpp_bin_float_quad;
 
+//
+// reciprocal(v) returns an object which divides by v, u / reciprocal(v) is correctly rounded and so always equal to u / v:
+//
+template <unsigned Digits, backends::digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, expression_template_option ExpressionTemplates>
+inline cpp_bin_float_reciprocal<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> > reciprocal(const number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>, ExpressionTemplates>& v)
+{
+   return cpp_bin_float_reciprocal<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >(v);
+}
+
+template <unsigned Digits, backends::digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, expression_template_option ExpressionTemplates>
+inline number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>, ExpressionTemplates> operator/(const number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>, ExpressionTemplates>& u, const cpp_bin_float_reciprocal<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >& v)
+{
+   number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>, ExpressionTemplates> result;
+   eval_divide(result.backend(), u.backend(), v);
+   return BOOST_MP_MOVE(result);
+}
+
+template <unsigned Digits, backends::digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, expression_template_option ExpressionTemplates>
+inline number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>, ExpressionTemplates>& operator/=(number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>, ExpressionTemplates>& u, const cpp_bin_float_reciprocal<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >& v)
+{
+   eval_divide(u.backend(), v);
+   return u;
+}
+
 }} // namespaces
 
 #include <boost/multiprecision/cpp_bin_float/io.hpp>
 #include <boost/multiprecision/cpp_bin_float/transcendental.hpp>
+#include <boost/multiprecision/cpp_bin_float/accumulator.hpp>
 
 namespace std{
 
@@ -0,0 +1,318 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+#ifndef BOOST_MULTIPRECISION_CPP_BIN_FLOAT_ACCUMULATOR_HPP
+#define BOOST_MULTIPRECISION_CPP_BIN_FLOAT_ACCUMULATOR_HPP
+
+#include <vector>
+
+//
+// A cpp_bin_float_accumulator adds values into signed 64-bit digits each holding 32 bits of the exact sum, and only
+// propagates carries between digits once every BOOST_MP_CPP_BIN_FLOAT_ACCUMULATOR_CARRY_LIMIT additions.  The limit
+// can not be more than 2^30, or the digits may overflow, nor less than 2:
+//
+#ifndef BOOST_MP_CPP_BIN_FLOAT_ACCUMULATOR_CARRY_LIMIT
+#define BOOST_MP_CPP_BIN_FLOAT_ACCUMULATOR_CARRY_LIMIT (1uL << 30)
+#endif
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+//
+// Holds the exact sum of any number of cpp_bin_float values as a fixed point number, so that the sum is rounded
+// just once, when it is read back with sum(), and so does not depend on the order of the additions.  The digits
+// cover just the range of exponents which have been added so far, and grow as needed:
+//
+template <class Float>
+class cpp_bin_float_accumulator;
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+class cpp_bin_float_accumulator<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >
+{
+public:
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+
+   cpp_bin_float_accumulator() : m_offset(0), m_pending(0), m_nan(false), m_positive_infinity(false), m_negative_infinity(false) {}
+
+   void add(const float_type& x)
+   {
+      do_add(x, x.sign());
+   }
+   void subtract(const float_type& x)
+   {
+      do_add(x, !x.sign());
+   }
+   template <expression_template_option ExpressionTemplates>
+   cpp_bin_float_accumulator& operator+=(const number<float_type, ExpressionTemplates>& x)
+   {
+      add(x.backend());
+      return *this;
+   }
+   template <expression_template_option ExpressionTemplates>
+   cpp_bin_float_accumulator& operator-=(const number<float_type, ExpressionTemplates>& x)
+   {
+      subtract(x.backend());
+      return *this;
+   }
+   //
+   // Merging two accumulators just adds their digits, so that partial sums from separate threads can be combined exactly:
+   //
+   cpp_bin_float_accumulator& operator+=(const cpp_bin_float_accumulator& o)
+   {
+      m_nan |= o.m_nan;
+      m_positive_infinity |= o.m_positive_infinity;
+      m_negative_infinity |= o.m_negative_infinity;
+      if(o.m_digits.empty())
+         return *this;
+      if(o.m_pending > carry_limit / 2)
+      {
+         cpp_bin_float_accumulator t(o);
+         t.normalize();
+         return *this += t;
+      }
+      if(m_pending > carry_limit / 2)
+         normalize();
+      std::size_t first = extend(o.m_offset, o.m_offset + static_cast<boost::long_long_type>(o.m_digits.size()));
+      for(std::size_t i = 0; i < o.m_digits.size(); ++i)
+         m_digits[first + i] += o.m_digits[i];
+      m_pending += o.m_pending;
+      return *this;
+   }
+   void clear()
+   {
+      m_digits.clear();
+      m_offset = 0;
+      m_pending = 0;
+      m_nan = m_positive_infinity = m_negative_infinity = false;
+   }
+   //
+   // Returns the sum correctly rounded to nearest:
+   //
+   float_type sum()const
+   {
+      using default_ops::eval_msb;
+      using default_ops::eval_lsb;
+      using default_ops::eval_bit_set;
+
+      if(m_nan || (m_positive_infinity && m_negative_infinity))
+         return special_value(float_type::exponent_nan, false);
+      if(m_positive_infinity || m_negative_infinity)
+         return special_value(float_type::exponent_infinity, m_negative_infinity);
+      cpp_bin_float_accumulator t(*this);
+      t.normalize();
+      bool neg = !t.m_digits.empty() && (t.m_digits.back() < 0);
+      if(neg)
+      {
+         for(std::size_t i = 0; i < t.m_digits.size(); ++i)
+            t.m_digits[i] = -t.m_digits[i];
+         t.normalize();
+      }
+      std::size_t top = t.m_digits.size();
+      while(top && !t.m_digits[top - 1])
+         --top;
+      if(!top)
+         return special_value(float_type::exponent_zero, false);
+      --top;
+      //
+      // Check for overflow and underflow before any arithmetic on the exponent:
+      //
+      boost::long_long_type top_digit = t.m_offset + static_cast<boost::long_long_type>(top);
+      if(top_digit > float_type::max_exponent / static_cast<boost::long_long_type>(digit_bits) + 1)
+         return special_value(float_type::exponent_infinity, neg);
+      if(top_digit < float_type::min_exponent / static_cast<boost::long_long_type>(digit_bits) - 2)
+         return special_value(float_type::exponent_zero, false);
+      //
+      // The leading digits, with at least 64 guard bits below the last bit of the result, are enough to round
+      // correctly provided we note whether any of the digits below them are non-zero:
+      //
+      std::size_t low = top + 1 > leading_digits ? top + 1 - leading_digits : 0;
+      bool sticky = false;
+      for(std::size_t i = 0; i < low; ++i)
+      {
+         if(t.m_digits[i])
+         {
+            sticky = true;
+            break;
+         }
+      }
+      int_type r;
+      r = static_cast<limb_type>(t.m_digits[top]);
+      for(std::size_t i = top; i > low; --i)
+      {
+         eval_left_shift(r, digit_bits);
+         eval_add(r, static_cast<limb_type>(t.m_digits[i - 1]));
+      }
+      boost::long_long_type e = static_cast<boost::long_long_type>(digit_bits) * (t.m_offset + static_cast<boost::long_long_type>(low)) + eval_msb(r);
+      if(e > float_type::max_exponent)
+         return special_value(float_type::exponent_infinity, neg);
+      if(e < float_type::min_exponent - 1)
+         return special_value(float_type::exponent_zero, false);
+      //
+      // Keep just one bit beyond the rounding bit, so that the exponent passed to copy_and_round stays in range:
+      //
+      unsigned msb = eval_msb(r);
+      if(msb > float_type::bit_count + 1)
+      {
+         unsigned shift = msb - float_type::bit_count - 1;
+         if(eval_lsb(r) < shift)
+            sticky = true;
+         eval_right_shift(r, shift);
+         msb -= shift;
+      }
+      if(sticky)
+         eval_bit_set(r, 0);
+      float_type result;
+      result.exponent() = static_cast<Exponent>(e - static_cast<boost::long_long_type>(msb) + static_cast<boost::long_long_type>(float_type::bit_count) - 1);
+      result.sign() = neg;
+      copy_and_round(result, r);
+      return result;
+   }
+
+private:
+   typedef boost::int64_t digit_type;
+   static const unsigned digit_bits = 32;
+   static const boost::uint64_t digit_mask = 0xFFFFFFFFuL;
+   static const boost::uint64_t carry_limit = BOOST_MP_CPP_BIN_FLOAT_ACCUMULATOR_CARRY_LIMIT;
+   BOOST_STATIC_ASSERT_MSG((carry_limit >= 2) && (carry_limit <= (1uL << 30)), "BOOST_MP_CPP_BIN_FLOAT_ACCUMULATOR_CARRY_LIMIT must be in the range [2, 2^30]");
+   //
+   // The number of 32-bit chunks in a mantissa, and the number of digits it spans once shifted into place:
+   //
+   static const unsigned chunks = (float_type::bit_count + digit_bits - 1) / digit_bits;
+   static const unsigned span = chunks + 1;
+   static const unsigned leading_digits = (float_type::bit_count + 64 + 2 * digit_bits - 1) / digit_bits;
+   //
+   // Small fixed precision mantissas are held in a single native integer, rather than in limb_type's:
+   //
+   typedef typename float_type::rep_type::const_limb_pointer const_limb_pointer;
+   typedef typename remove_const<typename remove_pointer<const_limb_pointer>::type>::type rep_limb_type;
+   static const unsigned limb_bits = sizeof(rep_limb_type) * CHAR_BIT;
+
+   typedef cpp_int_backend<is_void<Allocator>::value ? (leading_digits + 1) * digit_bits : 0, (leading_digits + 1) * digit_bits, is_void<Allocator>::value ? unsigned_magnitude : signed_magnitude, unchecked, Allocator> int_type;
+
+   static float_type special_value(Exponent e, bool neg)
+   {
+      float_type result;
+      result.bits() = static_cast<limb_type>(0u);
+      result.exponent() = e;
+      result.sign() = neg;
+      return result;
+   }
+   static boost::long_long_type floor_div(boost::long_long_type p)
+   {
+      return p >= 0 ? p / digit_bits : -((-p + digit_bits - 1) / digit_bits);
+   }
+   //
+   // Makes sure that the digits cover [first, last), and returns the index of the digit for first.
+   // We grow by at least half the current size each time, so that repeated growth is cheap:
+   //
+   std::size_t extend(boost::long_long_type first, boost::long_long_type last)
+   {
+      if(m_digits.empty())
+      {
+         m_digits.assign(static_cast<std::size_t>(last - first), 0);
+         m_offset = first;
+         return 0;
+      }
+      boost::long_long_type end = m_offset + static_cast<boost::long_long_type>(m_digits.size());
+      boost::long_long_type margin = static_cast<boost::long_long_type>(m_digits.size() / 2 + span);
+      if(first < m_offset)
+      {
+         boost::long_long_type n = m_offset - first + margin;
+         m_digits.insert(m_digits.begin(), static_cast<std::size_t>(n), 0);
+         m_offset -= n;
+      }
+      if(last > end)
+         m_digits.resize(static_cast<std::size_t>(last - m_offset + margin), 0);
+      return static_cast<std::size_t>(first - m_offset);
+   }
+   void do_add(const float_type& x, bool negative)
+   {
+      switch(x.exponent())
+      {
+      case float_type::exponent_zero:
+         return;
+      case float_type::exponent_nan:
+         m_nan = true;
+         return;
+      case float_type::exponent_infinity:
+         if(negative)
+            m_negative_infinity = true;
+         else
+            m_positive_infinity = true;
+         return;
+      }
+      if(m_pending >= carry_limit)
+         normalize();
+      //
+      // The least significant bit of the mantissa has value 2^p, find the digit it falls in, and its position in that digit:
+      //
+      boost::long_long_type p = static_cast<boost::long_long_type>(x.exponent()) - static_cast<boost::long_long_type>(float_type::bit_count) + 1;
+      boost::long_long_type d = floor_div(p);
+      unsigned s = static_cast<unsigned>(p - d * static_cast<boost::long_long_type>(digit_bits));
+      std::size_t first = extend(d, d + span);
+      digit_type* pd = &m_digits[first];
+      ++m_pending;
+
+      const_limb_pointer pl = x.bits().limbs();
+      unsigned n = x.bits().size();
+      boost::uint64_t carry = 0;
+      for(unsigned i = 0; i < chunks; ++i)
+      {
+         unsigned bit = i * digit_bits;
+         boost::uint64_t c = bit / limb_bits < n ? (static_cast<boost::uint64_t>(pl[bit / limb_bits] >> (bit % limb_bits)) & digit_mask) : 0u;
+         boost::uint64_t v = (c << s) + carry;
+         if(negative)
+            pd[i] -= static_cast<digit_type>(v & digit_mask);
+         else
+            pd[i] += static_cast<digit_type>(v & digit_mask);
+         carry = v >> digit_bits;
+      }
+      if(negative)
+         pd[chunks] -= static_cast<digit_type>(carry);
+      else
+         pd[chunks] += static_cast<digit_type>(carry);
+   }
+   //
+   // Propagates carries so that every digit but the most significant lies in [0, 2^32), the most significant
+   // digit carries the sign and lies in [-2^32, 2^32):
+   //
+   void normalize()
+   {
+      if(m_digits.empty())
+         return;
+      digit_type carry = 0;
+      for(std::size_t i = 0; i + 1 < m_digits.size(); ++i)
+      {
+         digit_type v = m_digits[i] + carry;
+         m_digits[i] = static_cast<digit_type>(static_cast<boost::uint64_t>(v) & digit_mask);
+         carry = v >> digit_bits;
+      }
+      digit_type top = m_digits.back() + carry;
+      while((top >= static_cast<digit_type>(1) << digit_bits) || (top < -(static_cast<digit_type>(1) << digit_bits)))
+      {
+         m_digits.back() = static_cast<digit_type>(static_cast<boost::uint64_t>(top) & digit_mask);
+         top >>= digit_bits;
+         m_digits.push_back(top);
+      }
+      m_digits.back() = top;
+      m_pending = 1;
+   }
+
+   //
+   // m_digits[i] holds the multiple of 2^(32 * (i + m_offset)) in the sum, m_pending bounds the size of
+   // each digit as a multiple of 2^32:
+   //
+   std::vector<digit_type> m_digits;
+   boost::long_long_type m_offset;
+   boost::uint64_t m_pending;
+   bool m_nan, m_positive_infinity, m_negative_infinity;
+};
+
+} // namespace backends
+
+using backends::cpp_bin_float_accumulator;
+
+}} // namespaces
+
+#endif
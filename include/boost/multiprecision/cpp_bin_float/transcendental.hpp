@@ -6,29 +6,144 @@
 #ifndef BOOST_MULTIPRECISION_CPP_BIN_FLOAT_TRANSCENDENTAL_HPP
 #define BOOST_MULTIPRECISION_CPP_BIN_FLOAT_TRANSCENDENTAL_HPP
 
+//
+// The fixed point log series for cpp_bin_float is faster than the AGM up to a much higher precision
+// than the generic series, this is the number of bits above which the AGM is used instead:
+//
+#ifndef BOOST_MP_CPP_BIN_FLOAT_LOG_AGM_CUTOFF
+#define BOOST_MP_CPP_BIN_FLOAT_LOG_AGM_CUTOFF 60000
+#endif
+
 namespace boost{ namespace multiprecision{ namespace backends{
 
+namespace detail{
+
+//
+// The native log, atan and sin/cos kernels below work in fixed point, on integers holding value * 2^fraction_bits,
+// which carry guard_bits more bits than the mantissa of the result so that it is rounded just once at the end:
+//
+template <class Float>
+struct bin_float_fixed_point;
+
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
-void eval_exp_taylor(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+struct bin_float_fixed_point<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >
 {
-   static const int bits = cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count;
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   static const unsigned guard_bits = 128;
+   static const unsigned fraction_bits = float_type::bit_count + guard_bits;
    //
-   // Taylor series for small argument, note returns exp(x) - 1:
+   // Big enough for the product of two fixed point values below 2^guard_bits:
+   //
+   typedef cpp_int_backend<is_void<Allocator>::value ? 2 * fraction_bits + guard_bits : 0, 2 * fraction_bits + guard_bits, signed_magnitude, unchecked, Allocator> int_type;
    //
-   res = limb_type(0);
-   cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> num(arg), denom, t;
-   denom = limb_type(1);
-   eval_add(res, num);
+   // A float type with as many bits as the fixed point fraction, used to obtain constants to full precision:
+   //
+   typedef cpp_bin_float<fraction_bits, digit_base_2, Allocator, Exponent, MinE, MaxE> guarded_type;
 
-   for(unsigned k = 2; ; ++k)
+   //
+   // Sets result = f * 2^fraction_bits, truncating any bits below the fixed point fraction:
+   //
+   template <class F>
+   static void from_float(int_type& result, const F& f)
    {
-      eval_multiply(denom, k);
-      eval_multiply(num, arg);
-      eval_divide(t, num, denom);
-      eval_add(res, t);
-      if(eval_is_zero(t) || (res.exponent() - bits > t.exponent()))
-         break;
+      using default_ops::eval_left_shift;
+      using default_ops::eval_right_shift;
+      if(eval_fpclassify(f) == FP_ZERO)
+      {
+         result = limb_type(0u);
+         return;
+      }
+      result = f.bits();
+      int shift = static_cast<int>(fraction_bits) + static_cast<int>(f.exponent()) - static_cast<int>(F::bit_count) + 1;
+      if(shift > 0)
+         eval_left_shift(result, shift);
+      else if(shift < 0)
+         eval_right_shift(result, -shift);
+      if(f.sign())
+         result.negate();
+   }
+   //
+   // Sets result to the fixed point value x with the given number of fraction bits, with a single rounding:
+   //
+   static void to_float(float_type& result, int_type& x, unsigned fraction = fraction_bits)
+   {
+      result.sign() = eval_get_sign(x) < 0;
+      if(result.sign())
+         x.negate();
+      result.exponent() = static_cast<Exponent>(float_type::bit_count) - 1 - static_cast<Exponent>(fraction);
+      copy_and_round(result, x);
+   }
+   static void one(int_type& result)
+   {
+      result = limb_type(1u);
+      eval_left_shift(result, fraction_bits);
+   }
+   static void multiply(int_type& result, const int_type& a, const int_type& b)
+   {
+      eval_multiply(result, a, b);
+      eval_right_shift(result, fraction_bits);
+   }
+   //
+   // multiply as a functor, for use by the generic series code:
+   //
+   struct multiplier
+   {
+      void operator()(int_type& result, const int_type& a, const int_type& b)const
+      {
+         multiply(result, a, b);
+      }
+   };
+   //
+   // Sets S = sin(a) and C = cos(a) for 0 <= a <= 1 held in A, by halving a k times and then proceeding as the
+   // generic sin_cos_kernel.  The fixed point terms lose relative precision as a shrinks, k must be no more than
+   // half of guard_bits:
+   //
+   static void sin_cos(int_type& S, int_type& C, int_type& A, unsigned k)
+   {
+      using default_ops::eval_right_shift;
+      using default_ops::eval_left_shift;
+      BOOST_ASSERT(k <= guard_bits / 2);
+      int_type Y, t, v, unit;
+      eval_right_shift(A, k);
+      multiply(Y, A, A);
+      double log2_y = -static_cast<double>(fraction_bits);
+      if(!eval_is_zero(Y))
+         log2_y += eval_msb(Y) + 1;
+      Y.negate();
+      const unsigned n_sin = default_ops::series_term_count(default_ops::sin_series(), log2_y, fraction_bits);
+      const unsigned n_cos = default_ops::series_term_count(default_ops::cos_series(), log2_y, fraction_bits);
+      std::vector<int_type> powers;
+      one(unit);
+      default_ops::series_powers(powers, unit, Y, default_ops::series_block_size(n_sin > n_cos ? n_sin : n_cos), multiplier());
+      default_ops::eval_series_rectangular(t, powers, n_sin, default_ops::sin_series(), multiplier());
+      multiply(S, t, A);
+      default_ops::eval_series_rectangular(t, powers, n_cos, default_ops::cos_series(), multiplier());
+      multiply(v, t, Y);
+      v.negate();
+      eval_right_shift(v, 1u);
+      for(unsigned i = 0; i < k; ++i)
+      {
+         multiply(t, S, S);
+         eval_subtract(C, unit, v);
+         multiply(Y, S, C);
+         eval_left_shift(S, Y, 1u);
+         eval_left_shift(v, t, 1u);
+      }
+      eval_subtract(C, unit, v);
    }
+};
+
+}
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void eval_exp_taylor(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   //
+   // Taylor series for small argument, note returns exp(x) - 1:
+   //
+   cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> t;
+   default_ops::eval_series(t, arg, default_ops::expm1_series());
+   eval_multiply(res, t, arg);
 }
 
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
@@ -131,6 +246,268 @@ void eval_exp(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>
    eval_ldexp(res, res, nn);
 }
 
+
+//
+// Native kernel for the generic sin and cos, which have already reduced the argument to |x| <= pi/4.
+// Very small arguments lose too much relative precision in fixed point and are left to the generic code:
+//
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void sin_cos_kernel(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &s, cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &c, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &x)
+{
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   typedef detail::bin_float_fixed_point<float_type> fixed_point;
+   typedef typename fixed_point::int_type int_type;
+
+   if((eval_fpclassify(x) != FP_NORMAL) || (x.exponent() < -32))
+   {
+      default_ops::sin_cos_kernel(s, c, x);
+      return;
+   }
+   //
+   // Halve until the argument is about 2^-depth, as the generic kernel does:
+   //
+   int k = static_cast<int>(default_ops::sin_cos_halving_depth(float_type::bit_count)) + static_cast<int>(x.exponent()) + 1;
+   if(k < 0)
+      k = 0;
+   else if(k > static_cast<int>(fixed_point::guard_bits / 2))
+      k = fixed_point::guard_bits / 2;
+
+   int_type A, S, C;
+   fixed_point::from_float(A, x);
+   if(x.sign())
+      A.negate();
+   fixed_point::sin_cos(S, C, A, k);
+   if(x.sign())
+      S.negate();
+   fixed_point::to_float(s, S);
+   fixed_point::to_float(c, C);
+}
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void eval_log(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   //
+   // With arg = t * 2^e and 1/sqrt(2) <= t < sqrt(2), let u = (t - 1) / (t + 1), then:
+   //
+   // log(arg) = e log(2) + 2u SUM[n>=0] u^2n / (2n+1)
+   //
+   // where u^2 <= 0.0295, and the series is summed in fixed point.  u is held scaled up by 2^z so that
+   // arguments close to 1 keep their relative precision:
+   //
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   typedef detail::bin_float_fixed_point<float_type> fixed_point;
+   typedef typename fixed_point::int_type int_type;
+   using default_ops::eval_left_shift;
+   using default_ops::eval_right_shift;
+   using default_ops::eval_subtract;
+   using default_ops::eval_divide;
+
+   switch(eval_fpclassify(arg))
+   {
+   case FP_NAN:
+      res = arg;
+      return;
+   case FP_ZERO:
+      res = std::numeric_limits<number<float_type> >::infinity().backend();
+      res.negate();
+      return;
+   case FP_INFINITE:
+      if(arg.sign())
+         res = std::numeric_limits<number<float_type> >::quiet_NaN().backend();
+      else
+         res = arg;
+      return;
+   default: ;
+   }
+   if(arg.sign())
+   {
+      res = std::numeric_limits<number<float_type> >::quiet_NaN().backend();
+      return;
+   }
+
+   typedef typename mpl::front<typename float_type::float_types>::type fp_type;
+   float_type t(arg), d, lim;
+   Exponent e = arg.exponent();
+   t.exponent() = 0;
+   lim = static_cast<fp_type>(1.41421356f);
+   if(t.compare(lim) >= 0)
+   {
+      t.exponent() = -1;
+      ++e;
+   }
+   eval_subtract(d, t, limb_type(1u));
+
+   if((float_type::bit_count >= BOOST_MP_CPP_BIN_FLOAT_LOG_AGM_CUTOFF) && ((e != 0) || (eval_get_sign(d) && (d.exponent() >= -16))))
+   {
+      //
+      // Away from 1 the AGM is cheaper than the series at this precision:
+      //
+      eval_log_agm(res, arg);
+      return;
+   }
+
+   const unsigned F = fixed_point::fraction_bits;
+   int_type L;
+   unsigned z = 0;
+   if(eval_get_sign(d))
+   {
+      //
+      // u * 2^(F+z) = d * 2^(2F+z) / ((2 + d) * 2^F), where |d| * 2^z lies in [0.5, 1):
+      //
+      z = static_cast<unsigned>(-1 - d.exponent());
+      int_type U, num, den, W, sum, term, q;
+      num = d.bits();
+      eval_left_shift(num, 2 * F - float_type::bit_count);
+      if(d.sign())
+         num.negate();
+      fixed_point::from_float(den, d);
+      fixed_point::one(term);
+      eval_left_shift(term, 1u);
+      eval_add(den, term);
+      eval_divide(U, num, den);
+
+      eval_multiply(W, U, U);
+      eval_right_shift(W, F + 2 * z);
+      fixed_point::one(sum);
+      fixed_point::one(term);
+      for(limb_type n = 1; ; ++n)
+      {
+         fixed_point::multiply(q, term, W);
+         term.swap(q);
+         eval_divide(q, term, 2 * n + 1);
+         if(eval_is_zero(q))
+            break;
+         eval_add(sum, q);
+      }
+      eval_multiply(L, U, sum);
+      eval_right_shift(L, F - 1);
+   }
+   else
+      L = limb_type(0u);
+
+   if(e != 0)
+   {
+      int_type ln2;
+      fixed_point::from_float(ln2, default_ops::get_constant_ln2<typename fixed_point::guarded_type>());
+      eval_right_shift(L, z);
+      eval_multiply(ln2, static_cast<limb_type>(e < 0 ? -e : e));
+      if(e < 0)
+         ln2.negate();
+      eval_add(L, ln2);
+      z = 0;
+   }
+   fixed_point::to_float(res, L, F + z);
+}
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void eval_atan(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   //
+   // For |arg| > 1 we use atan(arg) = pi/2 - atan(1/arg), leaving 0 < r <= 1.  Then with a double precision
+   // approximation y0 to atan(r):
+   //
+   // atan(r) = y0 + atan((r - tan(y0)) / (1 + r tan(y0)))
+   //
+   // where the second argument is about 2^-53, and the series for it gains over 100 bits per term.
+   // Everything is in fixed point, and very small arguments are left to the generic code:
+   //
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   typedef detail::bin_float_fixed_point<float_type> fixed_point;
+   typedef typename fixed_point::int_type int_type;
+   using default_ops::eval_left_shift;
+   using default_ops::eval_right_shift;
+   using default_ops::eval_convert_to;
+   using default_ops::eval_divide;
+
+   if((eval_fpclassify(arg) != FP_NORMAL) || (arg.exponent() < -32))
+   {
+      default_ops::eval_atan(res, arg);
+      return;
+   }
+   const unsigned F = fixed_point::fraction_bits;
+   const bool inverted = arg.exponent() >= 0;
+   float_type x(arg);
+   if(x.sign())
+      x.negate();
+
+   int_type R, S, C, Y, Z, t, q;
+   double r = 0;
+   if(inverted)
+   {
+      if(x.exponent() < static_cast<Exponent>(F))
+      {
+         fixed_point::from_float(t, x);
+         fixed_point::one(q);
+         eval_left_shift(q, F);
+         eval_divide(R, q, t);
+         eval_convert_to(&r, x);
+         r = 1 / r;
+      }
+      else
+         R = limb_type(0u);
+   }
+   else
+   {
+      fixed_point::from_float(R, x);
+      eval_convert_to(&r, x);
+   }
+
+   double y0 = std::atan(r);
+   if(y0 > 1e-9)
+   {
+      int ey;
+      double m = std::frexp(y0, &ey);
+      Y = static_cast<boost::ulong_long_type>(std::ldexp(m, 53));
+      eval_left_shift(Y, static_cast<int>(F) + ey - 53);
+      t = Y;
+      unsigned k = default_ops::sin_cos_halving_depth(float_type::bit_count);
+      if(k > fixed_point::guard_bits / 2)
+         k = fixed_point::guard_bits / 2;
+      fixed_point::sin_cos(S, C, t, k);
+      //
+      // Z = (r cos(y0) - sin(y0)) / (cos(y0) + r sin(y0)):
+      //
+      fixed_point::multiply(t, R, C);
+      eval_subtract(t, S);
+      fixed_point::multiply(q, R, S);
+      eval_add(q, C);
+      eval_left_shift(t, F);
+      eval_divide(Z, t, q);
+   }
+   else
+   {
+      Y = limb_type(0u);
+      Z = R;
+   }
+
+   int_type Z2, term;
+   fixed_point::multiply(Z2, Z, Z);
+   term = Z;
+   for(limb_type n = 1; ; ++n)
+   {
+      fixed_point::multiply(t, term, Z2);
+      term.swap(t);
+      eval_divide(q, term, 2 * n + 1);
+      if(eval_is_zero(q))
+         break;
+      if(n & 1)
+         eval_subtract(Z, q);
+      else
+         eval_add(Z, q);
+   }
+   eval_add(Y, Z);
+
+   if(inverted)
+   {
+      fixed_point::from_float(t, default_ops::get_constant_pi<typename fixed_point::guarded_type>());
+      eval_right_shift(t, 1u);
+      eval_subtract(Y, t, Y);
+   }
+   if(arg.sign())
+      Y.negate();
+   fixed_point::to_float(res, Y);
+}
+
 }}} // namespaces
 
 #endif
@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <vector>
 #include <boost/cstdint.hpp>
 #include <boost/multiprecision/number.hpp>
 #include <boost/multiprecision/detail/integer_ops.hpp>
@@ -21,6 +22,7 @@
 #include <boost/type_traits/common_type.hpp>
 #include <boost/type_traits/make_signed.hpp>
 #include <boost/multiprecision/cpp_int/checked.hpp>
+#include <boost/multiprecision/detail/scratch_pool.hpp>
 #ifdef BOOST_MP_USER_DEFINED_LITERALS
 #include <boost/multiprecision/cpp_int/value_pack.hpp>
 #endif
@@ -132,6 +134,30 @@ struct is_fixed_precision<cpp_int_backend<MinBits, MaxBits, SignType, Checked, A
 
 namespace detail{
 
+//
+// The type of the temporaries used inside the arithmetic routines: arbitrary precision types take their
+// storage from the thread's scratch pool rather than from the allocator of the values involved, fixed
+// precision types never allocate and are used as is:
+//
+template <class CppInt>
+struct scratch_type
+{
+   typedef CppInt type;
+};
+template <unsigned MinBits, unsigned MaxBits, cpp_integer_type SignType, cpp_int_check_type Checked, class Allocator>
+struct scratch_type<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator> >
+{
+   typedef typename mpl::if_<
+      is_void<Allocator>,
+      cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>,
+      cpp_int_backend<MinBits, MaxBits, SignType, Checked, boost::multiprecision::detail::scratch_allocator<limb_type> >
+   >::type type;
+};
+//
+// And for raw limb workspace:
+//
+typedef std::vector<limb_type, boost::multiprecision::detail::scratch_allocator<limb_type> > scratch_vector;
+
 inline void verify_new_size(unsigned new_size, unsigned min_size, const mpl::int_<checked>&)
 {
    if(new_size < min_size)
@@ -326,7 +352,10 @@ public:
    {
       if(this != &o)
       {
-         static_cast<allocator_type&>(*this) = static_cast<const allocator_type&>(o);
+         //
+         // We keep our own allocator, since our current buffer (if any) must be returned to the allocator
+         // it came from, and a stateful allocator may refer to a different arena from o's:
+         //
          m_limbs = 0;
          resize(o.size(), o.size());
          std::memcpy(limbs(), o.limbs(), o.size() * sizeof(limbs()[0]));
@@ -349,6 +378,8 @@ public:
    }
    BOOST_MP_FORCEINLINE void do_swap(cpp_int_base& o) BOOST_NOEXCEPT
    {
+      // The allocators go with the buffers they allocated:
+      std::swap(allocator(), o.allocator());
       std::swap(m_data, o.m_data);
       std::swap(m_sign, o.m_sign);
       std::swap(m_internal, o.m_internal);
@@ -998,6 +1029,17 @@ struct is_allowed_cpp_int_base_conversion : public mpl::if_c<
       mpl::false_
    >::type
 {};
+//
+// Decimal string conversion of arbitrary precision values uses a divide and conquer algorithm - splitting
+// the value (or string) by powers of 10^(digits_per_block_10 * 2^k) - once the value has at least this
+// many limbs:
+//
+#ifndef BOOST_MP_CPP_INT_STRING_CUTOFF
+#define BOOST_MP_CPP_INT_STRING_CUTOFF 60
+#endif
+
+static const unsigned cpp_int_string_cutoff = BOOST_MP_CPP_INT_STRING_CUTOFF;
+
 //
 // Now the actual backend, normalising parameters passed to the base class:
 //
@@ -1395,35 +1437,92 @@ private:
          }
          else
          {
-            // Base 10, we extract blocks of size 10^9 at a time, that way
-            // the number of multiplications is kept to a minimum:
-            limb_type block_mult = max_block_10;
-            while(*s)
-            {
-               limb_type block = 0;
-               for(unsigned i = 0; i < digits_per_block_10; ++i)
-               {
-                  limb_type val;
-                  if(*s >= '0' && *s <= '9')
-                     val = *s - '0';
-                  else
-                     BOOST_THROW_EXCEPTION(std::runtime_error("Unexpected character encountered in input."));
-                  block *= 10;
-                  block += val;
-                  if(!*++s)
-                  {
-                     block_mult = block_multiplier(i);
-                     break;
-                  }
-               }
-               eval_multiply(*this, block_mult);
-               eval_add(*this, block);
-            }
+            do_assign_decimal_string(s, s + n, mpl::bool_<!is_fixed_precision<self_type>::value>());
          }
       }
       if(isneg)
          this->negate();
    }
+   void do_assign_decimal_string(const char* s, const char* e)
+   {
+      using default_ops::eval_multiply;
+      using default_ops::eval_add;
+      // Base 10, we extract blocks of size 10^9 at a time, that way
+      // the number of multiplications is kept to a minimum:
+      *this = static_cast<limb_type>(0u);
+      limb_type block_mult = max_block_10;
+      while(s != e)
+      {
+         limb_type block = 0;
+         for(unsigned i = 0; i < digits_per_block_10; ++i)
+         {
+            limb_type val;
+            if(*s >= '0' && *s <= '9')
+               val = *s - '0';
+            else
+               BOOST_THROW_EXCEPTION(std::runtime_error("Unexpected character encountered in input."));
+            block *= 10;
+            block += val;
+            if(++s == e)
+            {
+               block_mult = block_multiplier(i);
+               break;
+            }
+         }
+         eval_multiply(*this, block_mult);
+         eval_add(*this, block);
+      }
+   }
+   void do_assign_decimal_string(const char* s, const char* e, const mpl::false_&)
+   {
+      do_assign_decimal_string(s, e);
+   }
+   void do_assign_decimal_string(const char* s, const char* e, const mpl::true_&)
+   {
+      using default_ops::eval_multiply;
+      std::size_t n = e - s;
+      if(n < static_cast<std::size_t>(cpp_int_string_cutoff) * digits_per_block_10)
+      {
+         do_assign_decimal_string(s, e);
+         return;
+      }
+      //
+      // powers[k] holds 10^(digits_per_block_10 * 2^k), we need all those with fewer than n digits:
+      //
+      std::vector<cpp_int_backend> powers(1);
+      powers[0] = max_block_10;
+      while((static_cast<std::size_t>(digits_per_block_10) << powers.size()) < n)
+      {
+         cpp_int_backend t;
+         eval_multiply(t, powers.back(), powers.back());
+         powers.push_back(t);
+      }
+      do_assign_decimal_string(s, e, powers);
+   }
+   void do_assign_decimal_string(const char* s, const char* e, const std::vector<cpp_int_backend>& powers)
+   {
+      //
+      // Split off the largest block of the form digits_per_block_10 * 2^k digits from the end of
+      // the string, and combine the two halves as high * 10^(digits_per_block_10 * 2^k) + low:
+      //
+      using default_ops::eval_multiply;
+      using default_ops::eval_add;
+      std::size_t n = e - s;
+      if(n < static_cast<std::size_t>(cpp_int_string_cutoff) * digits_per_block_10)
+      {
+         do_assign_decimal_string(s, e);
+         return;
+      }
+      unsigned k = static_cast<unsigned>(powers.size() - 1);
+      while((static_cast<std::size_t>(digits_per_block_10) << k) >= n)
+         --k;
+      std::size_t low_digits = static_cast<std::size_t>(digits_per_block_10) << k;
+      cpp_int_backend low;
+      do_assign_decimal_string(s, e - low_digits, powers);
+      low.do_assign_decimal_string(e - low_digits, e, powers);
+      eval_multiply(*this, powers[k]);
+      eval_add(*this, low);
+   }
 public:
    cpp_int_backend& operator = (const char* s)
    {
@@ -1589,9 +1688,7 @@ private:
       else
       {
          result.assign(Bits / 3 + 1, '0');
-         std::string::difference_type pos = result.size() - 1;
          cpp_int_backend t(*this);
-         cpp_int_backend r;
          bool neg = false;
          if(t.sign())
          {
@@ -1604,23 +1701,7 @@ private:
          }
          else
          {
-            cpp_int_backend block10;
-            block10 = max_block_10;
-            while(eval_get_sign(t) != 0)
-            {
-               cpp_int_backend t2;
-               divide_unsigned_helper(&t2, t, block10, r);
-               t = t2;
-               limb_type v = r.limbs()[0];
-               for(unsigned i = 0; i < digits_per_block_10; ++i)
-               {
-                  char c = '0' + v % 10;
-                  v /= 10;
-                  result[pos] = c;
-                  if(pos-- == 0)
-                     break;
-               }
-            }
+            do_get_decimal_string(t, &result[0], &result[0] + result.size(), mpl::bool_<!is_fixed_precision<self_type>::value>());
          }
          std::string::size_type n = result.find_first_not_of('0');
          result.erase(0, n);
@@ -1633,6 +1714,78 @@ private:
       }
       return result;
    }
+   //
+   // Writes the decimal digits of non-negative value t into [first, last), right aligned,
+   // the buffer must be large enough and already filled with '0':
+   //
+   static void do_get_decimal_string(cpp_int_backend t, char* first, char* last)
+   {
+      using default_ops::eval_get_sign;
+      cpp_int_backend block10, r;
+      block10 = max_block_10;
+      while(eval_get_sign(t) != 0)
+      {
+         cpp_int_backend t2;
+         divide_unsigned_helper(&t2, t, block10, r);
+         t = t2;
+         limb_type v = r.limbs()[0];
+         for(unsigned i = 0; i < digits_per_block_10; ++i)
+         {
+            char c = '0' + v % 10;
+            v /= 10;
+            *--last = c;
+            if(last == first)
+               return;
+         }
+      }
+   }
+   static void do_get_decimal_string(const cpp_int_backend& t, char* first, char* last, const mpl::false_&)
+   {
+      do_get_decimal_string(t, first, last);
+   }
+   static void do_get_decimal_string(const cpp_int_backend& t, char* first, char* last, const mpl::true_&)
+   {
+      using default_ops::eval_multiply;
+      if(t.size() < cpp_int_string_cutoff)
+      {
+         do_get_decimal_string(t, first, last);
+         return;
+      }
+      //
+      // powers[k] holds 10^(digits_per_block_10 * 2^k), we need those up to about the square root of t:
+      //
+      std::vector<cpp_int_backend> powers(1);
+      powers[0] = max_block_10;
+      while(2 * powers.back().size() <= t.size())
+      {
+         cpp_int_backend p;
+         eval_multiply(p, powers.back(), powers.back());
+         powers.push_back(p);
+      }
+      do_get_decimal_string(t, first, last, powers);
+   }
+   static void do_get_decimal_string(const cpp_int_backend& t, char* first, char* last, const std::vector<cpp_int_backend>& powers)
+   {
+      //
+      // Divide by the largest cached power of ten which is no larger than (roughly) the
+      // square root of t, and then convert the quotient and remainder separately:
+      //
+      unsigned k = static_cast<unsigned>(powers.size());
+      while(k && (2 * powers[k - 1].size() > t.size() + 1))
+         --k;
+      if(!k || (t.size() < cpp_int_string_cutoff))
+      {
+         do_get_decimal_string(t, first, last);
+         return;
+      }
+      --k;
+      cpp_int_backend q, r;
+      divide_unsigned_helper(&q, t, powers[k], r);
+      std::size_t low_digits = static_cast<std::size_t>(digits_per_block_10) << k;
+      BOOST_ASSERT(static_cast<std::size_t>(last - first) >= low_digits);
+      do_get_decimal_string(r, last - low_digits, last, powers);
+      do_get_decimal_string(q, first, last - low_digits, powers);
+   }
 public:
    std::string str(std::streamsize /*digits*/, std::ios_base::fmtflags f)const
    {
@@ -1801,11 +1954,15 @@ struct is_explicitly_convertible<cpp_int_backend<MinBits, MaxBits, SignType, Che
 // Last of all we include the implementations of all the eval_* non member functions:
 //
 #include <boost/multiprecision/cpp_int/comparison.hpp>
+#include <boost/multiprecision/cpp_int/fixed_kernels.hpp>
 #include <boost/multiprecision/cpp_int/add.hpp>
 #include <boost/multiprecision/cpp_int/multiply.hpp>
 #include <boost/multiprecision/cpp_int/divide.hpp>
 #include <boost/multiprecision/cpp_int/bitwise.hpp>
 #include <boost/multiprecision/cpp_int/misc.hpp>
+#include <boost/multiprecision/cpp_int/gcd.hpp>
+#include <boost/multiprecision/cpp_int/montgomery.hpp>
+#include <boost/multiprecision/cpp_int/barrett.hpp>
 #include <boost/multiprecision/cpp_int/limits.hpp>
 #ifdef BOOST_MP_USER_DEFINED_LITERALS
 #include <boost/multiprecision/cpp_int/literals.hpp>
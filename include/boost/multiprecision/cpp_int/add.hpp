@@ -10,6 +10,57 @@
 
 namespace boost{ namespace multiprecision{ namespace backends{
 
+//
+// Large values of small unchecked fixed precision types are added and subtracted by the unrolled kernels in
+// fixed_kernels.hpp.  These return false when the kernels don't apply, and the caller must use the general code:
+//
+template <class CppInt1, class CppInt2, class CppInt3>
+BOOST_MP_FORCEINLINE bool add_unsigned_fixed(CppInt1&, const CppInt2&, const CppInt3&, const mpl::false_&) BOOST_NOEXCEPT
+{
+   return false;
+}
+template <class CppInt>
+BOOST_MP_FORCEINLINE bool add_unsigned_fixed(CppInt& result, const CppInt& a, const CppInt& b, const mpl::true_&) BOOST_NOEXCEPT
+{
+   unsigned as = a.size();
+   unsigned bs = b.size();
+   if(2 * (std::max)(as, bs) < CppInt::internal_limb_count)
+      return false;
+   bool s = a.sign();
+   result.resize(CppInt::internal_limb_count, CppInt::internal_limb_count);
+   fixed_kernel<0, CppInt::internal_limb_count>::add(result.limbs(), a.limbs(), as, b.limbs(), bs, 0);
+   result.normalize();
+   result.sign(s);
+   return true;
+}
+template <class CppInt1, class CppInt2, class CppInt3>
+BOOST_MP_FORCEINLINE bool subtract_unsigned_fixed(CppInt1&, const CppInt2&, const CppInt3&, const mpl::false_&) BOOST_NOEXCEPT
+{
+   return false;
+}
+template <class CppInt>
+BOOST_MP_FORCEINLINE bool subtract_unsigned_fixed(CppInt& result, const CppInt& a, const CppInt& b, const mpl::true_&) BOOST_NOEXCEPT
+{
+   unsigned as = a.size();
+   unsigned bs = b.size();
+   if(2 * (std::max)(as, bs) < CppInt::internal_limb_count)
+      return false;
+   bool s = a.sign();
+   result.resize(CppInt::internal_limb_count, CppInt::internal_limb_count);
+   //
+   // For unsigned types the result is correct modulo 2^MinBits as it stands.  For signed types
+   // a borrow out means that b was the larger, and we need the negated difference instead:
+   //
+   if(fixed_kernel<0, CppInt::internal_limb_count>::subtract(result.limbs(), a.limbs(), as, b.limbs(), bs, 0) && is_signed_number<CppInt>::value)
+   {
+      fixed_kernel<0, CppInt::internal_limb_count>::negate(result.limbs(), 0);
+      s = !s;
+   }
+   result.normalize();
+   result.sign(s);
+   return true;
+}
+
 //
 // This is the key addition routine where all the argument types are non-trivial cpp_int's:
 //
@@ -18,6 +69,9 @@ inline void add_unsigned(CppInt1& result, const CppInt2& a, const CppInt3& b) BO
 {
    using std::swap;
 
+   if(add_unsigned_fixed(result, a, b, is_fixed_kernel_cpp_int<CppInt1, CppInt2, CppInt3>()))
+      return;
+
    // Nothing fancy, just let uintmax_t take the strain:
    double_limb_type carry = 0;
    unsigned m, x;
@@ -123,6 +177,9 @@ inline void subtract_unsigned(CppInt1& result, const CppInt2& a, const CppInt3&
 {
    using std::swap;
 
+   if(subtract_unsigned_fixed(result, a, b, is_fixed_kernel_cpp_int<CppInt1, CppInt2, CppInt3>()))
+      return;
+
    // Nothing fancy, just let uintmax_t take the strain:
    double_limb_type borrow = 0;
    unsigned m, x;
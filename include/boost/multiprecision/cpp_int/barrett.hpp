@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Barrett modular reduction for cpp_int_backend:
+//
+#ifndef BOOST_MP_CPP_INT_BARRETT_HPP
+#define BOOST_MP_CPP_INT_BARRETT_HPP
+
+#include <vector>
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+//
+// Number of limbs of workspace required by barrett_reduce:
+//
+inline unsigned barrett_storage_size(unsigned n) BOOST_NOEXCEPT
+{
+   return 3 * (n + 1) + karatsuba_storage_size(n + 1);
+}
+//
+// Barrett reduction: pr[0, n) = px[0, 2n) mod pm where pm[0, n + 1) is the modulus (padded with a zero limb)
+// and pmu[0, n + 1) = floor((B^2n - 1) / m).  The quotient estimate q = floor(floor(x / B^(n-1)) * mu / B^(n+1))
+// is never too large and at most 3 too small, so we need only subtract m up to 3 times at the end.
+// px is used as workspace and is destroyed:
+//
+inline void barrett_reduce(limb_type* pr, limb_type* px, const limb_type* pm, const limb_type* pmu, unsigned n, limb_type* storage) BOOST_NOEXCEPT
+{
+   limb_type* pq = storage + 2 * (n + 1);
+   limb_type* pkstorage = pq + n + 1;
+   multiply_karatsuba(storage, px + n - 1, pmu, n + 1, pkstorage);
+   std::memcpy(pq, storage + n + 1, (n + 1) * sizeof(limb_type));
+   multiply_karatsuba(storage, pq, pm, n + 1, pkstorage);
+   //
+   // The remainder is less than 4m < B^(n+1), so we need only the low n + 1 limbs of x - q * m:
+   //
+   subtract_limbs_inplace(px, n + 1, storage, n + 1);
+   while(compare_limbs(px, pm, n + 1) >= 0)
+      subtract_limbs_inplace(px, n + 1, pm, n + 1);
+   std::memcpy(pr, px, n * sizeof(limb_type));
+}
+
+//
+// A Barrett context holds a modulus m greater than one, along with mu = floor((B^2n - 1) / m) where n is the
+// number of limbs in m.  Residues are stored as ordinary values in [0, m), and are reduced after multiplication
+// with two multiplications rather than a division.  Unlike montgomery_context, the modulus may be even.
+//
+// As with montgomery_context all the member functions are const and use their own workspace, so a context
+// may be shared between threads.
+//
+template <class CppInt>
+class barrett_context
+{
+public:
+   typedef CppInt backend_type;
+
+   barrett_context() : m_size(0) {}
+   explicit barrett_context(const CppInt& m)
+   {
+      assign(m);
+   }
+   template <expression_template_option ExpressionTemplates>
+   explicit barrett_context(const number<CppInt, ExpressionTemplates>& m)
+   {
+      assign(m.backend());
+   }
+
+   void assign(const CppInt& m)
+   {
+      using default_ops::eval_get_sign;
+      using default_ops::eval_left_shift;
+      using default_ops::eval_subtract;
+      using default_ops::eval_divide;
+
+      if((eval_get_sign(m) <= 0) || ((m.size() == 1) && (*m.limbs() == 1)))
+         BOOST_THROW_EXCEPTION(std::domain_error("The modulus of a Barrett context must be greater than one."));
+      m_modulus = m;
+      m_size = m.size();
+      m_limbs.assign(2 * (m_size + 1), 0);
+      std::memcpy(&m_limbs[0], m.limbs(), m_size * sizeof(limb_type));
+      //
+      // mu is calculated once, using arbitrary precision temporaries so that this works
+      // for fixed precision types too:
+      //
+      cpp_int_backend<> big_m, t, mu;
+      assign_limbs(big_m, m.limbs(), m_size, 0, m_size);
+      t = static_cast<limb_type>(1u);
+      eval_left_shift(t, 2 * static_cast<double_limb_type>(m_size) * bits_per_limb);
+      eval_subtract(t, static_cast<limb_type>(1u));
+      eval_divide(mu, t, big_m);
+      BOOST_ASSERT(mu.size() <= m_size + 1);
+      std::memcpy(&m_limbs[m_size + 1], mu.limbs(), mu.size() * sizeof(limb_type));
+   }
+
+   const CppInt& modulus()const BOOST_NOEXCEPT { return m_modulus; }
+   unsigned size()const BOOST_NOEXCEPT { return m_size; }
+   //
+   // result = a % m for non-negative a:
+   //
+   void reduce(CppInt& result, const CppInt& a)const
+   {
+      using default_ops::eval_modulus;
+      if(a.size() > 2 * m_size)
+      {
+         eval_modulus(result, a, m_modulus);
+         return;
+      }
+      detail::scratch_vector storage(2 * m_size + barrett_storage_size(m_size));
+      std::memcpy(&storage[0], a.limbs(), a.size() * sizeof(limb_type));
+      barrett_reduce(&storage[0], &storage[0], mod(), mu(), m_size, &storage[2 * m_size]);
+      assign_limbs(result, &storage[0], m_size, 0, m_size);
+   }
+   //
+   // The interface shared with montgomery_context, used by cpp_mod_int_backend:
+   //
+   void encode(CppInt& result, const CppInt& a)const
+   {
+      reduce(result, a);
+   }
+   void decode(CppInt& result, const CppInt& a)const
+   {
+      result = a;
+   }
+   //
+   // result = (a * b) % m where both arguments are already reduced:
+   //
+   void multiply(CppInt& result, const CppInt& a, const CppInt& b)const
+   {
+      BOOST_ASSERT((a.size() <= m_size) && (b.size() <= m_size));
+      detail::scratch_vector storage(4 * m_size + barrett_storage_size(m_size));
+      limb_type* pa = &storage[2 * m_size];
+      limb_type* pb = pa + m_size;
+      std::memcpy(pa, a.limbs(), a.size() * sizeof(limb_type));
+      std::memcpy(pb, b.limbs(), b.size() * sizeof(limb_type));
+      if((&a == &b) && (m_size >= square_cutoff))
+      {
+         if(m_size < karatsuba_cutoff)
+            square_schoolbook(&storage[0], pa, m_size);
+         else
+            square_karatsuba(&storage[0], pa, m_size, &storage[4 * m_size]);
+      }
+      else if(m_size < karatsuba_cutoff)
+         multiply_schoolbook(&storage[0], pa, m_size, pb, m_size);
+      else
+         multiply_karatsuba(&storage[0], pa, pb, m_size, &storage[4 * m_size]);
+      barrett_reduce(&storage[0], &storage[0], mod(), mu(), m_size, &storage[2 * m_size]);
+      assign_limbs(result, &storage[0], m_size, 0, m_size);
+   }
+
+private:
+   const limb_type* mod()const BOOST_NOEXCEPT { return &m_limbs[0]; }
+   const limb_type* mu()const BOOST_NOEXCEPT { return &m_limbs[m_size + 1]; }
+
+   CppInt m_modulus;
+   unsigned m_size;
+   std::vector<limb_type> m_limbs;  // m and mu, each m_size + 1 limbs.
+};
+
+} // namespace backends
+
+using boost::multiprecision::backends::barrett_context;
+
+}} // namespaces
+
+#endif
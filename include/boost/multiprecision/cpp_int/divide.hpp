@@ -8,25 +8,27 @@
 #ifndef BOOST_MP_CPP_INT_DIV_HPP
 #define BOOST_MP_CPP_INT_DIV_HPP
 
+#include <boost/multiprecision/detail/bitscan.hpp> // msb
+
 namespace boost{ namespace multiprecision{ namespace backends{
 
-template <class CppInt1, class CppInt2, class CppInt3>
-void divide_unsigned_helper(
+template <class CppInt1, class CppInt2, class CppInt3, class CppInt4>
+void divide_unsigned_schoolbook(
    CppInt1* result, 
    const CppInt2& x, 
    const CppInt3& y, 
-   CppInt1& r)
+   CppInt4& r)
 {
    if(((void*)result == (void*)&x) || ((void*)&r == (void*)&x))
    {
-      CppInt2 t(x);
-      divide_unsigned_helper(result, t, y, r);
+      typename detail::scratch_type<CppInt2>::type t(x);
+      divide_unsigned_schoolbook(result, t, y, r);
       return;
    }
    if(((void*)result == (void*)&y) || ((void*)&r == (void*)&y))
    {
-      CppInt3 t(y);
-      divide_unsigned_helper(result, x, t, r);
+      typename detail::scratch_type<CppInt3>::type t(y);
+      divide_unsigned_schoolbook(result, x, t, r);
       return;
    }
 
@@ -51,10 +53,10 @@ void divide_unsigned_helper(
 
    using default_ops::eval_subtract;
 
-   if(result == &r)
+   if((void*)result == (void*)&r)
    {
-      CppInt1 rem;
-      divide_unsigned_helper(result, x, y, rem);
+      typename detail::scratch_type<CppInt1>::type rem;
+      divide_unsigned_schoolbook(result, x, y, rem);
       r = rem;
       return;
    }
@@ -105,7 +107,7 @@ void divide_unsigned_helper(
       }
    }
 
-   CppInt1 t;
+   typename detail::scratch_type<CppInt1>::type t;
    bool r_neg = false;
 
    //
@@ -139,7 +141,7 @@ void divide_unsigned_helper(
    //
    if(result)
       result->resize(1 + r_order - y_order, 1 + r_order - y_order);
-   typename CppInt1::const_limb_pointer prem = r.limbs();
+   const limb_type* prem = r.limbs();
    // This is initialised just to keep the compiler from emitting useless warnings later on:
    typename CppInt1::limb_pointer pr 
       = typename CppInt1::limb_pointer();
@@ -221,7 +223,7 @@ void divide_unsigned_helper(
       double_limb_type carry = 0;
       t.resize(y.size() + shift + 1, y.size() + shift);
       bool truncated_t = !CppInt1::variable && (t.size() != y.size() + shift + 1);
-      typename CppInt1::limb_pointer pt = t.limbs();
+      limb_type* pt = t.limbs();
       for(unsigned i = 0; i < shift; ++i)
          pt[i] = 0;
       for(unsigned i = 0; i < y.size(); ++i)
@@ -248,8 +250,7 @@ void divide_unsigned_helper(
       }
       else
       {
-         r.swap(t);
-         eval_subtract(r, t);
+         eval_subtract(r, t, r);
          prem = r.limbs();
          r_neg = !r_neg;
       }
@@ -294,23 +295,221 @@ void divide_unsigned_helper(
    BOOST_ASSERT(r.compare_unsigned(y) < 0); // remainder must be less than the divisor or our code has failed
 }
 
-template <class CppInt1, class CppInt2>
+//
+// Burnikel-Ziegler recursive division, see "Fast Recursive Division", Christoph Burnikel and
+// Joachim Ziegler, MPI-I-98-1-022, 1998.  The divisor is normalised and padded so that it
+// occupies n = j * 2^k limbs with the most significant bit set, the numerator is then
+// processed in blocks of n limbs, each step being a "2n by n" division.  Those are split
+// recursively into two "3n/2 by n" divisions, which in turn recurse on the top half of
+// the divisor and then correct using a single (Karatsuba or Toom) multiplication.
+//
+// We use this once the divisor has at least BOOST_MP_BURNIKEL_ZIEGLER_CUTOFF limbs and the
+// quotient at least as many again, and only for arbitrary precision types since the
+// intermediate values are shifted and may be temporarily negative:
+//
+#ifndef BOOST_MP_BURNIKEL_ZIEGLER_CUTOFF
+#define BOOST_MP_BURNIKEL_ZIEGLER_CUTOFF 60
+#endif
+
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_BURNIKEL_ZIEGLER_CUTOFF >= 2, "The Burnikel-Ziegler cutoff must be at least 2 limbs.");
+
+static const unsigned burnikel_ziegler_cutoff = BOOST_MP_BURNIKEL_ZIEGLER_CUTOFF;
+
+template <class CppInt>
+void divide_burnikel_ziegler_3n2n(const CppInt& a, const CppInt& b, unsigned n, CppInt& q, CppInt& r);
+
+//
+// Divides a by b where b has exactly n limbs, the most significant bit is set, and a < b * B^n:
+//
+template <class CppInt>
+void divide_burnikel_ziegler_2n1n(const CppInt& a, const CppInt& b, unsigned n, CppInt& q, CppInt& r)
+{
+   if((n & 1) || (n < burnikel_ziegler_cutoff))
+   {
+      divide_unsigned_schoolbook(&q, a, b, r);
+      return;
+   }
+   unsigned h = n / 2;
+   CppInt a_high, a_low, q_high, t;
+   assign_limbs(a_high, a.limbs(), a.size(), h, a.size());
+   assign_limbs(a_low, a.limbs(), a.size(), 0, h);
+   divide_burnikel_ziegler_3n2n(a_high, b, h, q_high, t);
+   eval_left_shift(t, static_cast<double_limb_type>(h) * CppInt::limb_bits);
+   eval_add(t, a_low);
+   divide_burnikel_ziegler_3n2n(t, b, h, q, r);
+   eval_left_shift(q_high, static_cast<double_limb_type>(h) * CppInt::limb_bits);
+   eval_add(q, q_high);
+}
+//
+// Divides a by b where b has exactly 2n limbs, the most significant bit is set, and a < b * B^n:
+//
+template <class CppInt>
+void divide_burnikel_ziegler_3n2n(const CppInt& a, const CppInt& b, unsigned n, CppInt& q, CppInt& r)
+{
+   CppInt a_high, a_top, a_low, b_high, b_low, t;
+   assign_limbs(a_high, a.limbs(), a.size(), n, a.size());
+   assign_limbs(a_top, a.limbs(), a.size(), 2 * n, a.size());
+   assign_limbs(a_low, a.limbs(), a.size(), 0, n);
+   assign_limbs(b_high, b.limbs(), b.size(), n, n);
+   assign_limbs(b_low, b.limbs(), b.size(), 0, n);
+   if(a_top.compare(b_high) < 0)
+   {
+      divide_burnikel_ziegler_2n1n(a_high, b_high, n, q, r);
+   }
+   else
+   {
+      //
+      // The quotient is B^n - 1, and the remainder a_high - q * b_high which we
+      // compute as a_high + b_high - b_high * B^n, which is never negative:
+      //
+      q.resize(n, n);
+      std::fill(q.limbs(), q.limbs() + n, CppInt::max_limb_value);
+      q.sign(false);
+      eval_add(r, a_high, b_high);
+      t = b_high;
+      eval_left_shift(t, static_cast<double_limb_type>(n) * CppInt::limb_bits);
+      eval_subtract(r, t);
+   }
+   eval_multiply(t, q, b_low);
+   eval_left_shift(r, static_cast<double_limb_type>(n) * CppInt::limb_bits);
+   eval_add(r, a_low);
+   eval_subtract(r, t);
+   //
+   // Our estimate of q is at most 2 too large:
+   //
+   while(r.sign())
+   {
+      eval_add(r, b);
+      eval_decrement(q);
+   }
+}
+
+template <class CppInt1, class CppInt2, class CppInt3, class CppInt4>
+void divide_unsigned_recursive(
+   CppInt1* result, 
+   const CppInt2& x, 
+   const CppInt3& y, 
+   CppInt4& r)
+{
+   typedef typename detail::scratch_type<CppInt1>::type scratch_type;
+   if((void*)result == (void*)&r)
+   {
+      scratch_type rem;
+      divide_unsigned_recursive(result, x, y, rem);
+      r = rem;
+      return;
+   }
+   //
+   // Choose the block size n = j * m with m a power of 2, such that j <= cutoff and n >= y.size():
+   //
+   unsigned s = y.size();
+   unsigned m = 1;
+   while(m * burnikel_ziegler_cutoff <= s)
+      m <<= 1;
+   unsigned j = (s + m - 1) / m;
+   unsigned n = j * m;
+   double_limb_type block_bits = static_cast<double_limb_type>(n) * CppInt1::limb_bits;
+   //
+   // Normalise so that the divisor occupies exactly n limbs with the top bit set:
+   //
+   unsigned sigma = n * CppInt1::limb_bits - (s - 1) * CppInt1::limb_bits - boost::multiprecision::detail::find_msb(y.limbs()[s - 1]) - 1;
+   scratch_type a, b;
+   assign_limbs(a, x.limbs(), x.size(), 0, x.size());
+   assign_limbs(b, y.limbs(), y.size(), 0, y.size());
+   eval_left_shift(a, static_cast<double_limb_type>(sigma));
+   eval_left_shift(b, static_cast<double_limb_type>(sigma));
+   //
+   // Number of blocks in the numerator, we make sure the most significant block has its
+   // top bit clear so that the first step satisfies the preconditions of the 2n by n division:
+   //
+   double_limb_type a_bits = static_cast<double_limb_type>(a.size() - 1) * CppInt1::limb_bits + boost::multiprecision::detail::find_msb(a.limbs()[a.size() - 1]) + 1;
+   unsigned t = static_cast<unsigned>((a_bits + block_bits) / block_bits);
+   if(t < 2)
+      t = 2;
+
+   scratch_type z, q, rem, block;
+   assign_limbs(z, a.limbs(), a.size(), (t - 2) * n, 2 * n);
+   if(result)
+   {
+      result->resize((t - 1) * n, (t - 1) * n);
+      std::memset(result->limbs(), 0, result->size() * sizeof(limb_type));
+   }
+   for(unsigned i = t - 2;; --i)
+   {
+      divide_burnikel_ziegler_2n1n(z, b, n, q, rem);
+      if(result)
+      {
+         BOOST_ASSERT(q.size() <= n);
+         std::memcpy(result->limbs() + i * n, q.limbs(), q.size() * sizeof(limb_type));
+      }
+      if(i == 0)
+         break;
+      assign_limbs(block, a.limbs(), a.size(), (i - 1) * n, n);
+      eval_left_shift(rem, block_bits);
+      eval_add(rem, block);
+      z.swap(rem);
+   }
+   if(result)
+   {
+      result->normalize();
+      result->sign(false);
+   }
+   eval_right_shift(rem, static_cast<double_limb_type>(sigma));
+   r = rem;
+}
+
+template <class CppInt1, class CppInt2, class CppInt3, class CppInt4>
+inline void divide_unsigned_helper(
+   CppInt1* result, 
+   const CppInt2& x, 
+   const CppInt3& y, 
+   CppInt4& r,
+   const mpl::true_&)
+{
+   if((y.size() >= burnikel_ziegler_cutoff) && (x.size() >= y.size() + burnikel_ziegler_cutoff))
+      divide_unsigned_recursive(result, x, y, r);
+   else
+      divide_unsigned_schoolbook(result, x, y, r);
+}
+
+template <class CppInt1, class CppInt2, class CppInt3, class CppInt4>
+inline void divide_unsigned_helper(
+   CppInt1* result, 
+   const CppInt2& x, 
+   const CppInt3& y, 
+   CppInt4& r,
+   const mpl::false_&)
+{
+   divide_unsigned_schoolbook(result, x, y, r);
+}
+
+template <class CppInt1, class CppInt2, class CppInt3, class CppInt4>
+inline void divide_unsigned_helper(
+   CppInt1* result, 
+   const CppInt2& x, 
+   const CppInt3& y, 
+   CppInt4& r)
+{
+   divide_unsigned_helper(result, x, y, r, mpl::bool_<!is_fixed_precision<CppInt1>::value>());
+}
+
+template <class CppInt1, class CppInt2, class CppInt4>
 void divide_unsigned_helper(
    CppInt1* result, 
    const CppInt2& x, 
    limb_type y, 
-   CppInt1& r)
+   CppInt4& r)
 {
    if(((void*)result == (void*)&x) || ((void*)&r == (void*)&x))
    {
-      CppInt2 t(x);
+      typename detail::scratch_type<CppInt2>::type t(x);
       divide_unsigned_helper(result, t, y, r);
       return;
    }
 
-   if(result == &r)
+   if((void*)result == (void*)&r)
    {
-      CppInt1 rem;
+      typename detail::scratch_type<CppInt1>::type rem;
       divide_unsigned_helper(result, x, y, rem);
       r = rem;
       return;
@@ -334,7 +533,7 @@ void divide_unsigned_helper(
    //
    r = x;
    r.sign(false);
-   typename CppInt1::limb_pointer pr = r.limbs();
+   limb_type* pr = r.limbs();
 
    //
    // check for x < y, try to do this without actually having to 
@@ -444,7 +643,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<Mi
       const cpp_int_backend<MinBits2, MaxBits2, SignType2, Checked2, Allocator2>& a, 
       const cpp_int_backend<MinBits3, MaxBits3, SignType3, Checked3, Allocator3>& b)
 {
-   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> r;
+   typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type r;
    bool s = a.sign() != b.sign();
    divide_unsigned_helper(&result, a, b, r);
    result.sign(s);
@@ -457,7 +656,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<Mi
       const cpp_int_backend<MinBits2, MaxBits2, SignType2, Checked2, Allocator2>& a, 
       limb_type& b)
 {
-   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> r;
+   typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type r;
    bool s = a.sign();
    divide_unsigned_helper(&result, a, b, r);
    result.sign(s);
@@ -470,7 +669,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<Mi
       const cpp_int_backend<MinBits2, MaxBits2, SignType2, Checked2, Allocator2>& a, 
       signed_limb_type& b)
 {
-   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> r;
+   typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type r;
    bool s = a.sign() != (b < 0);
    divide_unsigned_helper(&result, a, static_cast<limb_type>(boost::multiprecision::detail::unsigned_abs(b)), r);
    result.sign(s);
@@ -483,7 +682,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<Mi
       const cpp_int_backend<MinBits2, MaxBits2, SignType2, Checked2, Allocator2>& b)
 {
    // There is no in place divide:
-   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> a(result);
+   typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type a(result);
    eval_divide(result, a, b);
 }
 
@@ -494,7 +693,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<Mi
       limb_type b)
 {
    // There is no in place divide:
-   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> a(result);
+   typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type a(result);
    eval_divide(result, a, b);
 }
 
@@ -505,7 +704,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<Mi
       signed_limb_type b)
 {
    // There is no in place divide:
-   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> a(result);
+   typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type a(result);
    eval_divide(result, a, b);
 }
 
@@ -551,7 +750,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<Mi
       const cpp_int_backend<MinBits2, MaxBits2, SignType2, Checked2, Allocator2>& b)
 {
    // There is no in place divide:
-   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> a(result);
+   typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type a(result);
    eval_modulus(result, a, b);
 }
 
@@ -562,7 +761,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<Mi
       limb_type b)
 {
    // There is no in place divide:
-   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> a(result);
+   typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type a(result);
    eval_modulus(result, a, b);
 }
 
@@ -573,7 +772,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<Mi
       signed_limb_type b)
 {
    // There is no in place divide:
-   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> a(result);
+   typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type a(result);
    eval_modulus(result, a, b);
 }
 
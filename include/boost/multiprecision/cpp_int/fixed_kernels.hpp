@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Unrolled add, subtract and multiply kernels for small fixed precision cpp_int_backend's:
+//
+#ifndef BOOST_MP_CPP_INT_FIXED_KERNELS_HPP
+#define BOOST_MP_CPP_INT_FIXED_KERNELS_HPP
+
+//
+// Unchecked fixed precision types of up to BOOST_MP_FIXED_KERNEL_BITS bits (int128_t through int1024_t
+// and their unsigned counterparts) add, subtract and multiply large values with kernels which are unrolled at
+// compile time over the whole of the type's internal storage, rather than looping over the limbs in use:
+//
+#ifndef BOOST_MP_FIXED_KERNEL_BITS
+#define BOOST_MP_FIXED_KERNEL_BITS 1024
+#endif
+
+#if defined(BOOST_HAS_INT128) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define BOOST_MP_HAS_ADDCARRY_U64
+#elif !defined(BOOST_HAS_INT128) && defined(BOOST_MSVC) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define BOOST_MP_HAS_ADDCARRY_U32
+#endif
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+//
+// True when the arguments to an operation are all the same type and that type can use the kernels below:
+//
+template <class CppInt1, class CppInt2 = CppInt1, class CppInt3 = CppInt1>
+struct is_fixed_kernel_cpp_int : public mpl::false_ {};
+template <unsigned MinBits, cpp_integer_type SignType>
+struct is_fixed_kernel_cpp_int<cpp_int_backend<MinBits, MinBits, SignType, unchecked, void>, cpp_int_backend<MinBits, MinBits, SignType, unchecked, void>, cpp_int_backend<MinBits, MinBits, SignType, unchecked, void> >
+   : public mpl::bool_<!is_trivial_cpp_int<cpp_int_backend<MinBits, MinBits, SignType, unchecked, void> >::value && (MinBits <= BOOST_MP_FIXED_KERNEL_BITS)> {};
+
+//
+// *pr = a + b + carry, returns the carry out:
+//
+BOOST_MP_FORCEINLINE unsigned char add_with_carry(unsigned char carry, limb_type a, limb_type b, limb_type* pr) BOOST_NOEXCEPT
+{
+#if defined(BOOST_MP_HAS_ADDCARRY_U64)
+   unsigned long long r;
+   carry = _addcarry_u64(carry, a, b, &r);
+   *pr = static_cast<limb_type>(r);
+   return carry;
+#elif defined(BOOST_MP_HAS_ADDCARRY_U32)
+   unsigned int r;
+   carry = _addcarry_u32(carry, a, b, &r);
+   *pr = static_cast<limb_type>(r);
+   return carry;
+#else
+   double_limb_type t = static_cast<double_limb_type>(a) + static_cast<double_limb_type>(b) + carry;
+   *pr = static_cast<limb_type>(t);
+   return static_cast<unsigned char>(t >> bits_per_limb);
+#endif
+}
+//
+// *pr = a - b - borrow, returns the borrow out:
+//
+BOOST_MP_FORCEINLINE unsigned char subtract_with_borrow(unsigned char borrow, limb_type a, limb_type b, limb_type* pr) BOOST_NOEXCEPT
+{
+#if defined(BOOST_MP_HAS_ADDCARRY_U64)
+   unsigned long long r;
+   borrow = _subborrow_u64(borrow, a, b, &r);
+   *pr = static_cast<limb_type>(r);
+   return borrow;
+#elif defined(BOOST_MP_HAS_ADDCARRY_U32)
+   unsigned int r;
+   borrow = _subborrow_u32(borrow, a, b, &r);
+   *pr = static_cast<limb_type>(r);
+   return borrow;
+#else
+   double_limb_type t = static_cast<double_limb_type>(a) - static_cast<double_limb_type>(b) - borrow;
+   *pr = static_cast<limb_type>(t);
+   return static_cast<unsigned char>((t >> bits_per_limb) & 1u);
+#endif
+}
+
+//
+// The kernels operate on limbs [I, N) of the result, where N is the limb count of the type.  The arguments
+// occupy only their first as and bs limbs, the storage above that is uninitialised and reads as zero:
+//
+template <unsigned I, unsigned N>
+struct fixed_kernel
+{
+   static BOOST_MP_FORCEINLINE unsigned char add(limb_type* pr, const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs, unsigned char carry) BOOST_NOEXCEPT
+   {
+      carry = add_with_carry(carry, I < as ? pa[I] : 0, I < bs ? pb[I] : 0, pr + I);
+      return fixed_kernel<I + 1, N>::add(pr, pa, as, pb, bs, carry);
+   }
+   static BOOST_MP_FORCEINLINE unsigned char subtract(limb_type* pr, const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs, unsigned char borrow) BOOST_NOEXCEPT
+   {
+      borrow = subtract_with_borrow(borrow, I < as ? pa[I] : 0, I < bs ? pb[I] : 0, pr + I);
+      return fixed_kernel<I + 1, N>::subtract(pr, pa, as, pb, bs, borrow);
+   }
+   //
+   // pr[I, N) = 0 - pr[I, N) - borrow:
+   //
+   static BOOST_MP_FORCEINLINE void negate(limb_type* pr, unsigned char borrow) BOOST_NOEXCEPT
+   {
+      borrow = subtract_with_borrow(borrow, 0, pr[I], pr + I);
+      fixed_kernel<I + 1, N>::negate(pr, borrow);
+   }
+};
+template <unsigned N>
+struct fixed_kernel<N, N>
+{
+   static BOOST_MP_FORCEINLINE unsigned char add(limb_type*, const limb_type*, unsigned, const limb_type*, unsigned, unsigned char carry) BOOST_NOEXCEPT
+   {
+      return carry;
+   }
+   static BOOST_MP_FORCEINLINE unsigned char subtract(limb_type*, const limb_type*, unsigned, const limb_type*, unsigned, unsigned char borrow) BOOST_NOEXCEPT
+   {
+      return borrow;
+   }
+   static BOOST_MP_FORCEINLINE void negate(limb_type*, unsigned char) BOOST_NOEXCEPT {}
+};
+//
+// Adds x * pb[0, M) to pr[0, M), working up from limb J, with the carry out of limb M - 1 discarded.
+// The multiplication kernels are left to the compiler to inline, as forcing the whole product inline
+// for the larger types is slower than the general code:
+//
+template <unsigned J, unsigned M>
+struct fixed_multiply_row
+{
+   static inline void apply(limb_type* pr, limb_type x, const limb_type* pb, unsigned bs, limb_type carry) BOOST_NOEXCEPT
+   {
+      double_limb_type t = static_cast<double_limb_type>(x) * static_cast<double_limb_type>(J < bs ? pb[J] : 0) + pr[J] + carry;
+      pr[J] = static_cast<limb_type>(t);
+      fixed_multiply_row<J + 1, M>::apply(pr, x, pb, bs, static_cast<limb_type>(t >> bits_per_limb));
+   }
+};
+template <unsigned M>
+struct fixed_multiply_row<M, M>
+{
+   static inline void apply(limb_type*, limb_type, const limb_type*, unsigned, limb_type) BOOST_NOEXCEPT {}
+};
+//
+// Adds the rows I and above of pa[0, as) * pb[0, bs) to pr[0, N), truncated to N limbs.  Rows past the end
+// of pa contribute nothing, so we stop there:
+//
+template <unsigned I, unsigned N>
+struct fixed_multiply
+{
+   static inline void apply(limb_type* pr, const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs) BOOST_NOEXCEPT
+   {
+      if(I < as)
+      {
+         fixed_multiply_row<0, N - I>::apply(pr + I, pa[I], pb, bs, 0);
+         fixed_multiply<I + 1, N>::apply(pr, pa, as, pb, bs);
+      }
+   }
+};
+template <unsigned N>
+struct fixed_multiply<N, N>
+{
+   static inline void apply(limb_type*, const limb_type*, unsigned, const limb_type*, unsigned) BOOST_NOEXCEPT {}
+};
+
+}}} // namespaces
+
+#endif
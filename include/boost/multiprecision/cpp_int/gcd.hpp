@@ -0,0 +1,580 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Lehmer and half-gcd reduction, and the extended gcd, for cpp_int_backend:
+//
+#ifndef BOOST_MP_CPP_INT_GCD_HPP
+#define BOOST_MP_CPP_INT_GCD_HPP
+
+#include <vector>
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+//
+// Values with more than two limbs are reduced with Lehmer's algorithm, until the smaller of the
+// two has at least BOOST_MP_HALF_GCD_CUTOFF limbs when we use the subquadratic half-gcd instead.
+//
+#ifndef BOOST_MP_HALF_GCD_CUTOFF
+#define BOOST_MP_HALF_GCD_CUTOFF 800
+#endif
+
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_HALF_GCD_CUTOFF >= 3, "The half-gcd cutoff must be at least 3 limbs.");
+
+static const unsigned half_gcd_cutoff = BOOST_MP_HALF_GCD_CUTOFF;
+
+template <class CppInt>
+inline unsigned gcd_bit_count(const CppInt& a)
+{
+   using default_ops::eval_is_zero;
+   return eval_is_zero(a) ? 0 : eval_msb(a) + 1;
+}
+//
+// Returns bits [w, w + bits_per_limb) of p[0, n):
+//
+inline limb_type gcd_get_bits(const limb_type* p, unsigned n, unsigned w) BOOST_NOEXCEPT
+{
+   unsigned i = w / bits_per_limb;
+   unsigned shift = w % bits_per_limb;
+   limb_type result = i < n ? p[i] >> shift : 0;
+   if(shift && (i + 1 < n))
+      result |= p[i + 1] << (bits_per_limb - shift);
+   return result;
+}
+//
+// pr[0, n) = a * pu[0, n) - b * pv[0, n), the result must be non-negative and fit in n limbs:
+//
+inline void lehmer_combine(limb_type* pr, const limb_type* pu, const limb_type* pv, unsigned n, limb_type a, limb_type b) BOOST_NOEXCEPT
+{
+   double_limb_type ca = 0;
+   double_limb_type cb = 0;
+   limb_type borrow = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      ca += static_cast<double_limb_type>(a) * pu[i];
+      cb += static_cast<double_limb_type>(b) * pv[i];
+      double_limb_type d = static_cast<double_limb_type>(static_cast<limb_type>(ca)) - static_cast<limb_type>(cb) - borrow;
+      pr[i] = static_cast<limb_type>(d);
+      borrow = static_cast<limb_type>(d >> bits_per_limb) ? 1u : 0u;
+      ca >>= bits_per_limb;
+      cb >>= bits_per_limb;
+   }
+   BOOST_ASSERT(ca == cb + borrow);
+}
+
+//
+// The product of the elementary matrices [[1, q], [0, 1]] and [[1, 0], [q, 1]] which describe a
+// sequence of reduction steps, so (a, b) = M * (alpha, beta) where (alpha, beta) are the reduced
+// values.  All the entries are non-negative and the determinant is always one.
+//
+struct half_gcd_matrix
+{
+   cpp_int_backend<> m[2][2];
+
+   half_gcd_matrix()
+   {
+      m[0][0] = m[1][1] = static_cast<limb_type>(1u);
+      m[0][1] = m[1][0] = static_cast<limb_type>(0u);
+   }
+};
+//
+// (a, b) = M^-1 * (a, b) = (m11 * a - m01 * b, m00 * b - m10 * a):
+//
+inline void half_gcd_apply(const half_gcd_matrix& M, cpp_int_backend<>& a, cpp_int_backend<>& b)
+{
+   cpp_int_backend<> t1, t2, na;
+   eval_multiply(t1, M.m[1][1], a);
+   eval_multiply(t2, M.m[0][1], b);
+   eval_subtract(na, t1, t2);
+   eval_multiply(t1, M.m[0][0], b);
+   eval_multiply(t2, M.m[1][0], a);
+   eval_subtract(b, t1, t2);
+   a.swap(na);
+}
+//
+// M = M * N:
+//
+inline void half_gcd_multiply(half_gcd_matrix& M, const half_gcd_matrix& N)
+{
+   cpp_int_backend<> t1, t2, r0, r1;
+   for(unsigned i = 0; i < 2; ++i)
+   {
+      eval_multiply(t1, M.m[i][0], N.m[0][0]);
+      eval_multiply(t2, M.m[i][1], N.m[1][0]);
+      eval_add(r0, t1, t2);
+      eval_multiply(t1, M.m[i][0], N.m[0][1]);
+      eval_multiply(t2, M.m[i][1], N.m[1][1]);
+      eval_add(r1, t1, t2);
+      M.m[i][0].swap(r0);
+      M.m[i][1].swap(r1);
+   }
+}
+//
+// One reduction step of the half-gcd: subtracts from the larger of a and b the largest multiple of
+// the smaller which leaves it at least 2^s, returns false if |a - b| < 2^s so that no such step is possible.
+// Both a and b must be at least 2^s:
+//
+inline bool half_gcd_step(cpp_int_backend<>& a, cpp_int_backend<>& b, half_gcd_matrix& M, unsigned s)
+{
+   bool swapped = a.compare(b) < 0;
+   cpp_int_backend<>& x = swapped ? b : a;
+   cpp_int_backend<>& y = swapped ? a : b;
+   cpp_int_backend<> d, q, bound;
+   eval_subtract(d, x, y);
+   if(gcd_bit_count(d) <= s)
+      return false;
+   bound = static_cast<limb_type>(1u);
+   eval_left_shift(bound, s);
+   eval_subtract(q, d, bound);
+   if(q.compare(y) < 0)
+   {
+      // The quotient is one, which is by far the most common case:
+      x.swap(d);
+      q = static_cast<limb_type>(1u);
+   }
+   else
+   {
+      eval_subtract(d, x, bound);
+      eval_divide(q, d, y);
+      eval_multiply(d, q, y);
+      eval_subtract(x, d);
+   }
+   unsigned col = swapped ? 0 : 1;
+   for(unsigned i = 0; i < 2; ++i)
+   {
+      eval_multiply(d, q, M.m[i][1 - col]);
+      eval_add(M.m[i][col], d);
+   }
+   return true;
+}
+//
+// The half-gcd of values which fit in a double limb, using native arithmetic throughout:
+//
+inline bool half_gcd_native(cpp_int_backend<>& a, cpp_int_backend<>& b, half_gcd_matrix& M, unsigned s)
+{
+   BOOST_ASSERT((a.size() <= 2) && (b.size() <= 2));
+   double_limb_type x = a.size() == 2 ? a.limbs()[0] | (static_cast<double_limb_type>(a.limbs()[1]) << bits_per_limb) : *a.limbs();
+   double_limb_type y = b.size() == 2 ? b.limbs()[0] | (static_cast<double_limb_type>(b.limbs()[1]) << bits_per_limb) : *b.limbs();
+   double_limb_type bound = static_cast<double_limb_type>(1u) << s;
+   //
+   // The entries of M are bounded by 2^(n - s) where n is the number of bits in the arguments,
+   // so they always fit in a limb:
+   //
+   limb_type m[2][2] = { { 1, 0 }, { 0, 1 } };
+   bool reduced = false;
+   while(true)
+   {
+      bool swapped = x < y;
+      double_limb_type& p = swapped ? y : x;
+      double_limb_type& r = swapped ? x : y;
+      double_limb_type d = p - r;
+      if(d < bound)
+         break;
+      limb_type q = 1;
+      if(d - bound < r)
+         p = d;
+      else
+      {
+         q = static_cast<limb_type>((p - bound) / r);
+         p -= q * r;
+      }
+      unsigned col = swapped ? 0 : 1;
+      m[0][col] += q * m[0][1 - col];
+      m[1][col] += q * m[1][1 - col];
+      reduced = true;
+   }
+   if(reduced)
+   {
+      limb_type t[2] = { static_cast<limb_type>(x), static_cast<limb_type>(x >> bits_per_limb) };
+      assign_limbs(a, t, 2, 0, 2);
+      t[0] = static_cast<limb_type>(y);
+      t[1] = static_cast<limb_type>(y >> bits_per_limb);
+      assign_limbs(b, t, 2, 0, 2);
+      for(unsigned i = 0; i < 2; ++i)
+         for(unsigned j = 0; j < 2; ++j)
+            M.m[i][j] = m[i][j];
+   }
+   return reduced;
+}
+//
+// Subquadratic half-gcd after Moller, "On Schonhage's algorithm and subquadratic integer gcd computation".
+// Let n be the number of bits in the larger of a and b and s = n / 2 + 1, then on exit (a, b) have been replaced
+// by (alpha, beta) = M^-1 * (a, b), with alpha and beta both at least 2^s and |alpha - beta| < 2^s.  Returns false
+// if no reduction was possible, in which case a, b and M are unchanged.  M must be the identity on entry.
+//
+// The recursion rests on the fact that a matrix which reduces the high halves of a and b (to values of at least
+// 2^s1) also reduces a and b themselves, since the entries of M are then small compared to the reduced values.
+//
+inline bool half_gcd(cpp_int_backend<>& a, cpp_int_backend<>& b, half_gcd_matrix& M)
+{
+   unsigned n = (std::max)(gcd_bit_count(a), gcd_bit_count(b));
+   unsigned s = n / 2 + 1;
+   if((gcd_bit_count(a) <= s) || (gcd_bit_count(b) <= s))
+      return false;
+   if(n <= 2 * bits_per_limb)
+      return half_gcd_native(a, b, M, s);
+
+   bool reduced = false;
+   cpp_int_backend<> a1(a), b1(b);
+   //
+   // Reduce the high halves first, which leaves a and b with about 3n/4 bits:
+   //
+   unsigned p = n / 2;
+   eval_right_shift(a1, p);
+   eval_right_shift(b1, p);
+   if(half_gcd(a1, b1, M))
+   {
+      half_gcd_apply(M, a, b);
+      reduced = true;
+   }
+   while((std::max)(gcd_bit_count(a), gcd_bit_count(b)) > (3 * n) / 4 + 1)
+   {
+      //
+      // If no step is possible then a and b are already fully reduced:
+      //
+      if(!half_gcd_step(a, b, M, s))
+         return reduced;
+      reduced = true;
+   }
+   //
+   // Now reduce the high parts again, choosing the split point so that the reduced values are at least 2^s:
+   //
+   unsigned m = (std::max)(gcd_bit_count(a), gcd_bit_count(b));
+   if(m >= s + 2)
+   {
+      p = 2 * s - m + 1;
+      a1 = a;
+      b1 = b;
+      eval_right_shift(a1, p);
+      eval_right_shift(b1, p);
+      half_gcd_matrix M2;
+      if(half_gcd(a1, b1, M2))
+      {
+         half_gcd_apply(M2, a, b);
+         half_gcd_multiply(M, M2);
+         reduced = true;
+      }
+   }
+   while(half_gcd_step(a, b, M, s))
+      reduced = true;
+   BOOST_ASSERT((gcd_bit_count(a) > s) && (gcd_bit_count(b) > s));
+   return reduced;
+}
+
+//
+// Cofactor tracking for the extended gcd: if (u, v) are the values being reduced, which started out as (a, b),
+// then we maintain su and sv with u = su * a + tu * b and v = sv * a + tv * b.  The "t" cofactors are recovered
+// at the end by division.  The plain gcd uses the no-op version:
+//
+struct gcd_no_cofactors
+{
+   static const bool track = false;
+   void swap() {}
+   void combine(signed_double_limb_type, signed_double_limb_type, signed_double_limb_type, signed_double_limb_type) {}
+   void apply_inverse(const half_gcd_matrix&) {}
+   void subtract_multiple(const cpp_int_backend<>&) {}
+};
+
+class gcd_cofactors
+{
+public:
+   static const bool track = true;
+
+   gcd_cofactors()
+   {
+      m_su = static_cast<limb_type>(1u);
+      m_sv = static_cast<limb_type>(0u);
+   }
+   void swap()
+   {
+      m_su.swap(m_sv);
+   }
+   //
+   // (su, sv) = (a * su + b * sv, c * su + d * sv):
+   //
+   void combine(signed_double_limb_type a, signed_double_limb_type b, signed_double_limb_type c, signed_double_limb_type d)
+   {
+      cpp_int_backend<> nu, nv;
+      combine(nu, a, b);
+      combine(nv, c, d);
+      m_su.swap(nu);
+      m_sv.swap(nv);
+   }
+   void apply_inverse(const half_gcd_matrix& M)
+   {
+      cpp_int_backend<> t1, t2, nu;
+      eval_multiply(t1, M.m[1][1], m_su);
+      eval_multiply(t2, M.m[0][1], m_sv);
+      eval_subtract(nu, t1, t2);
+      eval_multiply(t1, M.m[0][0], m_sv);
+      eval_multiply(t2, M.m[1][0], m_su);
+      eval_subtract(m_sv, t1, t2);
+      m_su.swap(nu);
+   }
+   //
+   // su -= q * sv:
+   //
+   void subtract_multiple(const cpp_int_backend<>& q)
+   {
+      cpp_int_backend<> t;
+      eval_multiply(t, q, m_sv);
+      eval_subtract(m_su, t);
+   }
+   const cpp_int_backend<>& su()const { return m_su; }
+
+private:
+   void combine(cpp_int_backend<>& r, signed_double_limb_type a, signed_double_limb_type b)const
+   {
+      cpp_int_backend<> t;
+      eval_multiply(r, m_su, static_cast<limb_type>(a < 0 ? -a : a));
+      if(a < 0)
+         r.negate();
+      eval_multiply(t, m_sv, static_cast<limb_type>(b < 0 ? -b : b));
+      if(b < 0)
+         t.negate();
+      eval_add(r, t);
+   }
+
+   cpp_int_backend<> m_su, m_sv;
+};
+
+//
+// (u, v) = (v, u mod v):
+//
+template <class CppInt>
+inline void gcd_division_step(CppInt& u, CppInt& v, gcd_no_cofactors&)
+{
+   CppInt r;
+   eval_modulus(r, u, v);
+   u.swap(v);
+   v.swap(r);
+}
+inline void gcd_division_step(cpp_int_backend<>& u, cpp_int_backend<>& v, gcd_cofactors& c)
+{
+   cpp_int_backend<> q, r;
+   eval_qr(u, v, q, r);
+   c.subtract_multiple(q);
+   c.swap();
+   u.swap(v);
+   v.swap(r);
+}
+
+//
+// One step of Lehmer's algorithm (Knuth Vol 2, Algorithm L), u >= v with u having at most one more limb than v.
+// The leading bits_per_limb bits of u and v (taken from the same position) are reduced with single precision
+// cofactors, the cofactor arithmetic is carried out in double limbs so that it can't overflow.  Returns false
+// if the first quotient can't be determined from the leading bits, in which case the caller must divide:
+//
+template <class CppInt, class Cofactors>
+bool lehmer_step(CppInt& u, CppInt& v, Cofactors& c, detail::scratch_vector& storage)
+{
+   unsigned n = u.size();
+   unsigned w = (n - 1) * bits_per_limb + boost::multiprecision::detail::find_msb(u.limbs()[n - 1]) + 1 - bits_per_limb;
+   signed_double_limb_type x = gcd_get_bits(u.limbs(), n, w);
+   signed_double_limb_type y = gcd_get_bits(v.limbs(), v.size(), w);
+   signed_double_limb_type A = 1, B = 0, C = 0, D = 1;
+   while((y + C > 0) && (y + D > 0))
+   {
+      signed_double_limb_type q = (x + A) / (y + C);
+      if(q != (x + B) / (y + D))
+         break;
+      signed_double_limb_type t = A - q * C;
+      A = C;
+      C = t;
+      t = B - q * D;
+      B = D;
+      D = t;
+      t = x - q * y;
+      x = y;
+      y = t;
+   }
+   if(B == 0)
+      return false;
+   //
+   // (u, v) = (A * u + B * v, C * u + D * v) where each pair of cofactors has opposite signs:
+   //
+   storage.assign(4 * n, 0);
+   limb_type* pu = &storage[0];
+   limb_type* pv = pu + n;
+   limb_type* pr1 = pv + n;
+   limb_type* pr2 = pr1 + n;
+   std::memcpy(pu, u.limbs(), n * sizeof(limb_type));
+   std::memcpy(pv, v.limbs(), v.size() * sizeof(limb_type));
+   if(B <= 0)
+      lehmer_combine(pr1, pu, pv, n, static_cast<limb_type>(A), static_cast<limb_type>(-B));
+   else
+      lehmer_combine(pr1, pv, pu, n, static_cast<limb_type>(B), static_cast<limb_type>(-A));
+   if(D <= 0)
+      lehmer_combine(pr2, pu, pv, n, static_cast<limb_type>(C), static_cast<limb_type>(-D));
+   else
+      lehmer_combine(pr2, pv, pu, n, static_cast<limb_type>(D), static_cast<limb_type>(-C));
+   assign_limbs(u, pr1, n, 0, n);
+   assign_limbs(v, pr2, n, 0, n);
+   c.combine(A, B, C, D);
+   return true;
+}
+
+//
+// One half-gcd step of the gcd: the half-gcd of the top halves of u and v is applied to u and v, which
+// reduces their size by about a quarter.  Returns false if the top halves could not be reduced:
+//
+template <class CppInt, class Cofactors>
+bool half_gcd_reduce(CppInt& u, CppInt& v, Cofactors& c)
+{
+   cpp_int_backend<> a, b;
+   unsigned p = gcd_bit_count(u) / 2;
+   assign_limbs(a, u.limbs(), u.size(), 0, u.size());
+   assign_limbs(b, v.limbs(), v.size(), 0, v.size());
+   eval_right_shift(a, p);
+   eval_right_shift(b, p);
+   half_gcd_matrix M;
+   if(!half_gcd(a, b, M))
+      return false;
+   assign_limbs(a, u.limbs(), u.size(), 0, u.size());
+   assign_limbs(b, v.limbs(), v.size(), 0, v.size());
+   half_gcd_apply(M, a, b);
+   BOOST_ASSERT((eval_get_sign(a) > 0) && (eval_get_sign(b) > 0));
+   assign_limbs(u, a.limbs(), a.size(), 0, a.size());
+   assign_limbs(v, b.limbs(), b.size(), 0, b.size());
+   c.apply_inverse(M);
+   return true;
+}
+
+//
+// Reduces non-negative u and v without changing their gcd, until both have at most two limbs (v may
+// become zero).  On exit u >= v:
+//
+template <class CppInt, class Cofactors>
+void eval_gcd_reduce(CppInt& u, CppInt& v, Cofactors& c)
+{
+   detail::scratch_vector storage;
+   if(u.compare(v) < 0)
+   {
+      u.swap(v);
+      c.swap();
+   }
+   while(v.size() > 2)
+   {
+      bool progress = false;
+      if(u.size() <= v.size() + 1)
+      {
+         if(v.size() >= half_gcd_cutoff)
+            progress = half_gcd_reduce(u, v, c);
+         else
+            progress = lehmer_step(u, v, c, storage);
+      }
+      if(!progress)
+         gcd_division_step(u, v, c);
+      if(u.compare(v) < 0)
+      {
+         u.swap(v);
+         c.swap();
+      }
+   }
+   if((u.size() > 2) && !eval_is_zero(v))
+      gcd_division_step(u, v, c);
+}
+template <class CppInt>
+inline void eval_gcd_reduce(CppInt& u, CppInt& v)
+{
+   gcd_no_cofactors c;
+   eval_gcd_reduce(u, v, c);
+}
+
+//
+// Extended gcd: sets g = gcd(a, b) and x, y such that a * x + b * y = g, with 0 <= x < |b| / g when b is
+// non-zero.  All the arithmetic is carried out in arbitrary precision:
+//
+inline void eval_extended_gcd_imp(cpp_int_backend<>& g, cpp_int_backend<>& x, cpp_int_backend<>& y, const cpp_int_backend<>& a, const cpp_int_backend<>& b)
+{
+   using default_ops::eval_get_sign;
+   using default_ops::eval_is_zero;
+
+   if(eval_is_zero(b))
+   {
+      g = a;
+      x = static_cast<limb_type>(eval_is_zero(a) ? 0u : 1u);
+      if(eval_get_sign(a) < 0)
+      {
+         g.negate();
+         x.negate();
+      }
+      y = static_cast<limb_type>(0u);
+      return;
+   }
+   cpp_int_backend<> u(a), v(b), t;
+   if(eval_get_sign(u) < 0)
+      u.negate();
+   if(eval_get_sign(v) < 0)
+      v.negate();
+   //
+   // Since we only track the coefficient of a, we must not swap u and v initially:
+   //
+   gcd_cofactors c;
+   if(u.compare(v) < 0)
+   {
+      u.swap(v);
+      c.swap();
+   }
+   eval_gcd_reduce(u, v, c);
+   while(!eval_is_zero(v))
+      gcd_division_step(u, v, c);
+   g = u;
+   //
+   // Now g = su * |a| + tu * |b|, normalise su into [0, |b| / g) and then tu = (g - su * |a|) / |b|:
+   //
+   x = c.su();
+   if(eval_get_sign(a) < 0)
+      x.negate();
+   cpp_int_backend<> bg(b);
+   if(eval_get_sign(bg) < 0)
+      bg.negate();
+   eval_divide(bg, g);
+   eval_modulus(x, bg);
+   if(eval_get_sign(x) < 0)
+      eval_add(x, bg);
+   eval_multiply(t, a, x);
+   eval_subtract(y, g, t);
+   eval_divide(y, b);
+}
+
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+inline void eval_extended_gcd(
+   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& g,
+   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& x,
+   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& y,
+   const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& a,
+   const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& b)
+{
+   cpp_int_backend<> ga, gb, gg, gx, gy;
+   ga = a;
+   gb = b;
+   eval_extended_gcd_imp(gg, gx, gy, ga, gb);
+   g = gg;
+   x = gx;
+   y = gy;
+}
+
+} // namespace backends
+
+//
+// Returns gcd(a, b) and sets x and y to the Bezout cofactors, so that a * x + b * y = gcd(a, b):
+//
+template <unsigned MinBits, unsigned MaxBits, cpp_integer_type SignType, cpp_int_check_type Checked, class Allocator, expression_template_option ExpressionTemplates>
+inline number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates>
+   extended_gcd(
+      const number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates>& a,
+      const number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates>& b,
+      number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates>& x,
+      number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates>& y)
+{
+   BOOST_STATIC_ASSERT_MSG(SignType != unsigned_magnitude, "extended_gcd requires a signed type, as one of the cofactors is usually negative.");
+   number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates> g;
+   backends::eval_extended_gcd(g.backend(), x.backend(), y.backend(), a.backend(), b.backend());
+   return g;
+}
+
+}} // namespaces
+
+#endif
@@ -355,6 +355,14 @@ inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBit
       result = u;
       return;
    }
+   if(u.size() > 2)
+   {
+      //
+      // Reduce u modulo v first, rather than subtracting v from u one step at a time:
+      //
+      result = boost::integer::gcd(v, eval_integer_modulus(u, v));
+      return;
+   }
 
    /* Let shift := lg K, where K is the greatest power of 2
    dividing both u and v. */
@@ -459,6 +467,20 @@ inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBit
       return;
    }
 
+   if((u.size() > 2) || (v.size() > 2))
+   {
+      //
+      // Large values are reduced with Lehmer's algorithm or the half-gcd (see gcd.hpp),
+      // until they fit in a double limb:
+      //
+      eval_gcd_reduce(u, v);
+      if(eval_is_zero(v))
+      {
+         result = u;
+         return;
+      }
+   }
+
    /* Let shift := lg K, where K is the greatest power of 2
    dividing both u and v. */
 
@@ -0,0 +1,427 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Montgomery modular arithmetic and powm for cpp_int_backend:
+//
+#ifndef BOOST_MP_CPP_INT_MONTGOMERY_HPP
+#define BOOST_MP_CPP_INT_MONTGOMERY_HPP
+
+#include <vector>
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+//
+// Returns -m^-1 mod B where B = 2^bits_per_limb, m must be odd.  Newton iteration
+// doubles the number of correct bits each time, starting from m which is its own
+// inverse modulo 8:
+//
+inline limb_type montgomery_inverse(limb_type m) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(m & 1u);
+   limb_type x = m;
+   for(unsigned correct_bits = 3; correct_bits < bits_per_limb; correct_bits *= 2)
+      x *= 2 - m * x;
+   return 0 - x;
+}
+//
+// Compares two n-limb values:
+//
+inline int compare_limbs(const limb_type* pa, const limb_type* pb, unsigned n) BOOST_NOEXCEPT
+{
+   while(n--)
+   {
+      if(pa[n] != pb[n])
+         return pa[n] > pb[n] ? 1 : -1;
+   }
+   return 0;
+}
+//
+// Montgomery reduction: pr[0, n) = pt[0, 2n) * B^-n mod pm[0, n), where pt < pm * B^n.
+// pt is used as workspace and is destroyed:
+//
+inline void montgomery_reduce(limb_type* pr, limb_type* pt, const limb_type* pm, unsigned n, limb_type inv) BOOST_NOEXCEPT
+{
+   limb_type overflow = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      limb_type u = pt[i] * inv;
+      double_limb_type carry = 0;
+      for(unsigned j = 0; j < n; ++j)
+      {
+         carry += static_cast<double_limb_type>(u) * static_cast<double_limb_type>(pm[j]);
+         carry += pt[i + j];
+         pt[i + j] = static_cast<limb_type>(carry);
+         carry >>= bits_per_limb;
+      }
+      limb_type c = static_cast<limb_type>(carry);
+      overflow += add_limbs_inplace(pt + i + n, n - i, &c, 1);
+   }
+   //
+   // The result is now in pt[n, 2n) plus overflow * B^n and is less than 2m:
+   //
+   if(overflow || (compare_limbs(pt + n, pm, n) >= 0))
+      subtract_limbs_inplace(pt + n, n, pm, n);
+   std::memcpy(pr, pt + n, n * sizeof(limb_type));
+}
+//
+// Once the modulus has this many limbs we perform the reduction with two full multiplications
+// (and hence Karatsuba) rather than the limb by limb method above:
+//
+static const unsigned montgomery_karatsuba_reduce_cutoff = 2 * karatsuba_cutoff;
+//
+// Montgomery reduction as above, but using u = (pt mod B^n) * pinv mod B^n and then
+// (pt + u * pm) / B^n, where pinv[0, n) = -m^-1 mod B^n.  "storage" must be
+// 5n + karatsuba_storage_size(n) limbs long:
+//
+inline void montgomery_reduce(limb_type* pr, limb_type* pt, const limb_type* pm, const limb_type* pinv, unsigned n, limb_type* storage) BOOST_NOEXCEPT
+{
+   limb_type* pu = storage + 2 * n;
+   limb_type* pkstorage = pu + n;
+   multiply_karatsuba(storage, pt, pinv, n, pkstorage);
+   std::memcpy(pu, storage, n * sizeof(limb_type));
+   multiply_karatsuba(storage, pu, pm, n, pkstorage);
+   limb_type overflow = add_limbs_inplace(pt, 2 * n, storage, 2 * n);
+   if(overflow || (compare_limbs(pt + n, pm, n) >= 0))
+      subtract_limbs_inplace(pt + n, n, pm, n);
+   std::memcpy(pr, pt + n, n * sizeof(limb_type));
+}
+//
+// Number of limbs of workspace required by montgomery_multiply:
+//
+inline unsigned montgomery_storage_size(unsigned n) BOOST_NOEXCEPT
+{
+   return (n < montgomery_karatsuba_reduce_cutoff ? 2 * n : 5 * n) + karatsuba_storage_size(n);
+}
+//
+// Montgomery multiplication: pr[0, n) = pa * pb * B^-n mod pm, pr may alias either argument.
+// "storage" must be montgomery_storage_size(n) limbs long:
+//
+inline void montgomery_multiply(limb_type* pr, const limb_type* pa, const limb_type* pb, const limb_type* pm, const limb_type* pinv, unsigned n, limb_type* storage) BOOST_NOEXCEPT
+{
+   if((pa == pb) && (n >= square_cutoff))
+   {
+      if(n < karatsuba_cutoff)
+         square_schoolbook(storage, pa, n);
+      else
+         square_karatsuba(storage, pa, n, storage + 2 * n);
+   }
+   else if(n < karatsuba_cutoff)
+      multiply_schoolbook(storage, pa, n, pb, n);
+   else
+      multiply_karatsuba(storage, pa, pb, n, storage + 2 * n);
+   if(n < montgomery_karatsuba_reduce_cutoff)
+      montgomery_reduce(pr, storage, pm, n, *pinv);
+   else
+      montgomery_reduce(pr, storage, pm, pinv, n, storage + 2 * n);
+}
+//
+// Selects the window size for sliding window exponentiation with an exponent of "bits" bits,
+// this minimises the number of squarings plus multiplications including the table of odd powers:
+//
+inline unsigned montgomery_window_bits(unsigned bits) BOOST_NOEXCEPT
+{
+   return bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 7 ? 2 : 1;
+}
+
+inline bool limb_bit_test(const limb_type* p, unsigned index) BOOST_NOEXCEPT
+{
+   return (p[index / bits_per_limb] >> (index % bits_per_limb)) & 1u;
+}
+
+//
+// A Montgomery context holds a positive odd modulus m along with the values which are precomputed from it:
+// R mod m, R^2 mod m and -m^-1 mod R where R = B^n and n is the number of limbs in m.
+// Values in "Montgomery form" are stored as x * R mod m, and the product of two such values is obtained
+// with a single multiplication plus a reduction which requires no division.
+//
+// The context may be reused for any number of operations with the same modulus, and since all the
+// member functions are const and use their own workspace, it may be shared between threads.
+//
+template <class CppInt>
+class montgomery_context
+{
+public:
+   typedef CppInt backend_type;
+
+   montgomery_context() : m_size(0) {}
+   explicit montgomery_context(const CppInt& m)
+   {
+      assign(m);
+   }
+   template <expression_template_option ExpressionTemplates>
+   explicit montgomery_context(const number<CppInt, ExpressionTemplates>& m)
+   {
+      assign(m.backend());
+   }
+
+   void assign(const CppInt& m)
+   {
+      using default_ops::eval_get_sign;
+      using default_ops::eval_left_shift;
+      using default_ops::eval_modulus;
+      using default_ops::eval_bit_test;
+
+      if((eval_get_sign(m) <= 0) || !eval_bit_test(m, 0) || ((m.size() == 1) && (*m.limbs() == 1)))
+         BOOST_THROW_EXCEPTION(std::domain_error("The modulus of a Montgomery context must be odd and greater than one."));
+      m_modulus = m;
+      m_size = m.size();
+      m_limbs.assign(4 * m_size, 0);
+      std::memcpy(&m_limbs[0], m.limbs(), m_size * sizeof(limb_type));
+      //
+      // R mod m, R^2 mod m and -m^-1 mod R are calculated once, using arbitrary precision temporaries
+      // so that this works for fixed precision types too:
+      //
+      cpp_int_backend<> big_m, t, r;
+      assign_limbs(big_m, m.limbs(), m_size, 0, m_size);
+      t = static_cast<limb_type>(1u);
+      eval_left_shift(t, static_cast<double_limb_type>(m_size) * bits_per_limb);
+      eval_modulus(r, t, big_m);
+      std::memcpy(&m_limbs[m_size], r.limbs(), r.size() * sizeof(limb_type));
+      t = static_cast<limb_type>(1u);
+      eval_left_shift(t, 2 * static_cast<double_limb_type>(m_size) * bits_per_limb);
+      eval_modulus(r, t, big_m);
+      std::memcpy(&m_limbs[2 * m_size], r.limbs(), r.size() * sizeof(limb_type));
+      //
+      // If z = -m^-1 mod B^k then z * (2 + m * z) = -m^-1 mod B^2k:
+      //
+      limb_type z = montgomery_inverse(*m.limbs());
+      r = z;
+      for(unsigned k = 2; k < 2 * m_size; k *= 2)
+      {
+         eval_multiply(t, big_m, r);
+         eval_add(t, static_cast<limb_type>(2u));
+         truncate_limbs(t, k);
+         eval_multiply(r, t);
+         truncate_limbs(r, k);
+      }
+      truncate_limbs(r, m_size);
+      std::memcpy(&m_limbs[3 * m_size], r.limbs(), r.size() * sizeof(limb_type));
+   }
+
+   const CppInt& modulus()const BOOST_NOEXCEPT { return m_modulus; }
+   unsigned size()const BOOST_NOEXCEPT { return m_size; }
+   //
+   // Conversion to and from Montgomery form, a must be non-negative but need not be reduced:
+   //
+   void to_montgomery(CppInt& result, const CppInt& a)const
+   {
+      detail::scratch_vector storage(m_size + montgomery_storage_size(m_size));
+      load(&storage[0], a);
+      montgomery_multiply(&storage[0], &storage[0], r2(), mod(), inv(), m_size, &storage[m_size]);
+      assign_limbs(result, &storage[0], m_size, 0, m_size);
+   }
+   void from_montgomery(CppInt& result, const CppInt& a)const
+   {
+      detail::scratch_vector storage(2 * m_size);
+      load(&storage[0], a);
+      montgomery_reduce(&storage[0], &storage[0], mod(), m_size, *inv());
+      assign_limbs(result, &storage[0], m_size, 0, m_size);
+   }
+   //
+   // The interface shared with barrett_context, used by cpp_mod_int_backend:
+   //
+   void encode(CppInt& result, const CppInt& a)const
+   {
+      to_montgomery(result, a);
+   }
+   void decode(CppInt& result, const CppInt& a)const
+   {
+      from_montgomery(result, a);
+   }
+   //
+   // Product of two values in Montgomery form, both must be less than the modulus:
+   //
+   void multiply(CppInt& result, const CppInt& a, const CppInt& b)const
+   {
+      detail::scratch_vector storage(2 * m_size + montgomery_storage_size(m_size));
+      copy_reduced(&storage[0], a);
+      copy_reduced(&storage[m_size], b);
+      montgomery_multiply(&storage[0], &storage[0], &a == &b ? &storage[0] : &storage[m_size], mod(), inv(), m_size, &storage[2 * m_size]);
+      assign_limbs(result, &storage[0], m_size, 0, m_size);
+   }
+   //
+   // (a^p) % m where a and p are ordinary (not Montgomery form) non-negative values:
+   //
+   void powm(CppInt& result, const CppInt& a, const CppInt& p)const
+   {
+      using default_ops::eval_get_sign;
+      if(eval_get_sign(p) < 0)
+         BOOST_THROW_EXCEPTION(std::runtime_error("powm requires a positive exponent."));
+      powm(result, a, p.limbs(), p.size());
+   }
+   void powm(CppInt& result, const CppInt& a, const limb_type* pe, unsigned en)const
+   {
+      using default_ops::eval_get_sign;
+      BOOST_ASSERT(eval_get_sign(a) >= 0);
+      while(en && !pe[en - 1])
+         --en;
+      unsigned bits = en ? (en - 1) * bits_per_limb + boost::multiprecision::detail::find_msb(pe[en - 1]) + 1 : 0;
+      unsigned window = montgomery_window_bits(bits);
+      unsigned n = m_size;
+      //
+      // Workspace is laid out as: accumulator, scratch for montgomery_multiply, then the table of
+      // odd powers a, a^3, a^5 ... a^(2^window - 1), all in Montgomery form:
+      //
+      unsigned table_size = 1u << (window - 1);
+      detail::scratch_vector storage(n + montgomery_storage_size(n) + n * (table_size + 1));
+      limb_type* pacc = &storage[0];
+      limb_type* pscratch = pacc + n;
+      limb_type* ptable = pscratch + montgomery_storage_size(n);
+
+      load(ptable, a);
+      montgomery_multiply(ptable, ptable, r2(), mod(), inv(), n, pscratch);
+      if(table_size > 1)
+      {
+         limb_type* psquare = ptable + n * table_size;
+         montgomery_multiply(psquare, ptable, ptable, mod(), inv(), n, pscratch);
+         for(unsigned i = 1; i < table_size; ++i)
+            montgomery_multiply(ptable + i * n, ptable + (i - 1) * n, psquare, mod(), inv(), n, pscratch);
+      }
+      //
+      // Left to right sliding window exponentiation:
+      //
+      std::memcpy(pacc, one(), n * sizeof(limb_type));
+      bool started = false;
+      int i = static_cast<int>(bits) - 1;
+      while(i >= 0)
+      {
+         if(!limb_bit_test(pe, i))
+         {
+            if(started)
+               montgomery_multiply(pacc, pacc, pacc, mod(), inv(), n, pscratch);
+            --i;
+            continue;
+         }
+         //
+         // Find the longest window [j, i] which ends in a set bit:
+         //
+         int j = (std::max)(i - static_cast<int>(window) + 1, 0);
+         while(!limb_bit_test(pe, j))
+            ++j;
+         unsigned value = 0;
+         for(int k = i; k >= j; --k)
+         {
+            value <<= 1;
+            value |= limb_bit_test(pe, k) ? 1u : 0u;
+            if(started)
+               montgomery_multiply(pacc, pacc, pacc, mod(), inv(), n, pscratch);
+         }
+         if(started)
+            montgomery_multiply(pacc, pacc, ptable + (value >> 1) * n, mod(), inv(), n, pscratch);
+         else
+            std::memcpy(pacc, ptable + (value >> 1) * n, n * sizeof(limb_type));
+         started = true;
+         i = j - 1;
+      }
+      std::memset(pscratch, 0, 2 * n * sizeof(limb_type));
+      std::memcpy(pscratch, pacc, n * sizeof(limb_type));
+      montgomery_reduce(pacc, pscratch, mod(), n, *inv());
+      assign_limbs(result, pacc, n, 0, n);
+   }
+   template <expression_template_option ExpressionTemplates>
+   number<CppInt, ExpressionTemplates> powm(const number<CppInt, ExpressionTemplates>& a, const number<CppInt, ExpressionTemplates>& p)const
+   {
+      number<CppInt, ExpressionTemplates> result;
+      powm(result.backend(), a.backend(), p.backend());
+      return result;
+   }
+
+private:
+   const limb_type* mod()const BOOST_NOEXCEPT { return &m_limbs[0]; }
+   const limb_type* one()const BOOST_NOEXCEPT { return &m_limbs[m_size]; }
+   const limb_type* r2()const BOOST_NOEXCEPT { return &m_limbs[2 * m_size]; }
+   const limb_type* inv()const BOOST_NOEXCEPT { return &m_limbs[3 * m_size]; }
+   //
+   // Copies a % m into p[0, n), any unused limbs are zeroed:
+   //
+   void load(limb_type* p, const CppInt& a)const
+   {
+      using default_ops::eval_modulus;
+      if(a.size() > m_size)
+      {
+         CppInt t;
+         eval_modulus(t, a, m_modulus);
+         load(p, t);
+         return;
+      }
+      std::memset(p, 0, m_size * sizeof(limb_type));
+      std::memcpy(p, a.limbs(), a.size() * sizeof(limb_type));
+      if(compare_limbs(p, mod(), m_size) >= 0)
+      {
+         CppInt t;
+         eval_modulus(t, a, m_modulus);
+         load(p, t);
+      }
+   }
+   static void truncate_limbs(cpp_int_backend<>& r, unsigned n)
+   {
+      if(r.size() > n)
+      {
+         r.resize(n, n);
+         r.normalize();
+      }
+   }
+   void copy_reduced(limb_type* p, const CppInt& a)const
+   {
+      BOOST_ASSERT(a.size() <= m_size);
+      std::memset(p, 0, m_size * sizeof(limb_type));
+      std::memcpy(p, a.limbs(), a.size() * sizeof(limb_type));
+   }
+
+   CppInt m_modulus;
+   unsigned m_size;
+   std::vector<limb_type> m_limbs;  // m, R mod m, R^2 mod m and -m^-1 mod R, each m_size limbs.
+};
+
+//
+// powm for cpp_int uses Montgomery multiplication whenever the modulus is odd, and the other
+// arguments are in range, otherwise we fall back on the generic version:
+//
+template <class CppInt>
+inline bool use_montgomery_powm(const CppInt& a, const CppInt& c)
+{
+   using default_ops::eval_get_sign;
+   using default_ops::eval_bit_test;
+   return (eval_get_sign(a) >= 0) && (eval_get_sign(c) > 0) && eval_bit_test(c, 0) && ((c.size() > 1) || (*c.limbs() > 1));
+}
+
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::value>::type
+   eval_powm(
+      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& a,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& p,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& c)
+{
+   if(use_montgomery_powm(a, c))
+      montgomery_context<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >(c).powm(result, a, p);
+   else
+      default_ops::eval_powm(result, a, p, c);
+}
+
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1, class Integer>
+inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::value && is_unsigned<Integer>::value>::type
+   eval_powm(
+      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& a,
+      Integer p,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& c)
+{
+   if((sizeof(Integer) <= sizeof(limb_type)) && use_montgomery_powm(a, c))
+   {
+      limb_type e = static_cast<limb_type>(p);
+      montgomery_context<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >(c).powm(result, a, &e, 1);
+   }
+   else
+      default_ops::eval_powm(result, a, p, c);
+}
+
+} // namespace backends
+
+using boost::multiprecision::backends::montgomery_context;
+
+}} // namespaces
+
+#endif
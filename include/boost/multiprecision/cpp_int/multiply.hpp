@@ -62,6 +62,521 @@ inline void resize_for_carry(cpp_int_backend<MinBits1, MaxBits1, SignType1, chec
       result.resize(required, required);
 }
 
+//
+// Subquadratic multiplication for arbitrary precision types.  Once the smaller of the
+// two arguments has at least BOOST_MP_KARATSUBA_CUTOFF limbs we switch from long
+// multiplication to Karatsuba, and once both arguments have at least BOOST_MP_TOOM3_CUTOFF
+// limbs we use Toom-3.  Long multiplication is always used for the base case.
+//
+#ifndef BOOST_MP_KARATSUBA_CUTOFF
+#define BOOST_MP_KARATSUBA_CUTOFF 40
+#endif
+#ifndef BOOST_MP_TOOM3_CUTOFF
+#define BOOST_MP_TOOM3_CUTOFF 200
+#endif
+
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_KARATSUBA_CUTOFF >= 4, "The Karatsuba cutoff must be at least 4 limbs or the recursion will not terminate.");
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_TOOM3_CUTOFF >= BOOST_MP_KARATSUBA_CUTOFF, "The Toom-3 cutoff must not be smaller than the Karatsuba cutoff.");
+
+//
+// Squares of values with fewer than BOOST_MP_SQUARE_CUTOFF limbs use ordinary long multiplication,
+// as the extra pass in the squaring code outweighs the saving for such small values:
+//
+#ifndef BOOST_MP_SQUARE_CUTOFF
+#define BOOST_MP_SQUARE_CUTOFF 8
+#endif
+
+static const unsigned karatsuba_cutoff = BOOST_MP_KARATSUBA_CUTOFF;
+static const unsigned toom3_cutoff = BOOST_MP_TOOM3_CUTOFF;
+static const unsigned square_cutoff = BOOST_MP_SQUARE_CUTOFF;
+
+//
+// Helpers which operate directly on raw limb arrays, all return the carry (or borrow)
+// out of the most significant limb.  pr[0, rn) += pb[0, bn) with rn >= bn:
+//
+inline limb_type add_limbs_inplace(limb_type* pr, unsigned rn, const limb_type* pb, unsigned bn) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(rn >= bn);
+   double_limb_type carry = 0;
+   unsigned i = 0;
+   for(; i < bn; ++i)
+   {
+      carry += static_cast<double_limb_type>(pr[i]) + static_cast<double_limb_type>(pb[i]);
+      pr[i] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+   }
+   for(; carry && (i < rn); ++i)
+   {
+      carry += static_cast<double_limb_type>(pr[i]);
+      pr[i] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+   }
+   return static_cast<limb_type>(carry);
+}
+//
+// pr[0, an) = pa[0, an) + pb[0, bn) with an >= bn:
+//
+inline limb_type add_limbs(limb_type* pr, const limb_type* pa, unsigned an, const limb_type* pb, unsigned bn) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(an >= bn);
+   double_limb_type carry = 0;
+   unsigned i = 0;
+   for(; i < bn; ++i)
+   {
+      carry += static_cast<double_limb_type>(pa[i]) + static_cast<double_limb_type>(pb[i]);
+      pr[i] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+   }
+   for(; i < an; ++i)
+   {
+      carry += static_cast<double_limb_type>(pa[i]);
+      pr[i] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+   }
+   return static_cast<limb_type>(carry);
+}
+//
+// pr[0, rn) -= pb[0, bn) with rn >= bn:
+//
+inline limb_type subtract_limbs_inplace(limb_type* pr, unsigned rn, const limb_type* pb, unsigned bn) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(rn >= bn);
+   limb_type borrow = 0;
+   unsigned i = 0;
+   for(; i < bn; ++i)
+   {
+      limb_type a = pr[i];
+      limb_type d = a - pb[i];
+      limb_type b = d > a;
+      pr[i] = d - borrow;
+      borrow = b | (pr[i] > d);
+   }
+   for(; borrow && (i < rn); ++i)
+   {
+      borrow = pr[i] == 0;
+      --pr[i];
+   }
+   return borrow;
+}
+//
+// Long multiplication pr[0, as + bs) = pa[0, as) * pb[0, bs), pr may not overlap either argument:
+//
+inline void multiply_schoolbook(limb_type* pr, const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs) BOOST_NOEXCEPT
+{
+   std::memset(pr, 0, (as + bs) * sizeof(limb_type));
+   for(unsigned i = 0; i < as; ++i)
+   {
+      double_limb_type carry = 0;
+      for(unsigned j = 0; j < bs; ++j)
+      {
+         carry += static_cast<double_limb_type>(pa[i]) * static_cast<double_limb_type>(pb[j]);
+         carry += pr[i + j];
+         pr[i + j] = static_cast<limb_type>(carry);
+         carry >>= bits_per_limb;
+      }
+      pr[i + bs] = static_cast<limb_type>(carry);
+   }
+}
+//
+// Long squaring pr[0, 2n) = pa[0, n)^2, pr may not overlap the argument.  Each cross product
+// pa[i] * pa[j] with i != j occurs twice in the square, so we form each one just once, double
+// the sum and then add in the squares of the individual limbs, which roughly halves the work:
+//
+inline void square_schoolbook(limb_type* pr, const limb_type* pa, unsigned n) BOOST_NOEXCEPT
+{
+   std::memset(pr, 0, 2 * n * sizeof(limb_type));
+   for(unsigned i = 0; i + 1 < n; ++i)
+   {
+      double_limb_type carry = 0;
+      for(unsigned j = i + 1; j < n; ++j)
+      {
+         carry += static_cast<double_limb_type>(pa[i]) * static_cast<double_limb_type>(pa[j]);
+         carry += pr[i + j];
+         pr[i + j] = static_cast<limb_type>(carry);
+         carry >>= bits_per_limb;
+      }
+      pr[i + n] = static_cast<limb_type>(carry);
+   }
+   limb_type shifted_out = 0;
+   double_limb_type carry = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      double_limb_type d = static_cast<double_limb_type>(pa[i]) * static_cast<double_limb_type>(pa[i]);
+      limb_type lo = pr[2 * i];
+      limb_type hi = pr[2 * i + 1];
+      carry += static_cast<double_limb_type>((lo << 1) | shifted_out) + static_cast<limb_type>(d);
+      pr[2 * i] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+      carry += static_cast<double_limb_type>((hi << 1) | (lo >> (bits_per_limb - 1))) + static_cast<limb_type>(d >> bits_per_limb);
+      pr[2 * i + 1] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+      shifted_out = hi >> (bits_per_limb - 1);
+   }
+   BOOST_ASSERT(!carry && !shifted_out);
+}
+//
+// Returns the number of limbs of scratch storage required by multiply_karatsuba
+// when multiplying two n-limb values:
+//
+inline unsigned karatsuba_storage_size(unsigned n) BOOST_NOEXCEPT
+{
+   unsigned result = 0;
+   while(n >= karatsuba_cutoff)
+   {
+      unsigned h = n - n / 2;
+      result += 4 * (h + 1);
+      n = h + 1;
+   }
+   return result;
+}
+//
+// Karatsuba multiplication of two n-limb values, pr[0, 2n) = pa[0, n) * pb[0, n).
+// We split each argument at l = n / 2 limbs so that a = a1 * B^l + a0, and then:
+//
+// a * b = a1 * b1 * B^2l + ((a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1) * B^l + a0 * b0
+//
+// The outer products are written straight into the result, and the middle product
+// and the sums are placed in "storage" which must be karatsuba_storage_size(n) limbs long:
+//
+inline void multiply_karatsuba(limb_type* pr, const limb_type* pa, const limb_type* pb, unsigned n, limb_type* storage) BOOST_NOEXCEPT
+{
+   if(n < karatsuba_cutoff)
+   {
+      multiply_schoolbook(pr, pa, n, pb, n);
+      return;
+   }
+   unsigned l = n / 2;
+   unsigned h = n - l;
+   multiply_karatsuba(pr, pa, pb, l, storage);
+   multiply_karatsuba(pr + 2 * l, pa + l, pb + l, h, storage);
+
+   limb_type* psa = storage;
+   limb_type* psb = psa + h + 1;
+   limb_type* pm = psb + h + 1;
+   psa[h] = add_limbs(psa, pa + l, h, pa, l);
+   psb[h] = add_limbs(psb, pb + l, h, pb, l);
+   multiply_karatsuba(pm, psa, psb, h + 1, pm + 2 * (h + 1));
+   subtract_limbs_inplace(pm, 2 * (h + 1), pr, 2 * l);
+   subtract_limbs_inplace(pm, 2 * (h + 1), pr + 2 * l, 2 * h);
+   //
+   // The middle term is less than 2 * B^n so any high limbs beyond the end
+   // of the result are necessarily zero:
+   //
+   add_limbs_inplace(pr + l, 2 * n - l, pm, (std::min)(2 * (h + 1), 2 * n - l));
+}
+//
+// Karatsuba squaring, pr[0, 2n) = pa[0, n)^2, with the middle term formed as (a0 + a1)^2 - a0^2 - a1^2.
+// "storage" must be karatsuba_storage_size(n) limbs long:
+//
+inline void square_karatsuba(limb_type* pr, const limb_type* pa, unsigned n, limb_type* storage) BOOST_NOEXCEPT
+{
+   if(n < karatsuba_cutoff)
+   {
+      square_schoolbook(pr, pa, n);
+      return;
+   }
+   unsigned l = n / 2;
+   unsigned h = n - l;
+   square_karatsuba(pr, pa, l, storage);
+   square_karatsuba(pr + 2 * l, pa + l, h, storage);
+
+   limb_type* psa = storage;
+   limb_type* pm = psa + 2 * (h + 1);
+   psa[h] = add_limbs(psa, pa + l, h, pa, l);
+   square_karatsuba(pm, psa, h + 1, pm + 2 * (h + 1));
+   subtract_limbs_inplace(pm, 2 * (h + 1), pr, 2 * l);
+   subtract_limbs_inplace(pm, 2 * (h + 1), pr + 2 * l, 2 * h);
+   add_limbs_inplace(pr + l, 2 * n - l, pm, (std::min)(2 * (h + 1), 2 * n - l));
+}
+//
+// Scratch storage required by multiply_karatsuba_unbalanced:
+//
+inline unsigned karatsuba_unbalanced_storage_size(unsigned as, unsigned bs) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(as >= bs);
+   if(bs < karatsuba_cutoff)
+      return 0;
+   if(as == bs)
+      return karatsuba_storage_size(bs);
+   unsigned result = karatsuba_storage_size(bs);
+   if(as % bs)
+      result = (std::max)(result, karatsuba_unbalanced_storage_size(bs, as % bs));
+   return result + 2 * bs;
+}
+//
+// pr[0, as + bs) = pa[0, as) * pb[0, bs) where as >= bs.  The longer argument is
+// chopped into bs-limb blocks, each of which is multiplied via Karatsuba and then
+// accumulated into the result:
+//
+inline void multiply_karatsuba_unbalanced(limb_type* pr, const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs, limb_type* storage) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(as >= bs);
+   if(bs < karatsuba_cutoff)
+   {
+      multiply_schoolbook(pr, pa, as, pb, bs);
+      return;
+   }
+   if(as == bs)
+   {
+      multiply_karatsuba(pr, pa, pb, bs, storage);
+      return;
+   }
+   limb_type* pt = storage;
+   storage += 2 * bs;
+   std::memset(pr, 0, (as + bs) * sizeof(limb_type));
+   for(unsigned i = 0; i < as; i += bs)
+   {
+      unsigned n = (std::min)(bs, as - i);
+      if(n == bs)
+         multiply_karatsuba(pt, pa + i, pb, bs, storage);
+      else
+         multiply_karatsuba_unbalanced(pt, pb, bs, pa + i, n, storage);
+      add_limbs_inplace(pr + i, as + bs - i, pt, n + bs);
+   }
+}
+//
+// Sets r to the unsigned value held in p[offset, offset + count) clipped to p[0, n):
+//
+template <class CppInt>
+inline void assign_limbs(CppInt& r, const limb_type* p, unsigned n, unsigned offset, unsigned count)
+{
+   if(offset >= n)
+   {
+      r = static_cast<limb_type>(0u);
+      return;
+   }
+   count = (std::min)(count, n - offset);
+   r.resize(count, count);
+   std::memcpy(r.limbs(), p + offset, count * sizeof(limb_type));
+   r.sign(false);
+   r.normalize();
+}
+//
+// Multiplies or divides a signed value by 2, note that we can't use the shift operators
+// directly on negative values as checked types regard that as an error:
+//
+template <class CppInt>
+inline void toom3_double(CppInt& r)
+{
+   bool s = r.sign();
+   r.sign(false);
+   eval_left_shift(r, static_cast<double_limb_type>(1u));
+   r.sign(s);
+}
+template <class CppInt>
+inline void toom3_halve(CppInt& r)
+{
+   bool s = r.sign();
+   r.sign(false);
+   eval_right_shift(r, static_cast<double_limb_type>(1u));
+   r.sign(s);
+}
+//
+// Toom-3 multiplication: each argument is split into 3 pieces of k limbs, treated as a
+// polynomial in x = B^k and evaluated at 0, 1, -1, -2 and infinity.  The 5 point-wise
+// products are formed by (recursive) calls to eval_multiply, and the product polynomial
+// is recovered using Bodrato's interpolation sequence.  The temporaries take their
+// storage from the scratch pool:
+//
+template <class CppInt>
+void multiply_toom3(CppInt& result, const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs)
+{
+   //
+   // When squaring we evaluate just the one polynomial, and the point-wise products are squares too:
+   //
+   typedef typename detail::scratch_type<CppInt>::type scratch_type;
+   bool square = (pa == pb) && (as == bs);
+   unsigned k = ((std::max)(as, bs) + 2) / 3;
+   scratch_type a0, a1, a2, b0, b1, b2, t;
+   assign_limbs(a0, pa, as, 0, k);
+   assign_limbs(a1, pa, as, k, k);
+   assign_limbs(a2, pa, as, 2 * k, k);
+   //
+   // Evaluation, p(-2) is computed as 2 * (p(-1) + a2) - a0:
+   //
+   scratch_type p1, pm1, pm2, q1, qm1, qm2;
+   eval_add(t, a0, a2);
+   eval_add(p1, t, a1);
+   eval_subtract(pm1, t, a1);
+   eval_add(pm2, pm1, a2);
+   toom3_double(pm2);
+   eval_subtract(pm2, a0);
+   if(!square)
+   {
+      assign_limbs(b0, pb, bs, 0, k);
+      assign_limbs(b1, pb, bs, k, k);
+      assign_limbs(b2, pb, bs, 2 * k, k);
+      eval_add(t, b0, b2);
+      eval_add(q1, t, b1);
+      eval_subtract(qm1, t, b1);
+      eval_add(qm2, qm1, b2);
+      toom3_double(qm2);
+      eval_subtract(qm2, b0);
+   }
+   //
+   // Point-wise multiplication, we reuse the evaluation temporaries for the results:
+   //
+   scratch_type r0, rinf;
+   eval_multiply(r0, a0, square ? a0 : b0);
+   eval_multiply(rinf, a2, square ? a2 : b2);
+   eval_multiply(t, p1, square ? p1 : q1);
+   p1.swap(t);
+   eval_multiply(t, pm1, square ? pm1 : qm1);
+   pm1.swap(t);
+   eval_multiply(t, pm2, square ? pm2 : qm2);
+   pm2.swap(t);
+   //
+   // Interpolation, on exit p1, pm1 and pm2 hold the coefficients of x, x^2 and x^3.
+   // All the divisions are exact:
+   //
+   eval_subtract(pm2, p1);
+   eval_divide(pm2, static_cast<limb_type>(3u));   // (r(-2) - r(1)) / 3
+   eval_subtract(p1, pm1);
+   toom3_halve(p1);                                 // (r(1) - r(-1)) / 2
+   eval_subtract(pm1, r0);                          // r(-1) - r(0)
+   eval_subtract(pm2, pm1);
+   pm2.negate();
+   toom3_halve(pm2);
+   eval_add(pm2, rinf);
+   eval_add(pm2, rinf);
+   eval_add(pm1, p1);
+   eval_subtract(pm1, rinf);
+   eval_subtract(p1, pm2);
+   BOOST_ASSERT(!p1.sign() && !pm1.sign() && !pm2.sign());
+   //
+   // Recomposition, every coefficient is non-negative so we can just add each one
+   // into the result at the correct offset:
+   //
+   unsigned rs = as + bs;
+   result.resize(rs, rs);
+   limb_type* pr = result.limbs();
+   std::memset(pr, 0, rs * sizeof(limb_type));
+   const scratch_type* coefficients[5] = { &r0, &p1, &pm1, &pm2, &rinf };
+   for(unsigned i = 0; i < 5; ++i)
+   {
+      unsigned offset = i * k;
+      unsigned n = coefficients[i]->size();
+      if(offset >= rs)
+         break;
+      //
+      // Any limbs that would fall beyond the end of the result must be zero:
+      //
+      while(n + offset > rs)
+      {
+         BOOST_ASSERT(coefficients[i]->limbs()[n - 1] == 0);
+         --n;
+      }
+      add_limbs_inplace(pr + offset, rs - offset, coefficients[i]->limbs(), n);
+   }
+   result.normalize();
+}
+//
+// Dispatches to Karatsuba or Toom-3 multiplication, returns false if the arguments
+// are unsuitable in which case the caller must fall back on long multiplication:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+inline bool eval_multiply_subquadratic(cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>&, const limb_type*, unsigned, const limb_type*, unsigned, const mpl::false_&)
+{
+   // Fixed precision types always use long multiplication:
+   return false;
+}
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+bool eval_multiply_subquadratic(cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result, const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs, const mpl::true_&)
+{
+   typedef cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> result_type;
+   if(as < bs)
+   {
+      std::swap(pa, pb);
+      std::swap(as, bs);
+   }
+   if((max_precision<result_type>::value == UINT_MAX) && (bs >= toom3_cutoff) && (2 * bs > as))
+   {
+      multiply_toom3(result, pa, as, pb, bs);
+      return true;
+   }
+   result.resize(as + bs, as + bs - 1);
+   if(result.size() != as + bs)
+      return false;  // Result is truncated, let long multiplication handle that case
+   boost::multiprecision::detail::scratch_allocator<limb_type> alloc;
+   unsigned n = karatsuba_unbalanced_storage_size(as, bs);
+   limb_type* storage = alloc.allocate(n);
+   multiply_karatsuba_unbalanced(result.limbs(), pa, as, pb, bs, storage);
+   alloc.deallocate(storage, n);
+   result.normalize();
+   return true;
+}
+
+//
+// Squaring, again Toom-3 and Karatsuba are only used for arbitrary precision types:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+inline bool eval_square_subquadratic(cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>&, const limb_type*, unsigned, const mpl::false_&)
+{
+   return false;
+}
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+bool eval_square_subquadratic(cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result, const limb_type* pa, unsigned n, const mpl::true_&)
+{
+   typedef cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> result_type;
+   if((max_precision<result_type>::value == UINT_MAX) && (n >= toom3_cutoff))
+   {
+      multiply_toom3(result, pa, n, pa, n);
+      return true;
+   }
+   result.resize(2 * n, 2 * n - 1);
+   if(result.size() != 2 * n)
+      return false;
+   boost::multiprecision::detail::scratch_allocator<limb_type> alloc;
+   unsigned storage_size = karatsuba_storage_size(n);
+   limb_type* storage = alloc.allocate(storage_size);
+   square_karatsuba(result.limbs(), pa, n, storage);
+   alloc.deallocate(storage, storage_size);
+   result.normalize();
+   return true;
+}
+//
+// Sets result to the square of pa[0, n), which must not overlap the result.  Returns false if the
+// value is too small to benefit, or if the result might be truncated, in which case the caller must
+// fall back on long multiplication so that fixed precision overflow is handled correctly:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+bool eval_square(cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result, const limb_type* pa, unsigned n)
+{
+   typedef cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> result_type;
+   if(n < square_cutoff)
+      return false;
+   if((n >= karatsuba_cutoff) && eval_square_subquadratic(result, pa, n, mpl::bool_<result_type::variable>()))
+      return true;
+   result.resize(2 * n, 2 * n - 1);
+   if(result.size() != 2 * n)
+      return false;
+   square_schoolbook(result.limbs(), pa, n);
+   result.normalize();
+   return true;
+}
+
+//
+// Products of small unchecked fixed precision types which fill the result are formed by the unrolled
+// kernel in fixed_kernels.hpp, returns false if the kernel doesn't apply.  pa and pb must not overlap
+// the result:
+//
+template <class CppInt>
+BOOST_MP_FORCEINLINE bool eval_multiply_fixed(CppInt&, const limb_type*, unsigned, const limb_type*, unsigned, const mpl::false_&) BOOST_NOEXCEPT
+{
+   return false;
+}
+template <class CppInt>
+BOOST_MP_FORCEINLINE bool eval_multiply_fixed(CppInt& result, const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs, const mpl::true_&) BOOST_NOEXCEPT
+{
+   if(as + bs <= CppInt::internal_limb_count)
+      return false;
+   result.resize(CppInt::internal_limb_count, CppInt::internal_limb_count);
+   std::memset(result.limbs(), 0, CppInt::internal_limb_count * sizeof(limb_type));
+   fixed_multiply<0, CppInt::internal_limb_count>::apply(result.limbs(), pa, as, pb, bs);
+   result.normalize();
+   return true;
+}
+
 template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1, unsigned MinBits2, unsigned MaxBits2, cpp_integer_type SignType2, cpp_int_check_type Checked2, class Allocator2, unsigned MinBits3, unsigned MaxBits3, cpp_integer_type SignType3, cpp_int_check_type Checked3, class Allocator3>
 inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::value && !is_trivial_cpp_int<cpp_int_backend<MinBits2, MaxBits2, SignType2, Checked2, Allocator2> >::value && !is_trivial_cpp_int<cpp_int_backend<MinBits3, MaxBits3, SignType3, Checked3, Allocator3> >::value >::type
    eval_multiply(
@@ -102,19 +617,50 @@ inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBit
       return;
    }
 
+   if((pa == pb) && (as == bs))
+   {
+      //
+      // a and b are the same object, so use the squaring code:
+      //
+      if((void*)&result == (void*)&a)
+      {
+         typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type t(a);
+         eval_multiply(result, t, t);
+         return;
+      }
+      if(eval_square(result, pa, as))
+      {
+         result.sign(false);
+         return;
+      }
+   }
+
    if((void*)&result == (void*)&a)
    {
-      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> t(a);
+      typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type t(a);
       eval_multiply(result, t, b);
       return;
    }
    if((void*)&result == (void*)&b)
    {
-      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> t(b);
+      typename detail::scratch_type<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::type t(b);
       eval_multiply(result, a, t);
       return;
    }
 
+   if(((std::min)(as, bs) >= karatsuba_cutoff)
+      && eval_multiply_subquadratic(result, pa, as, pb, bs, mpl::bool_<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>::variable>()))
+   {
+      result.sign(a.sign() != b.sign());
+      return;
+   }
+
+   if(eval_multiply_fixed(result, pa, as, pb, bs, is_fixed_kernel_cpp_int<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>, cpp_int_backend<MinBits2, MaxBits2, SignType2, Checked2, Allocator2>, cpp_int_backend<MinBits3, MaxBits3, SignType3, Checked3, Allocator3> >()))
+   {
+      result.sign(a.sign() != b.sign());
+      return;
+   }
+
    result.resize(as + bs, as + bs - 1);
    typename cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>::limb_pointer pr = result.limbs();
 
@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+#ifndef BOOST_MP_CPP_MOD_INT_HPP
+#define BOOST_MP_CPP_MOD_INT_HPP
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace boost{
+namespace multiprecision{
+namespace backends{
+
+//
+// An integer modulo m, where m is held in a shared context object: either a montgomery_context
+// or a barrett_context.  Values which are bound to a context are always stored fully reduced, in
+// whatever representation the context uses, so that chains of arithmetic never need a division.
+//
+// Values which are not bound to a context (for example those created from a built in integer
+// by the expression template machinery) are plain integers, and are reduced into the context
+// of the other argument the first time they are combined with a bound value.
+//
+// The context must outlive all the values which are bound to it.
+//
+template <class Context>
+class cpp_mod_int_backend
+{
+public:
+   typedef Context                                    context_type;
+   typedef typename Context::backend_type             int_backend_type;
+   typedef typename int_backend_type::signed_types    signed_types;
+   typedef typename int_backend_type::unsigned_types  unsigned_types;
+   typedef typename int_backend_type::float_types     float_types;
+
+   cpp_mod_int_backend() : m_context(0) {}
+   explicit cpp_mod_int_backend(const Context& ctx) : m_context(&ctx) {}
+   //
+   // Conversion from the underlying integer type gives an unbound value, we use a template here
+   // so that types which are merely convertible to the integer type are not also convertible to us:
+   //
+   template <class V>
+   cpp_mod_int_backend(const V& v, typename enable_if<is_same<V, int_backend_type> >::type* = 0) : m_context(0), m_value(v) {}
+   cpp_mod_int_backend(const int_backend_type& v, const Context& ctx) : m_context(&ctx)
+   {
+      encode(ctx, m_value, v);
+   }
+   //
+   // Assignment of an integer keeps the existing context (if any):
+   //
+   cpp_mod_int_backend& operator = (const int_backend_type& v)
+   {
+      if(m_context)
+         encode(*m_context, m_value, v);
+      else
+         m_value = v;
+      return *this;
+   }
+   template <class V>
+   typename enable_if_c<is_arithmetic<V>::value, cpp_mod_int_backend&>::type operator = (V v)
+   {
+      int_backend_type t;
+      t = v;
+      return *this = t;
+   }
+   cpp_mod_int_backend& operator = (const char* s)
+   {
+      int_backend_type t;
+      t = s;
+      return *this = t;
+   }
+   void swap(cpp_mod_int_backend& o)
+   {
+      std::swap(m_context, o.m_context);
+      m_value.swap(o.m_value);
+   }
+   std::string str(std::streamsize digits, std::ios_base::fmtflags f)const
+   {
+      int_backend_type t;
+      residue(t);
+      return t.str(digits, f);
+   }
+   void negate()
+   {
+      using default_ops::eval_is_zero;
+      using default_ops::eval_subtract;
+      if(!m_context)
+         m_value.negate();
+      else if(!eval_is_zero(m_value))
+         eval_subtract(m_value, m_context->modulus(), m_value);
+   }
+   int compare(const cpp_mod_int_backend& o)const
+   {
+      int_backend_type a, b;
+      residue(a);
+      o.residue(b);
+      return a.compare(b);
+   }
+   template <class Arithmetic>
+   typename enable_if_c<is_arithmetic<Arithmetic>::value, int>::type compare(Arithmetic i)const
+   {
+      int_backend_type a;
+      residue(a);
+      return a.compare(i);
+   }
+
+   //
+   // Binds this value to ctx, reducing it if it's not already bound to a context with the same modulus:
+   //
+   void bind(const Context& ctx)
+   {
+      if(m_context == &ctx)
+         return;
+      int_backend_type t;
+      residue(t);
+      m_context = &ctx;
+      encode(ctx, m_value, t);
+   }
+   //
+   // Sets r to the value in [0, m) (or to the plain integer value when not bound to a context):
+   //
+   void residue(int_backend_type& r)const
+   {
+      if(m_context)
+         m_context->decode(r, m_value);
+      else
+         r = m_value;
+   }
+
+   const Context* context()const BOOST_NOEXCEPT { return m_context; }
+   void context(const Context* ctx) BOOST_NOEXCEPT { m_context = ctx; }
+   //
+   // The internal representation, which depends on the type of context:
+   //
+   int_backend_type& data() BOOST_NOEXCEPT { return m_value; }
+   const int_backend_type& data()const BOOST_NOEXCEPT { return m_value; }
+
+   //
+   // Reduces an arbitrary integer into the representation used by ctx:
+   //
+   static void encode(const Context& ctx, int_backend_type& result, const int_backend_type& v)
+   {
+      using default_ops::eval_get_sign;
+      using default_ops::eval_is_zero;
+      using default_ops::eval_subtract;
+      if(eval_get_sign(v) < 0)
+      {
+         int_backend_type t(v);
+         t.negate();
+         ctx.encode(result, t);
+         if(!eval_is_zero(result))
+            eval_subtract(result, ctx.modulus(), result);
+      }
+      else
+         ctx.encode(result, v);
+   }
+private:
+   const Context* m_context;
+   int_backend_type m_value;
+};
+
+//
+// Returns the context which the result of an operation on a and b is bound to, or null if neither
+// argument is bound:
+//
+template <class Context>
+inline const Context* common_context(const cpp_mod_int_backend<Context>& a, const cpp_mod_int_backend<Context>& b)
+{
+   if(!a.context())
+      return b.context();
+   if(b.context() && (b.context() != a.context()) && (a.context()->modulus().compare(b.context()->modulus()) != 0))
+      BOOST_THROW_EXCEPTION(std::runtime_error("Modular arithmetic on values with different moduli."));
+   return a.context();
+}
+//
+// Returns a reference to the internal representation of a within ctx, using t as storage if a is not
+// already bound:
+//
+template <class Context>
+inline const typename Context::backend_type& mod_int_operand(const Context& ctx, const cpp_mod_int_backend<Context>& a, typename Context::backend_type& t)
+{
+   if(a.context())
+      return a.data();
+   cpp_mod_int_backend<Context>::encode(ctx, t, a.data());
+   return t;
+}
+
+template <class Context>
+inline void eval_add(cpp_mod_int_backend<Context>& result, const cpp_mod_int_backend<Context>& a, const cpp_mod_int_backend<Context>& b)
+{
+   using default_ops::eval_add;
+   using default_ops::eval_subtract;
+   const Context* ctx = common_context(a, b);
+   if(!ctx)
+   {
+      eval_add(result.data(), a.data(), b.data());
+      result.context(0);
+      return;
+   }
+   typename Context::backend_type ta, tb, d;
+   const typename Context::backend_type& x = mod_int_operand(*ctx, a, ta);
+   const typename Context::backend_type& y = mod_int_operand(*ctx, b, tb);
+   //
+   // Both values are less than m, so we compare x with m - y rather than forming x + y, which
+   // might overflow a fixed precision type:
+   //
+   eval_subtract(d, ctx->modulus(), y);
+   if(x.compare(d) >= 0)
+      eval_subtract(result.data(), x, d);
+   else
+      eval_add(result.data(), x, y);
+   result.context(ctx);
+}
+template <class Context>
+inline void eval_add(cpp_mod_int_backend<Context>& result, const cpp_mod_int_backend<Context>& o)
+{
+   eval_add(result, result, o);
+}
+template <class Context>
+inline void eval_subtract(cpp_mod_int_backend<Context>& result, const cpp_mod_int_backend<Context>& a, const cpp_mod_int_backend<Context>& b)
+{
+   using default_ops::eval_add;
+   using default_ops::eval_subtract;
+   const Context* ctx = common_context(a, b);
+   if(!ctx)
+   {
+      eval_subtract(result.data(), a.data(), b.data());
+      result.context(0);
+      return;
+   }
+   typename Context::backend_type ta, tb, d;
+   const typename Context::backend_type& x = mod_int_operand(*ctx, a, ta);
+   const typename Context::backend_type& y = mod_int_operand(*ctx, b, tb);
+   if(x.compare(y) >= 0)
+      eval_subtract(result.data(), x, y);
+   else
+   {
+      eval_subtract(d, ctx->modulus(), y);
+      eval_add(result.data(), x, d);
+   }
+   result.context(ctx);
+}
+template <class Context>
+inline void eval_subtract(cpp_mod_int_backend<Context>& result, const cpp_mod_int_backend<Context>& o)
+{
+   eval_subtract(result, result, o);
+}
+template <class Context>
+inline void eval_multiply(cpp_mod_int_backend<Context>& result, const cpp_mod_int_backend<Context>& a, const cpp_mod_int_backend<Context>& b)
+{
+   using default_ops::eval_multiply;
+   const Context* ctx = common_context(a, b);
+   if(!ctx)
+   {
+      eval_multiply(result.data(), a.data(), b.data());
+      result.context(0);
+      return;
+   }
+   typename Context::backend_type ta, tb;
+   ctx->multiply(result.data(), mod_int_operand(*ctx, a, ta), mod_int_operand(*ctx, b, tb));
+   result.context(ctx);
+}
+template <class Context>
+inline void eval_multiply(cpp_mod_int_backend<Context>& result, const cpp_mod_int_backend<Context>& o)
+{
+   eval_multiply(result, result, o);
+}
+
+template <class Context>
+inline bool eval_eq(const cpp_mod_int_backend<Context>& a, const cpp_mod_int_backend<Context>& b)
+{
+   //
+   // Values bound to the same context can be compared without converting them out of the internal representation:
+   //
+   if(a.context() && (a.context() == b.context()))
+      return a.data().compare(b.data()) == 0;
+   return a.compare(b) == 0;
+}
+template <class Context>
+inline bool eval_is_zero(const cpp_mod_int_backend<Context>& val)
+{
+   using default_ops::eval_is_zero;
+   return eval_is_zero(val.data());
+}
+template <class Context>
+inline int eval_get_sign(const cpp_mod_int_backend<Context>& val)
+{
+   using default_ops::eval_get_sign;
+   return eval_get_sign(val.data());
+}
+
+template <class R, class Context>
+inline void eval_convert_to(R* result, const cpp_mod_int_backend<Context>& val)
+{
+   using default_ops::eval_convert_to;
+   typename Context::backend_type t;
+   val.residue(t);
+   eval_convert_to(result, t);
+}
+
+} // namespace backends
+
+template <class Context>
+struct expression_template_default<backends::cpp_mod_int_backend<Context> > : public expression_template_default<typename Context::backend_type> {};
+
+template <class Context>
+struct number_category<backends::cpp_mod_int_backend<Context> > : public mpl::int_<number_kind_integer>{};
+
+using boost::multiprecision::backends::cpp_mod_int_backend;
+
+typedef number<cpp_mod_int_backend<montgomery_context<cpp_int_backend<> > > > cpp_montgomery_int;
+typedef number<cpp_mod_int_backend<barrett_context<cpp_int_backend<> > > >    cpp_barrett_int;
+
+//
+// Returns the value of val as an ordinary integer in [0, m):
+//
+template <class Context, expression_template_option ET>
+inline number<typename Context::backend_type, ET> residue(const number<cpp_mod_int_backend<Context>, ET>& val)
+{
+   number<typename Context::backend_type, ET> result;
+   val.backend().residue(result.backend());
+   return result;
+}
+
+}} // namespaces
+
+#endif
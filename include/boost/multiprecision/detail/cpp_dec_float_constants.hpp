@@ -0,0 +1,45 @@
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Binary splitting of the constants, and exact argument reduction, for cpp_dec_float via cpp_int.
+// Included by cpp_dec_float.hpp only when BOOST_MP_CPP_DEC_FLOAT_CPP_INT_CONSTANTS is defined, so that
+// cpp_dec_float doesn't otherwise depend on cpp_int.  As with the other configuration macros, it
+// must be defined (or not) consistently throughout a program.
+//
+
+#ifndef BOOST_MP_DETAIL_CPP_DEC_FLOAT_CONSTANTS_HPP
+#define BOOST_MP_DETAIL_CPP_DEC_FLOAT_CONSTANTS_HPP
+
+#include <string>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace boost{ namespace multiprecision{ namespace default_ops{
+//
+// The conversion goes via a decimal string which is exact and linear in the length for this type:
+//
+template <unsigned Digits10, class ExponentType, class Allocator>
+struct constant_integer<cpp_dec_float<Digits10, ExponentType, Allocator> >
+{
+   typedef backends::cpp_int_backend<> type;
+   static void convert(cpp_dec_float<Digits10, ExponentType, Allocator>& result, const type& i)
+   {
+      result = i.str(0, std::ios_base::fmtflags(0)).c_str();
+   }
+   static void truncate(type& result, const cpp_dec_float<Digits10, ExponentType, Allocator>& f)
+   {
+      cpp_dec_float<Digits10, ExponentType, Allocator> t;
+      eval_trunc(t, f);
+      std::string s = t.str(0, std::ios_base::fixed);
+      std::string::size_type pos = s.find('.');
+      if(pos != std::string::npos)
+         s.erase(pos);
+      result = s.c_str();
+   }
+};
+
+}}} // namespaces
+
+#endif
@@ -14,6 +14,26 @@
 #include <boost/mpl/fold.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/type_traits/make_unsigned.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/distance.hpp>
+#include <boost/range/value_type.hpp>
+#include <boost/range/has_range_iterator.hpp>
+#include <vector>
+#include <iterator>
+#include <cmath>
+
+//
+// When threads are supported, cached constants are published atomically and may be
+// computed concurrently from several threads:
+//
+#if !defined(BOOST_MP_THREAD_SAFE_CONSTANTS) && defined(BOOST_HAS_THREADS) && !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_NO_CXX11_HDR_MUTEX)
+#define BOOST_MP_THREAD_SAFE_CONSTANTS
+#endif
+#ifdef BOOST_MP_THREAD_SAFE_CONSTANTS
+#include <atomic>
+#include <mutex>
+#endif
 
 #ifndef INSTRUMENT_BACKEND
 #ifndef BOOST_MP_INSTRUMENT
@@ -116,6 +136,48 @@ inline typename enable_if_c<!is_same<T, U>::value && is_same<T, V>::value>::type
 {
    eval_multiply_subtract(t, v, u);
 }
+//
+// Adds (or subtracts) the product a*b to the sum_of_products_accumulator acc.  When the accumulator is
+// a different type from the operands we convert them first, back-ends with a wider accumulator should
+// overload this to form the product directly:
+//
+template <class T, class U>
+inline void eval_accumulate_product(T& acc, const U& a, const U& b, bool subtract)
+{
+   T x, y;
+   x = a;
+   y = b;
+   if(subtract)
+      eval_multiply_subtract(acc, x, y);
+   else
+      eval_multiply_add(acc, x, y);
+}
+template <class T>
+inline void eval_accumulate_product(T& acc, const T& a, const T& b, bool subtract)
+{
+   if(subtract)
+      eval_multiply_subtract(acc, a, b);
+   else
+      eval_multiply_add(acc, a, b);
+}
+template <class T, class U>
+inline void eval_accumulate(T& acc, const U& u, bool subtract)
+{
+   T z;
+   z = u;
+   if(subtract)
+      eval_subtract(acc, z);
+   else
+      eval_add(acc, z);
+}
+template <class T>
+inline void eval_accumulate(T& acc, const T& u, bool subtract)
+{
+   if(subtract)
+      eval_subtract(acc, u);
+   else
+      eval_add(acc, u);
+}
 template <class T, class V>
 inline typename enable_if_c<is_convertible<V, number<T, et_on> >::value && !is_convertible<V, T>::value>::type
    eval_divide(T& result, V const& v)
@@ -1203,6 +1265,18 @@ typename enable_if_c<sizeof(T) == 0>::type eval_ldexp();
 template <class T>
 typename enable_if_c<sizeof(T) == 0>::type eval_frexp();
 
+//
+// The default reciprocal square root, backends which can find it directly should overload this:
+//
+template <class T>
+inline void eval_rsqrt(T& result, const T& x)
+{
+   typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
+   T t;
+   eval_sqrt(t, x);
+   eval_divide(result, ui_type(1u), t);
+}
+
 //
 // eval_logb and eval_scalbn simply assume base 2 and forward to
 // eval_ldexp and eval_frexp:
@@ -1233,6 +1307,7 @@ inline void eval_scalbn(B& result, const B& val, A e)
 // DO NOT CHANGE THE ORDER OF THESE INCLUDES:
 //
 #include <boost/multiprecision/detail/functions/constants.hpp>
+#include <boost/multiprecision/detail/functions/series.hpp>
 #include <boost/multiprecision/detail/functions/pow.hpp>
 #include <boost/multiprecision/detail/functions/trig.hpp>
 
@@ -1626,6 +1701,138 @@ frexp(const detail::expression<tag, A1, A2, A3, A4>& v, boost::long_long_type* p
    typedef typename detail::expression<tag, A1, A2, A3, A4>::result_type number_type;
    return BOOST_MP_MOVE(frexp(static_cast<number_type>(v), pint));
 }
+//
+// sincos computes the sine and cosine of the same argument together, sharing the argument reduction
+// and series evaluation between the two:
+//
+template <class T, expression_template_option ExpressionTemplates>
+inline typename enable_if_c<number_category<T>::value == number_kind_floating_point>::type
+   sincos(const number<T, ExpressionTemplates>& x, number<T, ExpressionTemplates>& s, number<T, ExpressionTemplates>& c)
+{
+   using default_ops::eval_sincos;
+   eval_sincos(s.backend(), c.backend(), x.backend());
+}
+template <class tag, class A1, class A2, class A3, class A4>
+inline typename enable_if_c<number_category<typename detail::expression<tag, A1, A2, A3, A4>::result_type>::value == number_kind_floating_point>::type
+   sincos(const detail::expression<tag, A1, A2, A3, A4>& x, typename detail::expression<tag, A1, A2, A3, A4>::result_type& s, typename detail::expression<tag, A1, A2, A3, A4>::result_type& c)
+{
+   typedef typename detail::expression<tag, A1, A2, A3, A4>::result_type number_type;
+   sincos(static_cast<number_type>(x), s, c);
+}
+
+//
+// sum_of_products returns the sum of first1[i] * first2[i] over [first1, last1), accumulated in the
+// back-end's sum_of_products_accumulator so that, for types which provide a wider accumulator, the
+// result is rounded just once:
+//
+template <class Iterator1, class Iterator2>
+inline typename enable_if_c<
+   is_number<typename std::iterator_traits<Iterator1>::value_type>::value
+   && is_same<typename std::iterator_traits<Iterator1>::value_type, typename std::iterator_traits<Iterator2>::value_type>::value,
+   typename std::iterator_traits<Iterator1>::value_type>::type
+   sum_of_products(Iterator1 first1, Iterator1 last1, Iterator2 first2)
+{
+   typedef typename std::iterator_traits<Iterator1>::value_type number_type;
+   typedef typename sum_of_products_accumulator<typename number_type::backend_type>::type accumulator_type;
+   typedef typename mpl::front<typename accumulator_type::unsigned_types>::type ui_type;
+   using default_ops::eval_accumulate_product;
+   accumulator_type acc;
+   acc = static_cast<ui_type>(0u);
+   for(; first1 != last1; ++first1, ++first2)
+      eval_accumulate_product(acc, (*first1).backend(), (*first2).backend(), false);
+   number_type result;
+   result.backend() = acc;
+   return BOOST_MP_MOVE(result);
+}
+
+namespace detail{
+
+template <class Range, bool = boost::has_range_const_iterator<Range>::value>
+struct number_range_value
+{
+   typedef void type;
+};
+template <class Range>
+struct number_range_value<Range, true>
+{
+   typedef typename boost::range_value<Range>::type value_type;
+   typedef typename mpl::if_c<is_number<value_type>::value, value_type, void>::type type;
+};
+
+}
+
+template <class Range1, class Range2>
+inline typename enable_if_c<
+   !is_void<typename detail::number_range_value<Range1>::type>::value
+   && is_same<typename detail::number_range_value<Range1>::type, typename detail::number_range_value<Range2>::type>::value,
+   typename detail::number_range_value<Range1>::type>::type
+   sum_of_products(const Range1& r1, const Range2& r2)
+{
+   BOOST_ASSERT(boost::distance(r1) <= boost::distance(r2));
+   return sum_of_products(boost::begin(r1), boost::end(r1), boost::begin(r2));
+}
+
+//
+// Batch arithmetic: add_n(r, a, b, n) sets r[i] = a[i] + b[i] for i in [0, n) and so on, returning r + n.
+// Each element is evaluated directly by the back-end, with no temporaries, and gives exactly the same result
+// as the scalar expression.  The result may be the same sequence as any of the arguments:
+//
+namespace detail{
+
+template <class OutputIterator, class Iterator1, class Iterator2, class Iterator3 = Iterator1>
+struct batch_result
+{
+   typedef typename std::iterator_traits<OutputIterator>::value_type number_type;
+   static const bool value = is_number<number_type>::value
+      && is_same<number_type, typename std::iterator_traits<Iterator1>::value_type>::value
+      && is_same<number_type, typename std::iterator_traits<Iterator2>::value_type>::value
+      && is_same<number_type, typename std::iterator_traits<Iterator3>::value_type>::value;
+};
+
+}
+
+template <class OutputIterator, class Iterator1, class Iterator2>
+inline typename enable_if_c<detail::batch_result<OutputIterator, Iterator1, Iterator2>::value, OutputIterator>::type
+   add_n(OutputIterator r, Iterator1 a, Iterator2 b, std::size_t n)
+{
+   using default_ops::eval_add;
+   for(; n; --n, ++r, ++a, ++b)
+      eval_add((*r).backend(), (*a).backend(), (*b).backend());
+   return r;
+}
+
+template <class OutputIterator, class Iterator1, class Iterator2>
+inline typename enable_if_c<detail::batch_result<OutputIterator, Iterator1, Iterator2>::value, OutputIterator>::type
+   subtract_n(OutputIterator r, Iterator1 a, Iterator2 b, std::size_t n)
+{
+   using default_ops::eval_subtract;
+   for(; n; --n, ++r, ++a, ++b)
+      eval_subtract((*r).backend(), (*a).backend(), (*b).backend());
+   return r;
+}
+
+template <class OutputIterator, class Iterator1, class Iterator2>
+inline typename enable_if_c<detail::batch_result<OutputIterator, Iterator1, Iterator2>::value, OutputIterator>::type
+   multiply_n(OutputIterator r, Iterator1 a, Iterator2 b, std::size_t n)
+{
+   using default_ops::eval_multiply;
+   for(; n; --n, ++r, ++a, ++b)
+      eval_multiply((*r).backend(), (*a).backend(), (*b).backend());
+   return r;
+}
+
+//
+// r[i] = a[i] * b[i] + c[i], rounded as the expression a[i] * b[i] + c[i] would be:
+//
+template <class OutputIterator, class Iterator1, class Iterator2, class Iterator3>
+inline typename enable_if_c<detail::batch_result<OutputIterator, Iterator1, Iterator2, Iterator3>::value, OutputIterator>::type
+   multiply_add_n(OutputIterator r, Iterator1 a, Iterator2 b, Iterator3 c, std::size_t n)
+{
+   using default_ops::eval_multiply_add;
+   for(; n; --n, ++r, ++a, ++b, ++c)
+      eval_multiply_add((*r).backend(), (*a).backend(), (*b).backend(), (*c).backend());
+   return r;
+}
 
 template <class B, expression_template_option ExpressionTemplates>
 inline typename enable_if_c<number_category<B>::value == number_kind_integer, number<B, ExpressionTemplates> >::type
@@ -2081,6 +2288,7 @@ abs(const number<Backend, et_off>& arg)
 
 UNARY_OP_FUNCTOR(fabs, number_kind_floating_point)
 UNARY_OP_FUNCTOR(sqrt, number_kind_floating_point)
+UNARY_OP_FUNCTOR(rsqrt, number_kind_floating_point)
 UNARY_OP_FUNCTOR(floor, number_kind_floating_point)
 UNARY_OP_FUNCTOR(ceil, number_kind_floating_point)
 UNARY_OP_FUNCTOR(trunc, number_kind_floating_point)
@@ -2146,6 +2354,41 @@ ilogb(const detail::expression<tag, A1, A2, A3, A4>& val)
    return eval_ilogb(arg.backend());
 }
 
+//
+// Computes the cached constants used by the elementary functions of each type, so that
+// later calls never have to wait on them.  Variable precision types are warmed up at the
+// current default precision:
+//
+namespace detail{
+
+template <class Number>
+inline void precompute_constants_imp(const mpl::int_<number_kind_floating_point>&)
+{
+   typedef typename Number::backend_type backend_type;
+   default_ops::get_constant_ln2<backend_type>();
+   default_ops::get_constant_e<backend_type>();
+   default_ops::get_constant_pi<backend_type>();
+   default_ops::get_constant_log10<backend_type>();
+}
+template <class Number, int N>
+inline void precompute_constants_imp(const mpl::int_<N>&){}
+
+}
+
+template <class Number>
+inline void precompute_constants()
+{
+   detail::precompute_constants_imp<Number>(number_category<Number>());
+}
+#ifndef BOOST_NO_CXX11_VARIADIC_TEMPLATES
+template <class Number1, class Number2, class... Numbers>
+inline void precompute_constants()
+{
+   precompute_constants<Number1>();
+   precompute_constants<Number2, Numbers...>();
+}
+#endif
+
 } //namespace multiprecision
 
 namespace math{
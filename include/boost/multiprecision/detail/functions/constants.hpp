@@ -6,12 +6,162 @@
 // This file has no include guards or namespaces - it's expanded inline inside default_ops.hpp
 // 
 
+//
+// The precision in bits at which the constants for type T are required.  Variable precision
+// types specialize this to return their current default precision:
+//
 template <class T>
-void calc_log2(T& num, unsigned digits)
+struct constant_precision
 {
-   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
-   typedef typename mpl::front<typename T::signed_types>::type si_type;
+   static unsigned value()
+   {
+      return boost::multiprecision::detail::digits2<number<T, et_on> >::value;
+   }
+};
+//
+// The integer backend on which the constants for type T are evaluated by binary splitting, along with
+// a conversion from that integer type to T (convert) and back again, discarding any fractional
+// part (truncate).  The default of void means "none available", in which case
+// the constants are computed directly in T with the older, slower methods:
+//
+template <class T>
+struct constant_integer
+{
+   typedef void type;
+};
+
+//
+// Binary splitting evaluation of series whose terms are a(n) * PRODUCT[1 <= j <= n] p(j) / q(j).
+// Series::term sets P = p(n), Q = q(n) and T = a(n) * p(n) for n > 0, and P = Q = 1, T = a(0) for n = 0.
+// On exit the partial sum over [a, b) is T / Q scaled by the product of the p's before a, and P and
+// Q are the products of p and q over [a, b).
+// See Haible, B. and Papanikolaou, T. Fast multiprecision evaluation of series of rational numbers, 1997.
+//
+template <class I, class Series>
+void binary_split(I& P, I& Q, I& T, boost::ulong_long_type a, boost::ulong_long_type b, const Series& s)
+{
+   if(b - a == 1)
+   {
+      s.term(P, Q, T, a);
+      return;
+   }
+   boost::ulong_long_type m = a + (b - a) / 2;
+   I P2, Q2, T2;
+   binary_split(P, Q, T, a, m, s);
+   binary_split(P2, Q2, T2, m, b, s);
+   //
+   // T = T * Q2 + P * T2, P = P * P2, Q = Q * Q2:
+   //
+   eval_multiply(T, Q2);
+   eval_multiply(T2, P);
+   eval_add(T, T2);
+   eval_multiply(P, P2);
+   eval_multiply(Q, Q2);
+}
+
+//
+// Chudnovsky's series for 1/pi, with p(n) = -(6n-5)(2n-1)(6n-1), q(n) = n^3 * 640320^3 / 24
+// and a(n) = 13591409 + 545140134n, each term contributes about 47.11 bits:
+//
+struct chudnovsky_pi_series
+{
+   template <class I>
+   void term(I& P, I& Q, I& T, boost::ulong_long_type n)const
+   {
+      typedef typename mpl::front<typename I::unsigned_types>::type ui_type;
+      if(n == 0)
+      {
+         P = ui_type(1u);
+         Q = ui_type(1u);
+         T = ui_type(13591409uL);
+         return;
+      }
+      P = static_cast<ui_type>(6 * n - 5);
+      eval_multiply(P, static_cast<ui_type>(2 * n - 1));
+      eval_multiply(P, static_cast<ui_type>(6 * n - 1));
+      P.negate();
+      Q = static_cast<ui_type>(n);
+      eval_multiply(Q, static_cast<ui_type>(n));
+      eval_multiply(Q, static_cast<ui_type>(n));
+      eval_multiply(Q, ui_type(26680uL));   // 640320 / 24
+      eval_multiply(Q, ui_type(640320uL));
+      eval_multiply(Q, ui_type(640320uL));
+      T = static_cast<ui_type>(n);
+      eval_multiply(T, ui_type(545140134uL));
+      eval_add(T, ui_type(13591409uL));
+      eval_multiply(T, P);
+   }
+};
+//
+// e = SUM[n>=0] 1/n!
+//
+struct e_series
+{
+   template <class I>
+   void term(I& P, I& Q, I& T, boost::ulong_long_type n)const
+   {
+      typedef typename mpl::front<typename I::unsigned_types>::type ui_type;
+      P = ui_type(1u);
+      Q = static_cast<ui_type>(n ? n : 1u);
+      T = ui_type(1u);
+   }
+};
+//
+// ln(2) = 3/4 SUM[n>=0] ((-1)^n * n!^2 / (2^n * (2n+1)!)), the term ratio is -n / (8n + 4)
+// so each term contributes 3 bits:
+//
+struct log2_series
+{
+   template <class I>
+   void term(I& P, I& Q, I& T, boost::ulong_long_type n)const
+   {
+      typedef typename mpl::front<typename I::unsigned_types>::type ui_type;
+      if(n == 0)
+      {
+         P = ui_type(1u);
+         Q = ui_type(1u);
+         T = ui_type(1u);
+         return;
+      }
+      P = static_cast<ui_type>(n);
+      P.negate();
+      Q = static_cast<ui_type>(8 * n + 4);
+      T = P;
+   }
+};
+
+//
+// Sets result = T / Q for the first n terms of series s:
+//
+template <class Float, class Series>
+void sum_binary_split(Float& result, boost::ulong_long_type n, const Series& s)
+{
+   typedef typename constant_integer<Float>::type integer_type;
+   integer_type P, Q, T;
+   binary_split(P, Q, T, 0, n, s);
+   Float t;
+   constant_integer<Float>::convert(result, T);
+   constant_integer<Float>::convert(t, Q);
+   eval_divide(result, t);
+}
+
+
+template <class T>
+void calc_log2(T& num, unsigned digits, const mpl::true_&);
+template <class T>
+void calc_log2(T& num, unsigned digits, const mpl::false_&);
+template <class T>
+void calc_e(T& result, unsigned digits, const mpl::true_&);
+template <class T>
+void calc_e(T& result, unsigned digits, const mpl::false_&);
+template <class T>
+void calc_pi(T& result, unsigned digits, const mpl::true_&);
+template <class T>
+void calc_pi(T& result, unsigned digits, const mpl::false_&);
 
+template <class T>
+void calc_log2(T& num, unsigned digits)
+{
    //
    // String value with 1100 digits:
    //
@@ -35,10 +185,27 @@ void calc_log2(T& num, unsigned digits)
       num = string_val;
       return;
    }
+   calc_log2(num, digits, mpl::bool_<!is_void<typename constant_integer<T>::type>::value>());
+}
+
+template <class T>
+void calc_log2(T& num, unsigned digits, const mpl::true_&)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
+   sum_binary_split(num, digits / 3 + 2, log2_series());
+   eval_multiply(num, ui_type(3));
+   eval_ldexp(num, num, -2);
+}
+
+template <class T>
+void calc_log2(T& num, unsigned digits, const mpl::false_&)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
+   typedef typename mpl::front<typename T::signed_types>::type si_type;
    //
    // We calculate log2 from using the formula:
    //
-   // ln(2) = 3/4 SUM[n>=0] ((-1)^n * N!^2 / (2^n(2n+1)!))
+   // ln(2) = 3/4 SUM[n>=0] ((-1)^n * n!^2 / (2^n * (2n+1)!))
    //
    // Numerator and denominator are calculated separately and then 
    // divided at the end, we also precalculate the terms up to n = 5
@@ -80,7 +247,6 @@ void calc_log2(T& num, unsigned digits)
 template <class T>
 void calc_e(T& result, unsigned digits)
 {
-   typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
    //
    // 1100 digits in string form:
    //
@@ -104,6 +270,25 @@ void calc_e(T& result, unsigned digits)
       result = string_val;
       return;
    }
+   calc_e(result, digits, mpl::bool_<!is_void<typename constant_integer<T>::type>::value>());
+}
+
+template <class T>
+void calc_e(T& result, unsigned digits, const mpl::true_&)
+{
+   //
+   // Find n such that n! > 2^digits, then e = 1 + SUM[1 <= k < n] 1/k!:
+   //
+   boost::ulong_long_type n = 2;
+   for(double bits = 0; bits <= digits; ++n)
+      bits += std::log(static_cast<double>(n)) / std::log(2.0);
+   sum_binary_split(result, n, e_series());
+}
+
+template <class T>
+void calc_e(T& result, unsigned digits, const mpl::false_&)
+{
+   typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
 
    T lim;
    lim = ui_type(1);
@@ -128,8 +313,6 @@ void calc_e(T& result, unsigned digits)
 template <class T>
 void calc_pi(T& result, unsigned digits)
 {
-   typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
-   typedef typename mpl::front<typename T::float_types>::type real_type;
    //
    // 1100 digits in string form:
    //
@@ -153,6 +336,30 @@ void calc_pi(T& result, unsigned digits)
       result = string_val;
       return;
    }
+   calc_pi(result, digits, mpl::bool_<!is_void<typename constant_integer<T>::type>::value>());
+}
+
+template <class T>
+void calc_pi(T& result, unsigned digits, const mpl::true_&)
+{
+   typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
+   //
+   // Chudnovsky's formula: pi = 426880 * sqrt(10005) / SUM, where the sum is
+   // evaluated by binary splitting:
+   //
+   sum_binary_split(result, digits / 47 + 2, chudnovsky_pi_series());
+   T t;
+   t = ui_type(10005u);
+   eval_sqrt(t, t);
+   eval_multiply(t, ui_type(426880uL));
+   eval_divide(result, t, result);
+}
+
+template <class T>
+void calc_pi(T& result, unsigned digits, const mpl::false_&)
+{
+   typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
+   typedef typename mpl::front<typename T::float_types>::type real_type;
 
    T a;
    a = ui_type(1);
@@ -238,16 +445,102 @@ private:
 template <class T, const T& (*F)(void)>
 typename constant_initializer<T, F>::initializer const constant_initializer<T, F>::init;
 
+//
+// The default way of rounding a cached constant held at src_bits precision to a lower precision:
+// assignment rounds to the precision of the result:
+//
 template <class T>
-const T& get_constant_ln2()
+inline void round_constant(T& result, const T& src, unsigned /*src_bits*/, unsigned /*bits*/)
+{
+   result = src;
+}
+//
+// Cache for a constant of type T computed by F, holding one value for each precision asked for.
+// The first request at a given precision either rounds down the most precise value held using R,
+// or computes a new one if there is none.  Values are never changed or freed once published, so
+// a reference returned by get() remains valid, and when BOOST_MP_THREAD_SAFE_CONSTANTS is defined
+// lookups are lock free and only the first request at each precision takes a lock:
+//
+template <class T, void (*F)(T&, unsigned), void (*R)(T&, const T&, unsigned, unsigned) = &round_constant<T> >
+class constant_cache
 {
-   static T result;
-   static bool b = false;
-   if(!b)
+   struct node
+   {
+      T value;
+      unsigned bits;
+      node* next;
+   };
+public:
+   constant_cache() : m_head(0) {}
+   ~constant_cache()
+   {
+      node* p = head();
+      while(p)
+      {
+         node* n = p->next;
+         delete p;
+         p = n;
+      }
+   }
+   const T& get(unsigned bits)
+   {
+      for(node* p = head(); p; p = p->next)
+      {
+         if(p->bits == bits)
+            return p->value;
+      }
+#ifdef BOOST_MP_THREAD_SAFE_CONSTANTS
+      std::lock_guard<std::mutex> l(m_mutex);
+#endif
+      node* largest = 0;
+      for(node* p = head(); p; p = p->next)
+      {
+         if(p->bits == bits)
+            return p->value;
+         if(!largest || (p->bits > largest->bits))
+            largest = p;
+      }
+      T t;
+      if(largest && (largest->bits > bits))
+         R(t, largest->value, largest->bits, bits);
+      else
+         F(t, bits);
+      node* n = new node;
+      n->value.swap(t);
+      n->bits = bits;
+      n->next = head();
+#ifdef BOOST_MP_THREAD_SAFE_CONSTANTS
+      m_head.store(n, std::memory_order_release);
+#else
+      m_head = n;
+#endif
+      return n->value;
+   }
+private:
+   node* head()const
    {
-      calc_log2(result, boost::multiprecision::detail::digits2<number<T, et_on> >::value);
-      b = true;
+#ifdef BOOST_MP_THREAD_SAFE_CONSTANTS
+      return m_head.load(std::memory_order_acquire);
+#else
+      return m_head;
+#endif
    }
+   constant_cache(const constant_cache&);
+   constant_cache& operator=(const constant_cache&);
+
+#ifdef BOOST_MP_THREAD_SAFE_CONSTANTS
+   std::atomic<node*> m_head;
+   std::mutex m_mutex;
+#else
+   node* m_head;
+#endif
+};
+
+template <class T>
+const T& get_constant_ln2()
+{
+   static constant_cache<T, &calc_log2<T> > cache;
+   const T& result = cache.get(constant_precision<T>::value());
 
    constant_initializer<T, &get_constant_ln2<T> >::do_nothing();
 
@@ -257,13 +550,8 @@ const T& get_constant_ln2()
 template <class T>
 const T& get_constant_e()
 {
-   static T result;
-   static bool b = false;
-   if(!b)
-   {
-      calc_e(result, boost::multiprecision::detail::digits2<number<T, et_on> >::value);
-      b = true;
-   }
+   static constant_cache<T, &calc_e<T> > cache;
+   const T& result = cache.get(constant_precision<T>::value());
 
    constant_initializer<T, &get_constant_e<T> >::do_nothing();
 
@@ -273,16 +561,86 @@ const T& get_constant_e()
 template <class T>
 const T& get_constant_pi()
 {
-   static T result;
-   static bool b = false;
-   if(!b)
-   {
-      calc_pi(result, boost::multiprecision::detail::digits2<number<T, et_on> >::value);
-      b = true;
-   }
+   static constant_cache<T, &calc_pi<T> > cache;
+   const T& result = cache.get(constant_precision<T>::value());
 
    constant_initializer<T, &get_constant_pi<T> >::do_nothing();
 
    return result;
 }
 
+//
+// atan(1/k) = 1/k SUM[n>=0] (-1)^n / ((2n+1)k^2n), the term ratio is -(2n-1) / ((2n+1)k^2):
+//
+struct atan_inverse_series
+{
+   atan_inverse_series(unsigned long k) : m_k(k) {}
+   template <class I>
+   void term(I& P, I& Q, I& T, boost::ulong_long_type n)const
+   {
+      typedef typename mpl::front<typename I::unsigned_types>::type ui_type;
+      if(n == 0)
+      {
+         P = ui_type(1u);
+         Q = ui_type(1u);
+         T = ui_type(1u);
+         return;
+      }
+      P = static_cast<ui_type>(2 * n - 1);
+      P.negate();
+      Q = static_cast<ui_type>(2 * n + 1);
+      eval_multiply(Q, static_cast<ui_type>(m_k));
+      eval_multiply(Q, static_cast<ui_type>(m_k));
+      T = P;
+   }
+private:
+   unsigned long m_k;
+};
+
+//
+// Sets the integer result to floor(2^bits * 2 / pi), to within one unit.  Uses Machin's formula
+// pi = 16 atan(1/5) - 4 atan(1/239) so that pi is obtained as an exact rational and no square roots
+// are needed, atan(1/k) = T / (k * Q) from the binary splitting of each series:
+//
+template <class I>
+void calc_two_over_pi(I& result, unsigned bits)
+{
+   typedef typename mpl::front<typename I::unsigned_types>::type ui_type;
+   I P5, Q5, T5, P239, Q239, T239, t;
+   binary_split(P5, Q5, T5, 0, bits / 4 + 4, atan_inverse_series(5));
+   binary_split(P239, Q239, T239, 0, bits / 15 + 4, atan_inverse_series(239));
+   //
+   // 2/pi = 1195 * 2 * Q5 * Q239 / (3824 * T5 * Q239 - 20 * T239 * Q5):
+   //
+   eval_multiply(t, T5, Q239);
+   eval_multiply(t, ui_type(3824u));
+   eval_multiply(T239, Q5);
+   eval_multiply(T239, ui_type(20u));
+   eval_subtract(t, T239);
+   eval_multiply(result, Q5, Q239);
+   eval_multiply(result, ui_type(1195u));
+   eval_left_shift(result, bits + 1);
+   eval_divide(result, t);
+}
+
+template <class I>
+inline void round_two_over_pi(I& result, const I& src, unsigned src_bits, unsigned bits)
+{
+   eval_right_shift(result, src, src_bits - bits);
+}
+
+//
+// Returns floor(2^bits * 2 / pi) for at least the number of bits asked for, bits is rounded up
+// to a power of 2 so that only a few values are ever cached:
+//
+template <class I>
+const I& get_constant_two_over_pi(unsigned& bits)
+{
+   unsigned b = 256;
+   while(b < bits)
+      b <<= 1;
+   bits = b;
+   static constant_cache<I, &calc_two_over_pi<I>, &round_two_over_pi<I> > cache;
+   return cache.get(bits);
+}
+
@@ -100,42 +100,8 @@ void hyp0F0(T& H0F0, const T& x)
    // http://functions.wolfram.com/HypergeometricFunctions/Hypergeometric0F0/06/01/
    // There are no checks on input range or parameter boundaries.
 
-   typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
-
    BOOST_ASSERT(&H0F0 != &x);
-   long tol = boost::multiprecision::detail::digits2<number<T, et_on> >::value;
-   T t;
-
-   T x_pow_n_div_n_fact(x);
-
-   eval_add(H0F0, x_pow_n_div_n_fact, ui_type(1));
-
-   T lim;
-   eval_ldexp(lim, H0F0, 1 - tol);
-   if(eval_get_sign(lim) < 0)
-      lim.negate();
-
-   ui_type n;
-
-   static const unsigned series_limit = 
-      boost::multiprecision::detail::digits2<number<T, et_on> >::value < 100
-      ? 100 : boost::multiprecision::detail::digits2<number<T, et_on> >::value;
-   // Series expansion of hyperg_0f0(; ; x).
-   for(n = 2; n < series_limit; ++n)
-   {
-      eval_multiply(x_pow_n_div_n_fact, x);
-      eval_divide(x_pow_n_div_n_fact, n);
-      eval_add(H0F0, x_pow_n_div_n_fact);
-      bool neg = eval_get_sign(x_pow_n_div_n_fact) < 0;
-      if(neg)
-         x_pow_n_div_n_fact.negate();
-      if(lim.compare(x_pow_n_div_n_fact) > 0)
-         break;
-      if(neg)
-         x_pow_n_div_n_fact.negate();
-   }
-   if(n >= series_limit)
-      BOOST_THROW_EXCEPTION(std::runtime_error("H0F0 failed to converge"));
+   eval_series(H0F0, x, exp_series());
 }
 
 template <class T>
@@ -235,29 +201,9 @@ void eval_exp(T& result, const T& x)
    if(xx.compare(si_type(1)) <= 0)
    {
       //
-      // Use series for exp(x) - 1:
+      // Sum the series directly:
       //
-      T lim = std::numeric_limits<number<T, et_on> >::epsilon().backend();
-      unsigned k = 2;
-      exp_series = xx;
-      result = si_type(1);
-      if(isneg)
-         eval_subtract(result, exp_series);
-      else
-         eval_add(result, exp_series);
-      eval_multiply(exp_series, xx);
-      eval_divide(exp_series, ui_type(k));
-      eval_add(result, exp_series);
-      while(exp_series.compare(lim) > 0)
-      {
-         ++k;
-         eval_multiply(exp_series, xx);
-         eval_divide(exp_series, ui_type(k));
-         if(isneg && (k&1))
-            eval_subtract(result, exp_series);
-         else
-            eval_add(result, exp_series);
-      }
+      hyp0F0(result, x);
       return;
    }
 
@@ -305,6 +251,63 @@ void eval_exp(T& result, const T& x)
       result = exp_series;
 }
 
+//
+// Above this many bits precision log is evaluated from the arithmetic-geometric mean rather than
+// a series, except for arguments very close to 1:
+//
+#ifndef BOOST_MP_LOG_AGM_CUTOFF
+#define BOOST_MP_LOG_AGM_CUTOFF 2000
+#endif
+
+//
+// Sets result = log(x) for finite x > 0 using the arithmetic-geometric mean:
+//
+//    log(s) = pi / (2 AGM(1, 4/s)) + O(log(s) / s^2)
+//
+// with s = x * 2^m large enough that the error term is below the precision of T, log(x) is then
+// log(s) - m log(2).  See Brent, R. P. Fast multiple-precision evaluation of elementary functions, 1976.
+// The final subtraction cancels up to about log2(m) bits when log(x) is small, so this relies on T
+// carrying some guard digits, backends without any may overload this to work at a higher precision:
+//
+template <class T>
+void eval_log_agm(T& result, const T& x)
+{
+   typedef typename boost::multiprecision::detail::canonical<unsigned, T>::type ui_type;
+   typedef typename T::exponent_type exp_type;
+   typedef typename boost::multiprecision::detail::canonical<exp_type, T>::type canonical_exp_type;
+
+   const unsigned bits = constant_precision<T>::value();
+   exp_type e;
+   T a, b, t, lim;
+   eval_frexp(t, x, &e);
+   //
+   // s = t * 2^m >= 2^(m-1), and 4/s = 4 / (t * 2^m):
+   //
+   const exp_type m = static_cast<exp_type>(bits / 2 + 10);
+   b = ui_type(4u);
+   eval_divide(b, t);
+   eval_ldexp(b, b, -m);
+   a = ui_type(1u);
+   for(;;)
+   {
+      //
+      // Once a and b agree to half the precision the next arithmetic mean is accurate to all of it:
+      //
+      eval_subtract(t, a, b);
+      eval_ldexp(lim, a, -static_cast<exp_type>(bits / 2 + 4));
+      if(t.compare(lim) <= 0)
+         break;
+      eval_multiply(t, a, b);
+      eval_add(a, b);
+      eval_ldexp(a, a, -1);
+      eval_sqrt(b, t);
+   }
+   eval_add(a, b);
+   eval_divide(result, get_constant_pi<T>(), a);
+   eval_multiply(t, get_constant_ln2<T>(), canonical_exp_type(m - e));
+   eval_subtract(result, t);
+}
+
 template <class T>
 void eval_log(T& result, const T& arg)
 {
@@ -331,6 +334,23 @@ void eval_log(T& result, const T& arg)
       eval_ldexp(t, t, 1);
       --e;
    }
+
+   if((constant_precision<T>::value() >= BOOST_MP_LOG_AGM_CUTOFF) && (eval_get_sign(arg) > 0) && (eval_fpclassify(arg) == FP_NORMAL))
+   {
+      //
+      // When arg is within 2^-16 of 1 the series below gains at least 16 bits per term, and the AGM
+      // would cancel too many digits, otherwise the AGM is cheaper:
+      //
+      T d;
+      eval_subtract(d, t, ui_type(1));
+      if(eval_get_sign(d) < 0)
+         d.negate();
+      if((e != 0) || (d.compare(fp_type(1) / fp_type(65536)) > 0))
+      {
+         eval_log_agm(result, arg);
+         return;
+      }
+   }
    
    eval_multiply(result, get_constant_ln2<T>(), canonical_exp_type(e));
    INSTRUMENT_BACKEND(result);
@@ -366,18 +386,20 @@ void eval_log(T& result, const T& arg)
    }while(lim.compare(t2) < 0);
 }
 
+template <class T>
+void calc_log10(T& result, unsigned)
+{
+   typedef typename boost::multiprecision::detail::canonical<unsigned, T>::type ui_type;
+   T ten;
+   ten = ui_type(10u);
+   eval_log(result, ten);
+}
+
 template <class T>
 const T& get_constant_log10()
 {
-   static T result;
-   static bool b = false;
-   if(!b)
-   {
-      typedef typename boost::multiprecision::detail::canonical<unsigned, T>::type ui_type;
-      T ten;
-      ten = ui_type(10u);
-      eval_log(result, ten);
-   }
+   static constant_cache<T, &calc_log10<T> > cache;
+   const T& result = cache.get(constant_precision<T>::value());
 
    constant_initializer<T, &get_constant_log10<T> >::do_nothing();
 
@@ -0,0 +1,189 @@
+
+// Copyright 2011 John Maddock. Distributed under the Boost
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+// This file has no include guards or namespaces - it's expanded inline inside default_ops.hpp
+//
+
+//
+// Evaluation of series SUM[n>=0] c(n) x^n where c(0) = 1 and c(n) = c(n-1) * s(n), s(n) = p(n) / q(n) for small
+// positive integers p(n) and q(n) given by Series::ratio(n, p, q), by rectangular splitting.  See Smith, D. M.
+// Efficient multiple-precision evaluation of elementary functions, 1989.  With the powers x^0 ... x^m to hand the
+// terms are taken in blocks of m, and the sum S(0) is found from:
+//
+//    S(j) = x^0 + s(jm+1) (x^1 + s(jm+2) (x^2 + ... + s(jm+m-1) (x^(m-1) + s(jm+m) x^m S(j+1))))
+//
+// which needs only multiplications and divisions by the small integers p and q, plus one full multiplication by
+// x^m per block.  Overall about 2 sqrt(N) full multiplications are needed for N terms instead of N.
+//
+// The full multiplication is supplied by the Multiply functor so that fixed point types may use the same code,
+// the default just calls eval_multiply:
+//
+struct series_multiply
+{
+   template <class T>
+   void operator()(T& result, const T& a, const T& b)const
+   {
+      eval_multiply(result, a, b);
+   }
+};
+
+//
+// Returns the number of terms of the series needed for them to fall below 2^-bits when |x| = 2^log2_x:
+//
+template <class Series>
+unsigned series_term_count(const Series& s, double log2_x, unsigned bits)
+{
+   double lg = 0;
+   unsigned n = 1;
+   for(; lg > -static_cast<double>(bits); ++n)
+   {
+      unsigned long p, q;
+      s.ratio(n, p, q);
+      lg += log2_x + std::log(static_cast<double>(p) / static_cast<double>(q)) / std::log(2.0);
+   }
+   return n;
+}
+//
+// The block size used for a series of n terms:
+//
+inline unsigned series_block_size(unsigned n)
+{
+   unsigned m = static_cast<unsigned>(std::sqrt(static_cast<double>(n)));
+   return m < 2 ? 2 : m;
+}
+//
+// Fills powers with x^0 ... x^m, where one is the value 1 in the representation used:
+//
+template <class T, class Multiply>
+void series_powers(std::vector<T>& powers, const T& one, const T& x, unsigned m, const Multiply& mul)
+{
+   powers.resize(m + 1);
+   powers[0] = one;
+   powers[1] = x;
+   for(unsigned i = 2; i <= m; ++i)
+      mul(powers[i], powers[i / 2], powers[i - i / 2]);
+}
+//
+// Sets result to the sum of the first n terms of the series, powers holds x^0 ... x^m as set by series_powers:
+//
+template <class T, class Series, class Multiply>
+void eval_series_rectangular(T& result, const std::vector<T>& powers, unsigned n, const Series& s, const Multiply& mul)
+{
+   typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
+   const unsigned m = static_cast<unsigned>(powers.size() - 1);
+   BOOST_ASSERT(m >= 1);
+   T t;
+   result = ui_type(0u);
+   bool first = true;
+   for(unsigned j = (n - 1) / m + 1; j-- > 0; )
+   {
+      unsigned count = first ? n - j * m : m;
+      if(!first)
+      {
+         mul(t, result, powers[m]);
+         result.swap(t);
+      }
+      for(unsigned i = count; i > 0; --i)
+      {
+         if(!first || (i != count))
+         {
+            unsigned long p, q;
+            s.ratio(j * m + i, p, q);
+            if(p != 1)
+               eval_multiply(result, static_cast<ui_type>(p));
+            eval_divide(result, static_cast<ui_type>(q));
+         }
+         eval_add(result, powers[i - 1]);
+      }
+      first = false;
+   }
+}
+//
+// Sets result to the sum of the series to the precision of T:
+//
+template <class T, class Series>
+void eval_series(T& result, const T& x, const Series& s)
+{
+   typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
+   typedef typename T::exponent_type exp_type;
+
+   if(eval_get_sign(x) == 0)
+   {
+      result = ui_type(1u);
+      return;
+   }
+   T t, one;
+   exp_type e;
+   double d;
+   eval_frexp(t, x, &e);
+   eval_convert_to(&d, t);
+   const unsigned n = series_term_count(s, static_cast<double>(e) + std::log(std::fabs(d)) / std::log(2.0), constant_precision<T>::value() + 2);
+   std::vector<T> powers;
+   one = ui_type(1u);
+   series_powers(powers, one, x, series_block_size(n), series_multiply());
+   eval_series_rectangular(result, powers, n, s, series_multiply());
+}
+
+//
+// The series for exp(x), c(n) = 1 / n!:
+//
+struct exp_series
+{
+   void ratio(unsigned n, unsigned long& p, unsigned long& q)const
+   {
+      p = 1;
+      q = n;
+   }
+};
+//
+// The series for (exp(x) - 1) / x, c(n) = 1 / (n+1)!:
+//
+struct expm1_series
+{
+   void ratio(unsigned n, unsigned long& p, unsigned long& q)const
+   {
+      p = 1;
+      q = n + 1;
+   }
+};
+//
+// The series for sin(x) / x in y = -x^2, c(n) = 1 / (2n+1)!:
+//
+struct sin_series
+{
+   void ratio(unsigned n, unsigned long& p, unsigned long& q)const
+   {
+      p = 1;
+      q = 2ul * n * (2ul * n + 1);
+   }
+};
+//
+// The series for 2 (1 - cos(x)) / x^2 in y = -x^2, c(n) = 2 / (2n+2)!:
+//
+struct cos_series
+{
+   void ratio(unsigned n, unsigned long& p, unsigned long& q)const
+   {
+      p = 1;
+      q = (2ul * n + 1) * (2ul * n + 2);
+   }
+};
+//
+// The series for hyperg_2f1(a, b; c; x) with half integer parameters a = a2 / 2, b = b2 / 2 and c = c2 / 2,
+// c(n) = c(n-1) (a + n - 1) (b + n - 1) / ((c + n - 1) n):
+//
+struct hyp2F1_series
+{
+   hyp2F1_series(unsigned a2, unsigned b2, unsigned c2) : m_a2(a2), m_b2(b2), m_c2(c2) {}
+   void ratio(unsigned n, unsigned long& p, unsigned long& q)const
+   {
+      p = (m_a2 + 2ul * n - 2) * (m_b2 + 2ul * n - 2);
+      q = (m_c2 + 2ul * n - 2) * (2ul * n);
+   }
+private:
+   unsigned m_a2, m_b2, m_c2;
+};
+
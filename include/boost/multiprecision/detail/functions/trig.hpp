@@ -17,390 +17,306 @@
 #pragma warning(disable:6326)  // comparison of two constants
 #endif
 
+//
+// The number of times the argument is halved before the sin and cos series are summed, for a type
+// with the given number of bits precision.  Each halving costs two multiplications when the double
+// angle formulae are applied afterwards, and shortens the series; about sqrt(bits / 2) halvings
+// roughly minimises the total work.  Define BOOST_MP_SIN_COS_HALVING_DEPTH to use a fixed depth:
+//
+inline unsigned sin_cos_halving_depth(unsigned bits)
+{
+#ifdef BOOST_MP_SIN_COS_HALVING_DEPTH
+   (void)bits;
+   return BOOST_MP_SIN_COS_HALVING_DEPTH;
+#else
+   unsigned d = static_cast<unsigned>(std::sqrt(bits / 2.0));
+   return d > 4 ? d - 4 : 0;
+#endif
+}
+
+//
+// Sets s = sin(x) and c = cos(x) for |x| <= pi/4.  The argument is halved k times, after which sin and
+// v = 1 - cos are summed by rectangular splitting from the same powers of x^2.  The double angle formulae
+//
+//    sin(2x) = 2 sin(x) (1 - v(x)),  v(2x) = 2 sin(x)^2
+//
+// are then applied k times, neither of which suffers from cancellation:
+//
 template <class T>
-void hyp0F1(T& result, const T& b, const T& x)
+void sin_cos_kernel(T& s, T& c, const T& x)
 {
-   typedef typename boost::multiprecision::detail::canonical<boost::int32_t, T>::type si_type;
    typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
+   typedef typename T::exponent_type exp_type;
 
-   // Compute the series representation of Hypergeometric0F1 taken from
-   // http://functions.wolfram.com/HypergeometricFunctions/Hypergeometric0F1/06/01/01/
-   // There are no checks on input range or parameter boundaries.
-
-   T x_pow_n_div_n_fact(x);
-   T pochham_b         (b);
-   T bp                (b);
-
-   eval_divide(result, x_pow_n_div_n_fact, pochham_b);
-   eval_add(result, ui_type(1));
-
-   si_type n;
-
-   T tol;
-   tol = ui_type(1);
-   eval_ldexp(tol, tol, 1 - boost::multiprecision::detail::digits2<number<T, et_on> >::value);
-   eval_multiply(tol, result);
-   if(eval_get_sign(tol) < 0)
-      tol.negate();
-   T term;
-
-   static const int series_limit = 
-      boost::multiprecision::detail::digits2<number<T, et_on> >::value < 100
-      ? 100 : boost::multiprecision::detail::digits2<number<T, et_on> >::value;
-   // Series expansion of hyperg_0f1(; b; x).
-   for(n = 2; n < series_limit; ++n)
+   if(eval_get_sign(x) == 0)
    {
-      eval_multiply(x_pow_n_div_n_fact, x);
-      eval_divide(x_pow_n_div_n_fact, n);
-      eval_increment(bp);
-      eval_multiply(pochham_b, bp);
-
-      eval_divide(term, x_pow_n_div_n_fact, pochham_b);
-      eval_add(result, term);
-
-      bool neg_term = eval_get_sign(term) < 0;
-      if(neg_term)
-         term.negate();
-      if(term.compare(tol) <= 0)
-         break;
+      s = ui_type(0);
+      c = ui_type(1);
+      return;
    }
-
-   if(n >= series_limit)
-      BOOST_THROW_EXCEPTION(std::runtime_error("H0F1 Failed to Converge"));
+   const unsigned bits = constant_precision<T>::value();
+   T a(x);
+   const bool b_neg = eval_get_sign(a) < 0;
+   if(b_neg)
+      a.negate();
+
+   T t, v, term, one;
+   exp_type e;
+   eval_frexp(t, a, &e);
+   exp_type k = static_cast<exp_type>(sin_cos_halving_depth(bits)) + e;
+   if(k < 0)
+      k = 0;
+   eval_ldexp(a, a, -k);
+
+   //
+   // Both series are in y = -a^2, and share the same powers of y:
+   //
+   eval_multiply(t, a, a);
+   t.negate();
+   eval_frexp(term, t, &e);
+   double d;
+   eval_convert_to(&d, term);
+   const double log2_y = static_cast<double>(e) + std::log(std::fabs(d)) / std::log(2.0);
+   const unsigned n_sin = series_term_count(sin_series(), log2_y, bits + 2);
+   const unsigned n_cos = series_term_count(cos_series(), log2_y, bits + 2);
+   std::vector<T> powers;
+   one = ui_type(1);
+   series_powers(powers, one, t, series_block_size(n_sin > n_cos ? n_sin : n_cos), series_multiply());
+   eval_series_rectangular(term, powers, n_sin, sin_series(), series_multiply());
+   eval_multiply(s, term, a);
+   eval_series_rectangular(term, powers, n_cos, cos_series(), series_multiply());
+   eval_multiply(v, term, t);
+   eval_ldexp(v, v, -1);
+   v.negate();
+
+   for(exp_type i = 0; i < k; ++i)
+   {
+      eval_multiply(t, s, s);
+      c = ui_type(1);
+      eval_subtract(c, v);
+      eval_multiply(s, c);
+      eval_ldexp(s, s, 1);
+      eval_ldexp(v, t, 1);
+   }
+   c = ui_type(1);
+   eval_subtract(c, v);
+   if(b_neg)
+      s.negate();
 }
 
-
+//
+// Reduces x > pi/4 to result = x - n pi/2 with |result| <= pi/4, and sets quadrant = n mod 4.
+// This generic version carries out the reduction at the working precision, and loses accuracy as x grows:
+//
 template <class T>
-void eval_sin(T& result, const T& x)
+void reduce_n_half_pi(T& result, unsigned& quadrant, const T& x, const mpl::false_&)
 {
-   BOOST_STATIC_ASSERT_MSG(number_category<T>::value == number_kind_floating_point, "The sin function is only valid for floating point types.");
-   if(&result == &x)
-   {
-      T temp;
-      eval_sin(temp, x);
-      result = temp;
-      return;
-   }
-
-   typedef typename boost::multiprecision::detail::canonical<boost::int32_t, T>::type si_type;
    typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
    typedef typename mpl::front<typename T::float_types>::type fp_type;
 
-   switch(eval_fpclassify(x))
-   {
-   case FP_INFINITE:
-   case FP_NAN:
-      if(std::numeric_limits<number<T, et_on> >::has_quiet_NaN)
-         result = std::numeric_limits<number<T, et_on> >::quiet_NaN().backend();
-      else
-         BOOST_THROW_EXCEPTION(std::domain_error("Result is undefined or complex and there is no NaN for this number type."));
-      return;
-   case FP_ZERO:
-      result = ui_type(0);
+   T half_pi, n, t;
+   eval_ldexp(half_pi, get_constant_pi<T>(), -1);
+   eval_divide(n, x, half_pi);
+   eval_add(n, fp_type(0.5));
+   eval_floor(n, n);
+   t = ui_type(4);
+   eval_fmod(t, n, t);
+   boost::long_long_type q;
+   eval_convert_to(&q, t);
+   quadrant = static_cast<unsigned>(q);
+   eval_multiply(t, n, half_pi);
+   eval_subtract(result, x, t);
+}
+
+//
+// When T has an integer type associated with it by constant_integer this is done in the style of
+// Payne and Hanek: x is converted exactly to the integer X = x * 2^S and multiplied by the integer
+// 2^K * 2/pi, the quadrant is then given by the two bits above the binary point of the product and
+// the reduced argument by the bits below.  The result is accurate however large x is, and however
+// close to a multiple of pi/2:
+//
+template <class T>
+void reduce_n_half_pi(T& result, unsigned& quadrant, const T& x, const mpl::true_&)
+{
+   typedef typename constant_integer<T>::type integer_type;
+   typedef typename mpl::front<typename integer_type::unsigned_types>::type i_ui_type;
+   typedef typename T::exponent_type exp_type;
+
+   const unsigned bits = constant_precision<T>::value();
+   const unsigned S = bits + 64;
+   exp_type e;
+   T t, f;
+   eval_frexp(t, x, &e);
+   if(e > (1 << 20))
+   {
+      //
+      // Types with very wide exponent ranges (cpp_dec_float) would need an unreasonably
+      // large integer to reduce such an argument exactly:
+      //
+      reduce_n_half_pi(result, quadrant, x, mpl::false_());
       return;
-   default: ;
    }
-
-   // Local copy of the argument
-   T xx = x;
-
-   // Analyze and prepare the phase of the argument.
-   // Make a local, positive copy of the argument, xx.
-   // The argument xx will be reduced to 0 <= xx <= pi/2.
-   bool b_negate_sin = false;
-
-   if(eval_get_sign(x) < 0)
-   {
-      xx.negate();
-      b_negate_sin = !b_negate_sin;
+   //
+   // Integer and fractional parts of x are converted separately, S bits is enough
+   // for all the fractional bits of x as x > 1/2:
+   //
+   integer_type X, y;
+   eval_trunc(t, x);
+   eval_subtract(f, x, t);
+   eval_ldexp(f, f, static_cast<exp_type>(S));
+   constant_integer<T>::truncate(X, t);
+   constant_integer<T>::truncate(y, f);
+   eval_left_shift(X, S);
+   eval_add(X, y);
+   //
+   // The error in the product is less than X / 2^(K+S), about x * 2^-K, so K = e + 2 * bits + 64
+   // leaves bits + 64 correct bits in the fraction even when it is as small as 2^-bits:
+   //
+   const unsigned K = static_cast<unsigned>(e) + 2 * bits + 64;
+   unsigned cached_bits = K;
+   const integer_type& two_over_pi = get_constant_two_over_pi<integer_type>(cached_bits);
+   eval_right_shift(y, two_over_pi, cached_bits - K);
+   eval_multiply(y, X);
+   unsigned F = K + S;
+   quadrant = (eval_bit_test(y, F) ? 1u : 0u) + (eval_bit_test(y, F + 1) ? 2u : 0u);
+   eval_right_shift(X, y, F);
+   eval_left_shift(X, F);
+   eval_subtract(y, X);
+   bool b_neg = false;
+   if(eval_bit_test(y, F - 1))
+   {
+      //
+      // Round to the nearest multiple of pi/2, and take the magnitude of the remainder:
+      //
+      ++quadrant;
+      X = i_ui_type(1u);
+      eval_left_shift(X, F);
+      eval_subtract(y, X, y);
+      b_neg = true;
+   }
+   quadrant &= 3;
+   if(eval_get_sign(y) == 0)
+   {
+      result = i_ui_type(0u);
+      return;
    }
-
-   T n_pi, t;
-   // Remove even multiples of pi.
-   if(xx.compare(get_constant_pi<T>()) > 0)
+   unsigned msb = eval_msb(y);
+   if(msb > S)
    {
-      eval_divide(n_pi, xx, get_constant_pi<T>());
-      eval_trunc(n_pi, n_pi);
-      t = ui_type(2);
-      eval_fmod(t, n_pi, t);
-      const bool b_n_pi_is_even = eval_get_sign(t) == 0;
-      eval_multiply(n_pi, get_constant_pi<T>());
-      eval_subtract(xx, n_pi);
-
-      BOOST_MATH_INSTRUMENT_CODE(xx.str(0, std::ios_base::scientific));
-      BOOST_MATH_INSTRUMENT_CODE(n_pi.str(0, std::ios_base::scientific));
-
-      // Adjust signs if the multiple of pi is not even.
-      if(!b_n_pi_is_even)
-      {
-         b_negate_sin = !b_negate_sin;
-      }
+      eval_right_shift(y, msb - S);
+      F -= msb - S;
    }
-
-   // Reduce the argument to 0 <= xx <= pi/2.
+   constant_integer<T>::convert(result, y);
+   eval_ldexp(result, result, -static_cast<exp_type>(F));
    eval_ldexp(t, get_constant_pi<T>(), -1);
-   if(xx.compare(t) > 0)
-   {
-      eval_subtract(xx, get_constant_pi<T>(), xx);
-      BOOST_MATH_INSTRUMENT_CODE(xx.str(0, std::ios_base::scientific));
-   }
-
-   eval_subtract(t, xx);
-   const bool b_zero    = eval_get_sign(xx) == 0;
-   const bool b_pi_half = eval_get_sign(t) == 0;
-
-   // Check if the reduced argument is very close to 0 or pi/2.
-   const bool    b_near_zero    = xx.compare(fp_type(1e-1)) < 0;
-   const bool    b_near_pi_half = t.compare(fp_type(1e-1)) < 0;;
-
-   if(b_zero)
-   {
-      result = ui_type(0);
-   }
-   else if(b_pi_half)
-   {
-      result = ui_type(1);
-   }
-   else if(b_near_zero)
-   {
-      eval_multiply(t, xx, xx);
-      eval_divide(t, si_type(-4));
-      T t2;
-      t2 = fp_type(1.5);
-      hyp0F1(result, t2, t);
-      BOOST_MATH_INSTRUMENT_CODE(result.str(0, std::ios_base::scientific));
-      eval_multiply(result, xx);
-   }
-   else if(b_near_pi_half)
-   {
-      eval_multiply(t, t);
-      eval_divide(t, si_type(-4));
-      T t2;
-      t2 = fp_type(0.5);
-      hyp0F1(result, t2, t);
-      BOOST_MATH_INSTRUMENT_CODE(result.str(0, std::ios_base::scientific));
-   }
-   else
-   {
-      // Scale to a small argument for an efficient Taylor series,
-      // implemented as a hypergeometric function. Use a standard
-      // divide by three identity a certain number of times.
-      // Here we use division by 3^9 --> (19683 = 3^9).
-
-      static const si_type n_scale = 9;
-      static const si_type n_three_pow_scale = static_cast<si_type>(19683L);
-
-      eval_divide(xx, n_three_pow_scale);
-
-      // Now with small arguments, we are ready for a series expansion.
-      eval_multiply(t, xx, xx);
-      eval_divide(t, si_type(-4));
-      T t2;
-      t2 = fp_type(1.5);
-      hyp0F1(result, t2, t);
-      BOOST_MATH_INSTRUMENT_CODE(result.str(0, std::ios_base::scientific));
-      eval_multiply(result, xx);
-
-      // Convert back using multiple angle identity.
-      for(boost::int32_t k = static_cast<boost::int32_t>(0); k < n_scale; k++)
-      {
-         // Rescale the cosine value using the multiple angle identity.
-         eval_multiply(t2, result, ui_type(3));
-         eval_multiply(t, result, result);
-         eval_multiply(t, result);
-         eval_multiply(t, ui_type(4));
-         eval_subtract(result, t2, t);
-      }
-   }
-
-   if(b_negate_sin)
+   eval_multiply(result, t);
+   if(b_neg)
       result.negate();
 }
 
+//
+// Sets *p_sin = sin(x) and *p_cos = cos(x), either pointer may be null:
+//
 template <class T>
-void eval_cos(T& result, const T& x)
+void sin_cos_imp(T* p_sin, T* p_cos, const T& x)
 {
-   BOOST_STATIC_ASSERT_MSG(number_category<T>::value == number_kind_floating_point, "The cos function is only valid for floating point types.");
-   if(&result == &x)
-   {
-      T temp;
-      eval_cos(temp, x);
-      result = temp;
-      return;
-   }
-
-   typedef typename boost::multiprecision::detail::canonical<boost::int32_t, T>::type si_type;
    typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
-   typedef typename mpl::front<typename T::float_types>::type fp_type;
 
    switch(eval_fpclassify(x))
    {
    case FP_INFINITE:
    case FP_NAN:
       if(std::numeric_limits<number<T, et_on> >::has_quiet_NaN)
-         result = std::numeric_limits<number<T, et_on> >::quiet_NaN().backend();
+      {
+         if(p_sin)
+            *p_sin = std::numeric_limits<number<T, et_on> >::quiet_NaN().backend();
+         if(p_cos)
+            *p_cos = std::numeric_limits<number<T, et_on> >::quiet_NaN().backend();
+      }
       else
          BOOST_THROW_EXCEPTION(std::domain_error("Result is undefined or complex and there is no NaN for this number type."));
       return;
    case FP_ZERO:
-      result = ui_type(1);
+      if(p_sin)
+         *p_sin = ui_type(0);
+      if(p_cos)
+         *p_cos = ui_type(1);
       return;
    default: ;
    }
 
-   // Local copy of the argument
-   T xx = x;
-
-   // Analyze and prepare the phase of the argument.
-   // Make a local, positive copy of the argument, xx.
-   // The argument xx will be reduced to 0 <= xx <= pi/2.
-   bool b_negate_cos = false;
+   T xx(x), s, c;
+   const bool b_neg = eval_get_sign(xx) < 0;
+   if(b_neg)
+      xx.negate();
 
-   if(eval_get_sign(x) < 0)
+   unsigned quadrant = 0;
+   eval_ldexp(s, get_constant_pi<T>(), -2);
+   if(xx.compare(s) > 0)
    {
-      xx.negate();
+      T r;
+      reduce_n_half_pi(r, quadrant, xx, mpl::bool_<!is_void<typename constant_integer<T>::type>::value>());
+      xx.swap(r);
    }
+   sin_cos_kernel(s, c, xx);
 
-   T n_pi, t;
-   // Remove even multiples of pi.
-   if(xx.compare(get_constant_pi<T>()) > 0)
+   if(quadrant & 1)
    {
-      eval_divide(t, xx, get_constant_pi<T>());
-      eval_trunc(n_pi, t);
-      BOOST_MATH_INSTRUMENT_CODE(n_pi.str(0, std::ios_base::scientific));
-      eval_multiply(t, n_pi, get_constant_pi<T>());
-      BOOST_MATH_INSTRUMENT_CODE(t.str(0, std::ios_base::scientific));
-      eval_subtract(xx, t);
-      BOOST_MATH_INSTRUMENT_CODE(xx.str(0, std::ios_base::scientific));
-
-      // Adjust signs if the multiple of pi is not even.
-      t = ui_type(2);
-      eval_fmod(t, n_pi, t);
-      const bool b_n_pi_is_even = eval_get_sign(t) == 0;
-
-      if(!b_n_pi_is_even)
-      {
-         b_negate_cos = !b_negate_cos;
-      }
+      s.swap(c);
+      c.negate();
    }
-
-   // Reduce the argument to 0 <= xx <= pi/2.
-   eval_ldexp(t, get_constant_pi<T>(), -1);
-   int com = xx.compare(t);
-   if(com > 0)
+   if(quadrant & 2)
    {
-      eval_subtract(xx, get_constant_pi<T>(), xx);
-      b_negate_cos = !b_negate_cos;
-      BOOST_MATH_INSTRUMENT_CODE(xx.str(0, std::ios_base::scientific));
+      s.negate();
+      c.negate();
    }
+   if(b_neg)
+      s.negate();
+   if(p_sin)
+      p_sin->swap(s);
+   if(p_cos)
+      p_cos->swap(c);
+}
 
-   const bool b_zero    = eval_get_sign(xx) == 0;
-   const bool b_pi_half = com == 0;
+template <class T>
+void eval_sin(T& result, const T& x)
+{
+   BOOST_STATIC_ASSERT_MSG(number_category<T>::value == number_kind_floating_point, "The sin function is only valid for floating point types.");
+   sin_cos_imp(&result, static_cast<T*>(0), x);
+}
 
-   // Check if the reduced argument is very close to 0.
-   const bool    b_near_zero    = xx.compare(fp_type(1e-1)) < 0;
+template <class T>
+void eval_cos(T& result, const T& x)
+{
+   BOOST_STATIC_ASSERT_MSG(number_category<T>::value == number_kind_floating_point, "The cos function is only valid for floating point types.");
+   sin_cos_imp(static_cast<T*>(0), &result, x);
+}
 
-   if(b_zero)
-   {
-      result = si_type(1);
-   }
-   else if(b_pi_half)
-   {
-      result = si_type(0);
-   }
-   else if(b_near_zero)
-   {
-      eval_multiply(t, xx, xx);
-      eval_divide(t, si_type(-4));
-      n_pi = fp_type(0.5f);
-      hyp0F1(result, n_pi, t);
-      BOOST_MATH_INSTRUMENT_CODE(result.str(0, std::ios_base::scientific));
-   }
-   else
-   {
-      eval_subtract(t, xx);
-      eval_sin(result, t);
-   }
-   if(b_negate_cos)
-      result.negate();
+template <class T>
+void eval_sincos(T& s, T& c, const T& x)
+{
+   BOOST_STATIC_ASSERT_MSG(number_category<T>::value == number_kind_floating_point, "The sincos function is only valid for floating point types.");
+   sin_cos_imp(&s, &c, x);
 }
 
 template <class T>
 void eval_tan(T& result, const T& x)
 {
    BOOST_STATIC_ASSERT_MSG(number_category<T>::value == number_kind_floating_point, "The tan function is only valid for floating point types.");
-   if(&result == &x)
-   {
-      T temp;
-      eval_tan(temp, x);
-      result = temp;
-      return;
-   }
    T t;
-   eval_sin(result, x);
-   eval_cos(t, x);
+   sin_cos_imp(&result, &t, x);
    eval_divide(result, t);
 }
 
 template <class T>
-void hyp2F1(T& result, const T& a, const T& b, const T& c, const T& x)
+void hyp2F1(T& result, unsigned a2, unsigned b2, unsigned c2, const T& x)
 {
   // Compute the series representation of hyperg_2f1 taken from
-  // Abramowitz and Stegun 15.1.1.
+  // Abramowitz and Stegun 15.1.1, for the half integer parameters
+  // a = a2 / 2, b = b2 / 2 and c = c2 / 2.
   // There are no checks on input range or parameter boundaries.
 
-   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
-
-   T x_pow_n_div_n_fact(x);
-   T pochham_a         (a);
-   T pochham_b         (b);
-   T pochham_c         (c);
-   T ap                (a);
-   T bp                (b);
-   T cp                (c);
-
-   eval_multiply(result, pochham_a, pochham_b);
-   eval_divide(result, pochham_c);
-   eval_multiply(result, x_pow_n_div_n_fact);
-   eval_add(result, ui_type(1));
-
-   T lim;
-   eval_ldexp(lim, result, 1 - boost::multiprecision::detail::digits2<number<T, et_on> >::value);
-
-   if(eval_get_sign(lim) < 0)
-      lim.negate();
-
-   ui_type n;
-   T term;
-
-   static const unsigned series_limit = 
-      boost::multiprecision::detail::digits2<number<T, et_on> >::value < 100
-      ? 100 : boost::multiprecision::detail::digits2<number<T, et_on> >::value;
-   // Series expansion of hyperg_2f1(a, b; c; x).
-   for(n = 2; n < series_limit; ++n)
-   {
-      eval_multiply(x_pow_n_div_n_fact, x);
-      eval_divide(x_pow_n_div_n_fact, n);
-
-      eval_increment(ap);
-      eval_multiply(pochham_a, ap);
-      eval_increment(bp);
-      eval_multiply(pochham_b, bp);
-      eval_increment(cp);
-      eval_multiply(pochham_c, cp);
-
-      eval_multiply(term, pochham_a, pochham_b);
-      eval_divide(term, pochham_c);
-      eval_multiply(term, x_pow_n_div_n_fact);
-      eval_add(result, term);
-
-      if(eval_get_sign(term) < 0)
-         term.negate();
-      if(lim.compare(term) >= 0)
-         break;
-   }
-   if(n > series_limit)
-      BOOST_THROW_EXCEPTION(std::runtime_error("H2F1 failed to converge."));
+   eval_series(result, x, hyp2F1_series(a2, b2, c2));
 }
 
 template <class T>
@@ -460,22 +376,17 @@ void eval_asin(T& result, const T& x)
    {
       // http://functions.wolfram.com/ElementaryFunctions/ArcSin/26/01/01/
       eval_multiply(xx, xx);
-      T t1, t2;
-      t1 = fp_type(0.5f);
-      t2 = fp_type(1.5f);
-      hyp2F1(result, t1, t1, t2, xx);
+      hyp2F1(result, 1u, 1u, 3u, xx);
       eval_multiply(result, x);
       return;
    }
    else if(xx.compare(fp_type(1 - 1e-4f)) > 0)
    {
       T dx1;
-      T t1, t2;
+      T t1;
       eval_subtract(dx1, ui_type(1), xx);
-      t1 = fp_type(0.5f);
-      t2 = fp_type(1.5f);
       eval_ldexp(dx1, dx1, -1);
-      hyp2F1(result, t1, t1, t2, dx1);
+      hyp2F1(result, 1u, 1u, 3u, dx1);
       eval_ldexp(dx1, dx1, 2);
       eval_sqrt(t1, dx1);
       eval_multiply(result, t1);
@@ -500,8 +411,7 @@ void eval_asin(T& result, const T& x)
    while(current_digits < target_precision)
    {
       T sine, cosine;
-      eval_sin(sine, result);
-      eval_cos(cosine, result);
+      eval_sincos(sine, cosine, result);
       eval_subtract(sine, xx);
       eval_divide(sine, cosine);
       eval_subtract(result, sine);
@@ -606,26 +516,19 @@ void eval_atan(T& result, const T& x)
 
    if(xx.compare(fp_type(0.1)) < 0)
    {
-      T t1, t2, t3;
-      t1 = ui_type(1);
-      t2 = fp_type(0.5f);
-      t3 = fp_type(1.5f);
       eval_multiply(xx, xx);
       xx.negate();
-      hyp2F1(result, t1, t2, t3, xx);
+      hyp2F1(result, 2u, 1u, 3u, xx);
       eval_multiply(result, x);
       return;
    }
 
    if(xx.compare(fp_type(10)) > 0)
    {
-      T t1, t2, t3;
-      t1 = fp_type(0.5f);
-      t2 = ui_type(1u);
-      t3 = fp_type(1.5f);
+      T t1;
       eval_multiply(xx, xx);
       eval_divide(xx, si_type(-1), xx);
-      hyp2F1(result, t1, t2, t3, xx);
+      hyp2F1(result, 1u, 2u, 3u, xx);
       eval_divide(result, x);
       if(!b_neg)
          result.negate();
@@ -648,8 +551,7 @@ void eval_atan(T& result, const T& x)
    T s, c, t;
    for(boost::int32_t digits = double_digits10_minus_a_few; digits <= std::numeric_limits<number<T, et_on> >::digits10; digits *= 2)
    {
-      eval_sin(s, result);
-      eval_cos(c, result);
+      eval_sincos(s, c, result);
       eval_multiply(t, xx, c);
       eval_subtract(t, s);
       eval_multiply(s, t, c);
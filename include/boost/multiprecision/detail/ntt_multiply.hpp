@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Exact multiplication of long numbers held as arrays of small radix digits, via
+// number theoretic transforms modulo three primes and Chinese remaindering.
+//
+
+#ifndef BOOST_MP_DETAIL_NTT_MULTIPLY_HPP
+#define BOOST_MP_DETAIL_NTT_MULTIPLY_HPP
+
+#include <vector>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/assert.hpp>
+
+namespace boost { namespace multiprecision { namespace backends { namespace detail {
+
+//
+// Arithmetic modulo a prime of the form k * 2^m + 1 with primitive root Generator, which supports
+// transforms of any power of two length up to 2^m.  All the primes we use are less than 2^30 so
+// sums fit in 32 bits and products in 64.  The transforms multiply via Montgomery reduction
+// with R = 2^32, which avoids a 64-bit division in the inner loop:
+//
+template <boost::uint32_t Prime, boost::uint32_t Generator>
+struct ntt_prime
+{
+   static const boost::uint32_t prime = Prime;
+
+   static boost::uint32_t add(boost::uint32_t a, boost::uint32_t b)
+   {
+      boost::uint32_t r = a + b;
+      return r >= Prime ? r - Prime : r;
+   }
+   static boost::uint32_t subtract(boost::uint32_t a, boost::uint32_t b)
+   {
+      return a >= b ? a - b : a + (Prime - b);
+   }
+   static boost::uint32_t multiply(boost::uint32_t a, boost::uint32_t b)
+   {
+      return static_cast<boost::uint32_t>((static_cast<boost::uint64_t>(a) * b) % Prime);
+   }
+   static boost::uint32_t pow(boost::uint32_t a, boost::uint64_t e)
+   {
+      boost::uint32_t result = 1;
+      while(e)
+      {
+         if(e & 1u)
+            result = multiply(result, a);
+         a = multiply(a, a);
+         e >>= 1;
+      }
+      return result;
+   }
+   static boost::uint32_t inverse(boost::uint32_t a)
+   {
+      return pow(a, Prime - 2);
+   }
+   //
+   // -Prime^-1 mod 2^32, by Newton iteration (each step doubles the number of correct bits):
+   //
+   static boost::uint32_t montgomery_inverse()
+   {
+      boost::uint32_t x = Prime;
+      for(unsigned i = 0; i < 4; ++i)
+         x *= 2u - Prime * x;
+      return 0u - x;
+   }
+   //
+   // a * b * 2^-32 mod Prime, for a, b < Prime:
+   //
+   static boost::uint32_t montgomery_multiply(boost::uint32_t a, boost::uint32_t b, boost::uint32_t pinv)
+   {
+      boost::uint64_t t = static_cast<boost::uint64_t>(a) * b;
+      boost::uint32_t m = static_cast<boost::uint32_t>(t) * pinv;
+      boost::uint32_t r = static_cast<boost::uint32_t>((t + static_cast<boost::uint64_t>(m) * Prime) >> 32);
+      return r >= Prime ? r - Prime : r;
+   }
+   //
+   // a * 2^32 mod Prime:
+   //
+   static boost::uint32_t to_montgomery(boost::uint32_t a)
+   {
+      return static_cast<boost::uint32_t>((static_cast<boost::uint64_t>(a) << 32) % Prime);
+   }
+   //
+   // roots[half + j] = w^j, in Montgomery form, for each power of two half < n and 0 <= j < half,
+   // where w is a primitive (2 * half)'th root of unity.  Each level is every other entry of the
+   // one above, so the whole table costs n / 2 multiplications:
+   //
+   static void make_roots(std::vector<boost::uint32_t>& roots, std::size_t n, boost::uint32_t pinv)
+   {
+      BOOST_ASSERT(((Prime - 1) % n) == 0);
+      roots.resize(n);
+      if(n < 2)
+         return;
+      std::size_t half = n / 2;
+      boost::uint32_t w = to_montgomery(pow(Generator, (Prime - 1) / n));
+      roots[half] = to_montgomery(1);
+      for(std::size_t j = 1; j < half; ++j)
+         roots[half + j] = montgomery_multiply(roots[half + j - 1], w, pinv);
+      for(half /= 2; half; half /= 2)
+         for(std::size_t j = 0; j < half; ++j)
+            roots[half + j] = roots[2 * (half + j)];
+   }
+   //
+   // In place iterative radix 2 forward transform of p[0, n) where n is a power of 2.  The twiddle
+   // factors are held in Montgomery form, so the values themselves stay in ordinary form:
+   //
+   static void transform(boost::uint32_t* p, std::size_t n, const boost::uint32_t* roots, boost::uint32_t pinv)
+   {
+      for(std::size_t i = 1, j = 0; i < n; ++i)
+      {
+         std::size_t bit = n >> 1;
+         for(; j & bit; bit >>= 1)
+            j ^= bit;
+         j ^= bit;
+         if(i < j)
+            std::swap(p[i], p[j]);
+      }
+      for(std::size_t half = 1; half < n; half <<= 1)
+      {
+         const boost::uint32_t* w = roots + half;
+         for(std::size_t i = 0; i < n; i += 2 * half)
+         {
+            boost::uint32_t* pl = p + i;
+            boost::uint32_t* ph = pl + half;
+            for(std::size_t j = 0; j < half; ++j)
+            {
+               boost::uint32_t u = pl[j];
+               boost::uint32_t v = montgomery_multiply(ph[j], w[j], pinv);
+               pl[j] = add(u, v);
+               ph[j] = subtract(u, v);
+            }
+         }
+      }
+   }
+   //
+   // r[0, n) = the cyclic convolution of u[0, p) and v[0, p) modulo Prime, zero padded to length n:
+   //
+   static void convolution(std::vector<boost::uint32_t>& r, const boost::uint32_t* u, const boost::uint32_t* v, std::size_t p, std::size_t n)
+   {
+      const boost::uint32_t pinv = montgomery_inverse();
+      std::vector<boost::uint32_t> roots;
+      make_roots(roots, n, pinv);
+      r.assign(n, 0u);
+      for(std::size_t i = 0; i < p; ++i)
+         r[i] = u[i] % Prime;
+      transform(&r[0], n, &roots[0], pinv);
+      //
+      // The point-wise products pick up a factor of 2^-32 which is removed, along with
+      // the 1/n of the inverse transform, by the final scaling:
+      //
+      if(u == v)
+      {
+         for(std::size_t i = 0; i < n; ++i)
+            r[i] = montgomery_multiply(r[i], r[i], pinv);
+      }
+      else
+      {
+         std::vector<boost::uint32_t> t(n, 0u);
+         for(std::size_t i = 0; i < p; ++i)
+            t[i] = v[i] % Prime;
+         transform(&t[0], n, &roots[0], pinv);
+         for(std::size_t i = 0; i < n; ++i)
+            r[i] = montgomery_multiply(r[i], t[i], pinv);
+      }
+      //
+      // The inverse transform is the forward one followed by reversing r[1, n):
+      //
+      transform(&r[0], n, &roots[0], pinv);
+      std::reverse(r.begin() + 1, r.end());
+      const boost::uint32_t scale = to_montgomery(to_montgomery(inverse(static_cast<boost::uint32_t>(n % Prime))));
+      for(std::size_t i = 0; i < n; ++i)
+         r[i] = montgomery_multiply(r[i], scale, pinv);
+   }
+};
+
+typedef ntt_prime<469762049u, 3u>  ntt_prime_1;   //  7 * 2^26 + 1
+typedef ntt_prime<167772161u, 3u>  ntt_prime_2;   //  5 * 2^25 + 1
+typedef ntt_prime<754974721u, 11u> ntt_prime_3;   // 45 * 2^24 + 1
+
+//
+// The largest number of digits in each argument of ntt_multiply, which is limited by the
+// transform length supported by all three primes (2^24):
+//
+static const std::size_t ntt_max_digits = static_cast<std::size_t>(1u) << 23;
+
+//
+// Full product of u[0, p) and v[0, p), which are big-endian numbers in radix "base" (so u[0] is the most significant
+// digit), the result r[0, 2p) is likewise big-endian with r[0] the most significant digit.  u and v may be the same array.
+//
+// Each coefficient of the convolution is at most p * (base - 1)^2 which is less than the product of the three primes
+// (about 5.9 * 10^25) for every p allowed here and base <= 10^9, so the coefficients are recovered exactly by Chinese
+// remaindering and the product is exact:
+//
+inline void ntt_multiply(boost::uint32_t* r, const boost::uint32_t* u, const boost::uint32_t* v, std::size_t p, boost::uint32_t base)
+{
+   BOOST_ASSERT(base <= 1000000000u);
+   BOOST_ASSERT(p <= ntt_max_digits);
+   std::size_t n = 1;
+   while(n < 2 * p - 1)
+      n <<= 1;
+   std::vector<boost::uint32_t> r1, r2, r3;
+   ntt_prime_1::convolution(r1, u, v, p, n);
+   ntt_prime_2::convolution(r2, u, v, p, n);
+   ntt_prime_3::convolution(r3, u, v, p, n);
+   //
+   // Garner's algorithm: the coefficient is x = t1 + t2 * p1 + t3 * p1 * p2 with each t less than its prime.
+   // Writing p1 * p2 = q * base + s, the low part t1 + t2 * p1 + t3 * s + carry is less than 2^61 and the
+   // high part t3 * q is added straight into the carry, so everything fits in 64 bits:
+   //
+   static const boost::uint32_t p1 = ntt_prime_1::prime;
+   static const boost::uint32_t p2 = ntt_prime_2::prime;
+   const boost::uint32_t inv_p1_mod_p2 = ntt_prime_2::inverse(p1 % p2);
+   const boost::uint32_t inv_p12_mod_p3 = ntt_prime_3::inverse(ntt_prime_3::multiply(p1 % ntt_prime_3::prime, p2 % ntt_prime_3::prime));
+   const boost::uint64_t p12 = static_cast<boost::uint64_t>(p1) * p2;
+   const boost::uint64_t q = p12 / base;
+   const boost::uint64_t s = p12 % base;
+
+   boost::uint64_t carry = 0;
+   for(std::size_t k = 2 * p - 1; k-- > 0;)
+   {
+      boost::uint32_t t1 = r1[k];
+      boost::uint32_t t2 = ntt_prime_2::multiply(ntt_prime_2::subtract(r2[k], t1 % p2), inv_p1_mod_p2);
+      boost::uint32_t x12 = static_cast<boost::uint32_t>((t1 + static_cast<boost::uint64_t>(t2) * p1) % ntt_prime_3::prime);
+      boost::uint32_t t3 = ntt_prime_3::multiply(ntt_prime_3::subtract(r3[k], x12), inv_p12_mod_p3);
+      boost::uint64_t low = t1 + static_cast<boost::uint64_t>(t2) * p1 + static_cast<boost::uint64_t>(t3) * s + carry;
+      r[k + 1] = static_cast<boost::uint32_t>(low % base);
+      carry = low / base + static_cast<boost::uint64_t>(t3) * q;
+   }
+   BOOST_ASSERT(carry < base);
+   r[0] = static_cast<boost::uint32_t>(carry);
+}
+
+} } } } // namespace boost::multiprecision::backends::detail
+
+#endif // BOOST_MP_DETAIL_NTT_MULTIPLY_HPP
@@ -782,6 +782,76 @@ struct is_interval_number : public mpl::false_ {};
 template <class Backend, expression_template_option ExpressionTemplates>
 struct is_interval_number<number<Backend, ExpressionTemplates> > : public is_interval_number<Backend>{};
 
+//
+// The back-end type in which sum_of_products, and expressions such as a*b + c*d, accumulate their
+// products.  Back-ends which would otherwise round each product may name a wider type here, for which
+// eval_accumulate_product forms each product exactly, so that the sum is rounded just once at the end:
+//
+template <class Backend>
+struct sum_of_products_accumulator
+{
+   typedef Backend type;
+};
+
+namespace detail{
+
+//
+// Describes an expression which is a sum or difference of values of type Number and of products of two such
+// values, valid is false for any other expression:
+//
+template <class Exp, class Number, class Tag = typename Exp::tag_type>
+struct sum_of_products_traits
+{
+   static const bool valid = false;
+   static const unsigned products = 0;
+};
+template <class Exp, class Number>
+struct sum_of_products_traits<Exp, Number, terminal>
+{
+   static const bool valid = is_same<typename Exp::result_type, Number>::value;
+   static const unsigned products = 0;
+};
+template <class Exp, class Number>
+struct sum_of_products_traits<Exp, Number, multiply_immediates>
+{
+   static const bool valid = is_same<typename Exp::left_result_type, Number>::value && is_same<typename Exp::right_result_type, Number>::value;
+   static const unsigned products = 1;
+};
+template <class Exp, class Number>
+struct sum_of_products_traits<Exp, Number, multiply_add>
+{
+   static const bool valid = is_same<typename Exp::left_result_type, Number>::value && is_same<typename Exp::middle_result_type, Number>::value && is_same<typename Exp::right_result_type, Number>::value;
+   static const unsigned products = 1;
+};
+template <class Exp, class Number>
+struct sum_of_products_traits<Exp, Number, multiply_subtract> : public sum_of_products_traits<Exp, Number, multiply_add> {};
+template <class Exp, class Number>
+struct sum_of_products_traits<Exp, Number, negate>
+{
+   static const bool valid = sum_of_products_traits<typename Exp::left_type, Number>::valid;
+   static const unsigned products = sum_of_products_traits<typename Exp::left_type, Number>::products;
+};
+template <class Exp, class Number>
+struct sum_of_products_traits<Exp, Number, plus>
+{
+   static const bool valid = sum_of_products_traits<typename Exp::left_type, Number>::valid && sum_of_products_traits<typename Exp::right_type, Number>::valid;
+   static const unsigned products = sum_of_products_traits<typename Exp::left_type, Number>::products + sum_of_products_traits<typename Exp::right_type, Number>::products;
+};
+template <class Exp, class Number>
+struct sum_of_products_traits<Exp, Number, minus> : public sum_of_products_traits<Exp, Number, plus> {};
+
+//
+// True when an expression assigned to Number should be evaluated in Number's sum_of_products_accumulator:
+// it must have at least two products to gain anything over eval_multiply_add:
+//
+template <class Exp, class Number>
+struct is_fused_sum_of_products : public mpl::bool_<
+   sum_of_products_traits<Exp, Number>::valid
+   && (sum_of_products_traits<Exp, Number>::products >= 2)>
+{};
+
+} // namespace detail
+
 }} // namespaces
 
 namespace boost{ namespace math{ namespace tools{
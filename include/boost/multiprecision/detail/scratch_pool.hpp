@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Per-thread pool of storage for the temporaries used inside the arithmetic routines.
+//
+
+#ifndef BOOST_MP_DETAIL_SCRATCH_POOL_HPP
+#define BOOST_MP_DETAIL_SCRATCH_POOL_HPP
+
+#include <cstddef>
+#include <new>
+#include <boost/config.hpp>
+
+//
+// The number of freed blocks each thread keeps for reuse, zero sends every request straight to operator new:
+//
+#ifndef BOOST_MP_SCRATCH_POOL_SIZE
+#define BOOST_MP_SCRATCH_POOL_SIZE 64
+#endif
+
+namespace boost{ namespace multiprecision{ namespace detail{
+
+//
+// Block sizes are rounded up to a power of two, and each block records its size in a small header, so that a
+// freed block can be handed out again for any request no larger than itself: once a calculation has run
+// through once, repeating it needs no calls to operator new at all.  When the pool is full the smallest block
+// is the one discarded.  The cached blocks are freed when the thread exits, and without thread_local support
+// the pool is bypassed altogether:
+//
+class scratch_pool
+{
+   union header_type
+   {
+      unsigned    size_class;
+      long double ld;
+      void*       p;
+   };
+public:
+   static void* allocate(std::size_t bytes)
+   {
+      unsigned c = size_class(bytes + sizeof(header_type));
+#if !defined(BOOST_NO_CXX11_THREAD_LOCAL) && BOOST_MP_SCRATCH_POOL_SIZE
+      data_type& d = data();
+      unsigned best = d.count;
+      for(unsigned i = 0; i < d.count; ++i)
+      {
+         if((d.size_class[i] >= c) && ((best == d.count) || (d.size_class[i] < d.size_class[best])))
+            best = i;
+      }
+      if(best != d.count)
+      {
+         header_type* h = d.blocks[best];
+         --d.count;
+         d.blocks[best] = d.blocks[d.count];
+         d.size_class[best] = d.size_class[d.count];
+         return h + 1;
+      }
+#endif
+      header_type* h = static_cast<header_type*>(::operator new(static_cast<std::size_t>(1u) << c));
+      h->size_class = c;
+      return h + 1;
+   }
+   static void deallocate(void* p) BOOST_NOEXCEPT
+   {
+      header_type* h = static_cast<header_type*>(p) - 1;
+#if !defined(BOOST_NO_CXX11_THREAD_LOCAL) && BOOST_MP_SCRATCH_POOL_SIZE
+      data_type& d = data();
+      if(!d.closed)
+      {
+         if(d.count == 0)
+            cleanup();  // Make sure the blocks get freed at thread exit.
+         unsigned pos = d.count;
+         if(d.count == BOOST_MP_SCRATCH_POOL_SIZE)
+         {
+            pos = 0;
+            for(unsigned i = 1; i < d.count; ++i)
+            {
+               if(d.size_class[i] < d.size_class[pos])
+                  pos = i;
+            }
+            if(d.size_class[pos] >= h->size_class)
+            {
+               ::operator delete(h);
+               return;
+            }
+            ::operator delete(d.blocks[pos]);
+         }
+         else
+            ++d.count;
+         d.blocks[pos] = h;
+         d.size_class[pos] = static_cast<unsigned char>(h->size_class);
+         return;
+      }
+#endif
+      ::operator delete(h);
+   }
+private:
+   static unsigned size_class(std::size_t bytes) BOOST_NOEXCEPT
+   {
+      unsigned c = 6;
+      while((static_cast<std::size_t>(1u) << c) < bytes)
+         ++c;
+      return c;
+   }
+#if !defined(BOOST_NO_CXX11_THREAD_LOCAL) && BOOST_MP_SCRATCH_POOL_SIZE
+   //
+   // The cache itself is trivially destructible, so that it remains usable by destructors which run
+   // after the thread's cleanup object, those just go to operator delete once the cache is closed:
+   //
+   struct data_type
+   {
+      header_type*  blocks[BOOST_MP_SCRATCH_POOL_SIZE];
+      unsigned char size_class[BOOST_MP_SCRATCH_POOL_SIZE];
+      unsigned      count;
+      bool          closed;
+   };
+   static data_type& data() BOOST_NOEXCEPT
+   {
+      static thread_local data_type d;
+      return d;
+   }
+   struct cleanup_type
+   {
+      ~cleanup_type()
+      {
+         data_type& d = data();
+         for(unsigned i = 0; i < d.count; ++i)
+            ::operator delete(d.blocks[i]);
+         d.count = 0;
+         d.closed = true;
+      }
+   };
+   static void cleanup() BOOST_NOEXCEPT
+   {
+      static thread_local cleanup_type c;
+      (void)c;
+   }
+#endif
+};
+
+//
+// A stateless allocator for temporaries, all instances draw from the current thread's scratch_pool:
+//
+template <class T>
+class scratch_allocator
+{
+public:
+   typedef T                 value_type;
+   typedef T*                pointer;
+   typedef const T*          const_pointer;
+   typedef T&                reference;
+   typedef const T&          const_reference;
+   typedef std::size_t       size_type;
+   typedef std::ptrdiff_t    difference_type;
+
+   template <class U>
+   struct rebind
+   {
+      typedef scratch_allocator<U> other;
+   };
+
+   scratch_allocator() BOOST_NOEXCEPT {}
+   template <class U>
+   scratch_allocator(const scratch_allocator<U>&) BOOST_NOEXCEPT {}
+
+   pointer address(reference x)const BOOST_NOEXCEPT { return &x; }
+   const_pointer address(const_reference x)const BOOST_NOEXCEPT { return &x; }
+   pointer allocate(size_type n, const void* = 0)
+   {
+      return static_cast<pointer>(scratch_pool::allocate(n * sizeof(T)));
+   }
+   void deallocate(pointer p, size_type) BOOST_NOEXCEPT
+   {
+      scratch_pool::deallocate(p);
+   }
+   size_type max_size()const BOOST_NOEXCEPT { return (~static_cast<size_type>(0u) / 2) / sizeof(T); }
+   void construct(pointer p, const T& val) { new (static_cast<void*>(p)) T(val); }
+   void destroy(pointer p) { p->~T(); }
+};
+
+template <class T, class U>
+inline bool operator == (const scratch_allocator<T>&, const scratch_allocator<U>&) BOOST_NOEXCEPT { return true; }
+template <class T, class U>
+inline bool operator != (const scratch_allocator<T>&, const scratch_allocator<U>&) BOOST_NOEXCEPT { return false; }
+
+}}} // namespaces
+
+#endif // BOOST_MP_DETAIL_SCRATCH_POOL_HPP
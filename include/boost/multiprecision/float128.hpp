@@ -421,6 +421,12 @@ inline void eval_cos(float128_backend& result, const float128_backend& arg)
 {
    result.value() = cosq(arg.value());
 }
+inline void eval_sincos(float128_backend& s, float128_backend& c, const float128_backend& arg)
+{
+   float128_type t = arg.value();
+   s.value() = sinq(t);
+   c.value() = cosq(t);
+}
 inline void eval_tan(float128_backend& result, const float128_backend& arg)
 {
    result.value() = tanq(arg.value());
@@ -370,11 +370,29 @@ struct gmp_float_imp
    }
 protected:
    mpf_t m_data;
-   static unsigned& get_default_precision() BOOST_NOEXCEPT
+   //
+   // The default precision is process wide, unless overridden for the current thread
+   // by a non-zero thread default precision:
+   //
+   static unsigned& get_global_default_precision() BOOST_NOEXCEPT
    {
       static unsigned val = 50;
       return val;
    }
+   static unsigned& get_thread_default_precision() BOOST_NOEXCEPT
+   {
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+      static thread_local unsigned val = 0;
+#else
+      static unsigned val = 0;
+#endif
+      return val;
+   }
+   static unsigned get_default_precision() BOOST_NOEXCEPT
+   {
+      unsigned v = get_thread_default_precision();
+      return v ? v : get_global_default_precision();
+   }
 };
 
 } // namespace detail
@@ -560,7 +578,15 @@ struct gmp_float<0> : public detail::gmp_float_imp<0>
    }
    static void default_precision(unsigned v) BOOST_NOEXCEPT
    {
-      get_default_precision() = v;
+      get_global_default_precision() = v;
+   }
+   static unsigned thread_default_precision() BOOST_NOEXCEPT
+   {
+      return get_thread_default_precision();
+   }
+   static void thread_default_precision(unsigned v) BOOST_NOEXCEPT
+   {
+      get_thread_default_precision() = v;
    }
    unsigned precision()const BOOST_NOEXCEPT
    {
@@ -2239,6 +2265,36 @@ template<>
 struct number_category<detail::canonical<mpf_t, gmp_float<0> >::type> : public mpl::int_<number_kind_floating_point>{};
 
 
+namespace default_ops{
+//
+// Constants are evaluated by binary splitting in mpz_t, and for variable precision
+// types at the current default precision:
+//
+template <unsigned Digits10>
+struct constant_integer<gmp_float<Digits10> >
+{
+   typedef gmp_int type;
+   static void convert(gmp_float<Digits10>& result, const gmp_int& i)
+   {
+      result = i;
+   }
+   static void truncate(gmp_int& result, const gmp_float<Digits10>& f)
+   {
+      result = f;
+   }
+};
+
+template <>
+struct constant_precision<gmp_float<0> >
+{
+   static unsigned value()
+   {
+      return multiprecision::detail::digits10_2_2(gmp_float<0>::default_precision());
+   }
+};
+
+}
+
 typedef number<gmp_float<50> >    mpf_float_50;
 typedef number<gmp_float<100> >   mpf_float_100;
 typedef number<gmp_float<500> >   mpf_float_500;
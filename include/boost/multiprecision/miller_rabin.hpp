@@ -8,6 +8,8 @@
 
 #include <boost/multiprecision/random.hpp>
 #include <boost/multiprecision/integer.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace boost{
 namespace multiprecision{
@@ -132,36 +134,182 @@ typename disable_if_c<is_convertible<I, unsigned>::value, unsigned>::type
    return val.template convert_to<unsigned>();
 }
 
-} // namespace detail
+//
+// A type wide enough to hold the product of two values of type I:
+//
+template <class I>
+struct double_width_integer
+{
+   typedef typename double_integer<I>::type type;
+};
+template <class Backend, expression_template_option ExpressionTemplates>
+struct double_width_integer<number<Backend, ExpressionTemplates> >
+{
+   typedef number<typename default_ops::double_precision_type<Backend>::type, ExpressionTemplates> type;
+};
+
+//
+// The modular arithmetic used by the primality tests, values are held in some internal
+// representation in [0, n) which is preserved by modular_add, modular_subtract and modular_halve
+// below.  The generic version uses ordinary residues, and multiplies with a type of twice the width
+// followed by a remainder operation:
+//
+template <class I, class Enable = void>
+class modular_arithmetic
+{
+public:
+   explicit modular_arithmetic(const I& n) : m_n(n), m_wide(n), m_one(1), m_minus_one(n - 1) {}
 
-template <class I, class Engine>
-typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::type 
-   miller_rabin_test(const I& n, unsigned trials, Engine& gen)
+   const I& modulus()const { return m_n; }
+   const I& one()const { return m_one; }
+   const I& minus_one()const { return m_minus_one; }
+   //
+   // Conversion to the internal representation, a must be in [0, n):
+   //
+   void encode(I& result, const I& a)const { result = a; }
+   void multiply(I& result, const I& a, const I& b)const
+   {
+      typename double_width_integer<I>::type t;
+      boost::multiprecision::multiply(t, a, b);
+      result = static_cast<I>(t % m_wide);
+   }
+   //
+   // result = a^p mod n in the internal representation, where a is an ordinary residue:
+   //
+   void powm(I& result, const I& a, const I& p)const
+   {
+      result = boost::multiprecision::powm(a, p, m_n);
+   }
+private:
+   I m_n;
+   typename double_width_integer<I>::type m_wide;
+   I m_one, m_minus_one;
+};
+//
+// Arbitrary precision and large fixed precision cpp_int's use a single Montgomery context for all
+// the operations on n, so the witness loops never divide:
+//
+template <unsigned MinBits, unsigned MaxBits, cpp_integer_type SignType, cpp_int_check_type Checked, class Allocator, expression_template_option ExpressionTemplates>
+class modular_arithmetic<number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates>,
+   typename enable_if_c<!backends::is_trivial_cpp_int<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator> >::value>::type>
 {
-#ifdef BOOST_MSVC
-#pragma warning(push)
-#pragma warning(disable:4127)
-#endif
-   typedef I number_type;
+public:
+   typedef number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates> number_type;
 
-   if(bit_test(n, 0) == 0 && n != 2)
-      return false;  // n is even
-   if(n <= 227)
-      return detail::is_small_prime(detail::cast_to_unsigned(n));
+   explicit modular_arithmetic(const number_type& n) : m_n(n), m_context(n)
+   {
+      encode(m_one, number_type(1));
+      encode(m_minus_one, number_type(n - 1));
+   }
 
-   if(!detail::check_small_factors(n))
-      return false;
+   const number_type& modulus()const { return m_n; }
+   const number_type& one()const { return m_one; }
+   const number_type& minus_one()const { return m_minus_one; }
 
+   void encode(number_type& result, const number_type& a)const
+   {
+      m_context.to_montgomery(result.backend(), a.backend());
+   }
+   void multiply(number_type& result, const number_type& a, const number_type& b)const
+   {
+      m_context.multiply(result.backend(), a.backend(), b.backend());
+   }
+   void powm(number_type& result, const number_type& a, const number_type& p)const
+   {
+      m_context.powm(result.backend(), a.backend(), p.backend());
+      encode(result, result);
+   }
+private:
+   number_type m_n;
+   montgomery_context<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator> > m_context;
+   number_type m_one, m_minus_one;
+};
+
+//
+// Addition, subtraction and halving modulo n of values in [0, n), these work equally
+// well on ordinary residues or values in Montgomery form, and never form a value greater
+// than n so are safe for fixed precision types:
+//
+template <class I>
+inline void modular_add(I& result, const I& a, const I& b, const I& n)
+{
+   I t(n - b);
+   if(a >= t)
+      result = a - t;
+   else
+      result = a + b;
+}
+template <class I>
+inline void modular_subtract(I& result, const I& a, const I& b, const I& n)
+{
+   if(a >= b)
+      result = a - b;
+   else
+   {
+      I t(n - b);
+      result = a + t;
+   }
+}
+template <class I>
+inline void modular_halve(I& result, const I& a, const I& n)
+{
+   // For odd a, (a + n) / 2 = (a - 1) / 2 + (n + 1) / 2:
+   if(bit_test(a, 0))
+   {
+      I t((n >> 1) + 1);
+      result = a >> 1;
+      result += t;
+   }
+   else
+      result = a >> 1;
+}
+
+//
+// One round of Miller-Rabin with witness x, where n - 1 = q * 2^k:
+//
+template <class I, class Arithmetic>
+bool miller_rabin_witness(const Arithmetic& arith, const I& x, const I& q, unsigned k)
+{
+   I y;
+   arith.powm(y, x, q);
+   unsigned j = 0;
+   while(true)
+   {
+      if(y == arith.minus_one())
+         return true;
+      if(y == arith.one())
+         return j == 0;
+      if(++j == k)
+         return false;
+      arith.multiply(y, y, y);
+   }
+}
+
+//
+// The Fermat test and Miller-Rabin trials, n must be odd, greater than 227 and
+// have no factors in the small prime tables above.  Callers which have already
+// run the Fermat test on n may skip it:
+//
+template <class I, class Engine>
+bool miller_rabin_test_no_small_factors(const I& n, unsigned trials, Engine& gen, bool fermat_test = true)
+{
+   typedef I number_type;
+
+   modular_arithmetic<number_type> arith(n);
    number_type nm1 = n - 1;
-   //
-   // Begin with a single Fermat test - it excludes a lot of candidates:
-   //
-   number_type q(228), x, y; // We know n is greater than this, as we've excluded small factors
-   x = powm(q, nm1, n);
-   if(x != 1u)
-      return false;
+   number_type q, x;
+   if(fermat_test)
+   {
+      //
+      // Begin with a single Fermat test - it excludes a lot of candidates:
+      //
+      q = 228; // We know n is greater than this, as we've excluded small factors
+      arith.powm(x, q, nm1);
+      if(x != arith.one())
+         return false;
+   }
 
-   q = n - 1;
+   q = nm1;
    unsigned k = lsb(q);
    q >>= k;
 
@@ -173,31 +321,312 @@ typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::ty
    for(unsigned i = 0; i < trials; ++i)
    {
       x = dist(gen);
-      y = powm(x, q, n);
-      unsigned j = 0;
-      while(true)
+      if(!miller_rabin_witness(arith, x, q, k))
+         return false;
+   }
+   return true;  // Yeheh! probably prime.
+}
+
+//
+// Jacobi symbol (a/m) for odd m:
+//
+inline int small_jacobi_symbol(unsigned long a, unsigned long m)
+{
+   BOOST_ASSERT(m & 1u);
+   int result = 1;
+   a %= m;
+   while(a)
+   {
+      while((a & 1u) == 0)
       {
-         if(y == nm1)
-            break;
-         if(y == 1)
+         a >>= 1;
+         unsigned r = static_cast<unsigned>(m & 7u);
+         if((r == 3) || (r == 5))
+            result = -result;
+      }
+      std::swap(a, m);
+      if(((a & 3u) == 3) && ((m & 3u) == 3))
+         result = -result;
+      a %= m;
+   }
+   return m == 1 ? result : 0;
+}
+//
+// Jacobi symbol (d/n) for small odd d and large odd n, via quadratic reciprocity:
+//
+template <class I>
+int jacobi_symbol(long d, const I& n)
+{
+   unsigned long a = d < 0 ? static_cast<unsigned long>(-d) : static_cast<unsigned long>(d);
+   bool n_is_3_mod_4 = bit_test(n, 1);
+   int result = small_jacobi_symbol(static_cast<unsigned long>(integer_modulus(n, a)), a);
+   if(n_is_3_mod_4 && ((a & 3u) == 3))
+      result = -result;
+   if((d < 0) && n_is_3_mod_4)
+      result = -result;
+   return result;
+}
+//
+// The residue of a small signed value modulo n:
+//
+template <class I>
+I small_residue(long v, const I& n)
+{
+   if(v >= 0)
+      return I(static_cast<unsigned long>(v));
+   I result(n);
+   result -= static_cast<unsigned long>(-v);
+   return result;
+}
+
+//
+// Strong Lucas probable prime test with parameters chosen by Selfridge's method A,
+// n must be odd, greater than 227 and have no small factors:
+//
+template <class I, class Arithmetic>
+bool strong_lucas_test(const I& n, const Arithmetic& arith)
+{
+   //
+   // Find the first D in 5, -7, 9, -11, ... with (D/n) = -1, no such D exists if
+   // n is a perfect square, so check for that if the search goes on for long:
+   //
+   long d = 5;
+   for(unsigned i = 0;; ++i)
+   {
+      int j = jacobi_symbol(d, n);
+      if(j < 0)
+         break;
+      if(j == 0)
+         return false;
+      if(i == 8)
+      {
+         I r;
+         boost::multiprecision::sqrt(n, r);
+         if(r == 0)
+            return false;
+      }
+      d = d < 0 ? 2 - d : -d - 2;
+   }
+   //
+   // n + 1 = m * 2^s with m odd, calculated without forming n + 1 which might overflow:
+   //
+   I m((n >> 1) + 1);
+   unsigned s = lsb(m);
+   m >>= s;
+   ++s;
+
+   I dd, qq, u, v, qk, t;
+   arith.encode(dd, small_residue(d, n));
+   arith.encode(qq, small_residue((1 - d) / 4, n));
+   //
+   // Left to right evaluation of U_m, V_m and Q^m with P = 1, starting from U_1 = V_1 = 1:
+   //
+   u = arith.one();
+   v = u;
+   qk = qq;
+   for(int bit = static_cast<int>(msb(m)) - 1; bit >= 0; --bit)
+   {
+      // U_2k = U_k * V_k, V_2k = V_k^2 - 2Q^k:
+      arith.multiply(u, u, v);
+      arith.multiply(v, v, v);
+      modular_subtract(v, v, qk, n);
+      modular_subtract(v, v, qk, n);
+      arith.multiply(qk, qk, qk);
+      if(bit_test(m, bit))
+      {
+         // U_k+1 = (U_k + V_k) / 2, V_k+1 = (D * U_k + V_k) / 2:
+         arith.multiply(t, dd, u);
+         modular_add(t, t, v, n);
+         modular_add(u, u, v, n);
+         modular_halve(u, u, n);
+         modular_halve(v, t, n);
+         arith.multiply(qk, qk, qq);
+      }
+   }
+   if((u == 0) || (v == 0))
+      return true;
+   for(unsigned r = 1; r < s; ++r)
+   {
+      arith.multiply(v, v, v);
+      modular_subtract(v, v, qk, n);
+      modular_subtract(v, v, qk, n);
+      if(v == 0)
+         return true;
+      arith.multiply(qk, qk, qk);
+   }
+   return false;
+}
+
+//
+// The odd primes used to sieve candidates in next_probable_prime and next_safe_prime, along with
+// products of consecutive primes which fit in 32 bits, so that the residues of a large
+// candidate modulo every prime can be found with as few calls to integer_modulus as possible:
+//
+struct sieve_prime_table
+{
+   static const boost::uint32_t limit = 4096;
+
+   std::vector<boost::uint32_t> primes;
+   std::vector<boost::uint32_t> products;
+   std::vector<unsigned> product_ends;  // Index one past the last prime in each product.
+
+   sieve_prime_table()
+   {
+      std::vector<unsigned char> composite(limit, 0);
+      for(boost::uint32_t i = 3; i < limit; i += 2)
+      {
+         if(composite[i])
+            continue;
+         primes.push_back(i);
+         for(boost::uint32_t j = i * i; j < limit; j += 2 * i)
+            composite[j] = 1;
+      }
+      boost::uint64_t p = 1;
+      for(unsigned i = 0; i < primes.size(); ++i)
+      {
+         if(p * primes[i] > (std::numeric_limits<boost::uint32_t>::max)())
          {
-            if(j == 0)
-               break;
-            return false; // test failed
+            products.push_back(static_cast<boost::uint32_t>(p));
+            product_ends.push_back(i);
+            p = 1;
          }
-         if(++j == k)
-            return false; // failed
-         y = powm(y, 2, n);
+         p *= primes[i];
       }
+      products.push_back(static_cast<boost::uint32_t>(p));
+      product_ends.push_back(static_cast<unsigned>(primes.size()));
    }
-   return true;  // Yeheh! probably prime.
+   static const sieve_prime_table& get()
+   {
+      static const sieve_prime_table table;
+      return table;
+   }
+};
+
+//
+// Number of odd candidates sieved at once:
+//
+static const unsigned sieve_window_size = 2048;
+
+//
+// Finds the smallest value >= n (n odd and greater than the largest sieving prime) which has
+// no factor in the sieve table, and for which the predicate returns true.  When "safe" is set
+// we also exclude candidates c for which (c - 1) / 2 has a small factor, or is even:
+//
+template <class I, class Predicate>
+I sieve_candidates(const I& n, bool safe, Predicate pred)
+{
+   const sieve_prime_table& table = sieve_prime_table::get();
+   //
+   // Residues of the start of the window modulo each prime, found with one integer_modulus
+   // call per product of primes:
+   //
+   std::vector<boost::uint32_t> residues(table.primes.size());
+   unsigned first = 0;
+   for(unsigned i = 0; i < table.products.size(); ++i)
+   {
+      boost::uint32_t r = integer_modulus(n, table.products[i]);
+      for(; first < table.product_ends[i]; ++first)
+         residues[first] = r % table.primes[first];
+   }
+   unsigned start_mod_4 = bit_test(n, 1) ? 3 : 1;
+
+   std::vector<unsigned char> composite(sieve_window_size);
+   I base(n), candidate;
+   while(true)
+   {
+      //
+      // Candidate j in the window is base + 2j, which is divisible by p when
+      // 2j = -r mod p, ie j = (p - r) * (p + 1) / 2 mod p:
+      //
+      std::fill(composite.begin(), composite.end(), static_cast<unsigned char>(0));
+      for(unsigned i = 0; i < table.primes.size(); ++i)
+      {
+         boost::uint32_t p = table.primes[i];
+         boost::uint32_t half = (p + 1) / 2;
+         boost::uint32_t r = residues[i];
+         for(boost::uint32_t j = ((p - r) % p) * half % p; j < sieve_window_size; j += p)
+            composite[j] = 1;
+         if(safe)
+         {
+            // (c - 1) / 2 is divisible by p when c = 1 mod p:
+            for(boost::uint32_t j = ((p + 1 - r) % p) * half % p; j < sieve_window_size; j += p)
+               composite[j] = 1;
+         }
+      }
+      for(unsigned j = 0; j < sieve_window_size; ++j)
+      {
+         if(composite[j])
+            continue;
+         if(safe && (((start_mod_4 + 2 * j) & 3u) != 3))
+            continue;
+         candidate = base;
+         candidate += 2 * j;
+         if(pred(candidate))
+            return candidate;
+      }
+      base += 2 * sieve_window_size;
+      for(unsigned i = 0; i < table.primes.size(); ++i)
+         residues[i] = (residues[i] + 2 * sieve_window_size) % table.primes[i];
+   }
+}
+
+template <class I, class Engine>
+struct probable_prime_predicate
+{
+   probable_prime_predicate(unsigned t, Engine& g) : trials(t), gen(g) {}
+   bool operator()(const I& n)const
+   {
+      return miller_rabin_test_no_small_factors(n, trials, gen);
+   }
+   unsigned trials;
+   Engine& gen;
+};
+template <class I, class Engine>
+struct safe_prime_predicate
+{
+   safe_prime_predicate(unsigned t, Engine& g) : trials(t), gen(g) {}
+   bool operator()(const I& n)const
+   {
+      I half(n >> 1);
+      //
+      // Single Fermat tests on both values first, as nearly all candidates fail one or the other,
+      // then the Miller-Rabin trials on each without repeating the Fermat tests:
+      //
+      return miller_rabin_test_no_small_factors(n, 0, gen)
+         && miller_rabin_test_no_small_factors(half, 0, gen)
+         && miller_rabin_test_no_small_factors(n, trials, gen, false)
+         && miller_rabin_test_no_small_factors(half, trials, gen, false);
+   }
+   unsigned trials;
+   Engine& gen;
+};
+
+} // namespace detail
+
+template <class I, class Engine>
+typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::type
+   miller_rabin_test(const I& n, unsigned trials, Engine& gen)
+{
+#ifdef BOOST_MSVC
+#pragma warning(push)
+#pragma warning(disable:4127)
+#endif
+   if(bit_test(n, 0) == 0 && n != 2)
+      return false;  // n is even
+   if(n <= 227)
+      return detail::is_small_prime(detail::cast_to_unsigned(n));
+
+   if(!detail::check_small_factors(n))
+      return false;
+
+   return detail::miller_rabin_test_no_small_factors(n, trials, gen);
 #ifdef BOOST_MSVC
 #pragma warning(pop)
 #endif
 }
 
 template <class I>
-typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::type 
+typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::type
    miller_rabin_test(const I& x, unsigned trials)
 {
    static mt19937 gen;
@@ -218,6 +647,132 @@ bool miller_rabin_test(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4> & n
    return miller_rabin_test(number_type(n), trials);
 }
 
+//
+// Baillie-PSW test: a Miller-Rabin test to base 2 followed by a strong Lucas test, there are
+// no known composites which pass, and none below 2^64:
+//
+template <class I>
+typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::type
+   baillie_psw_test(const I& n)
+{
+   typedef I number_type;
+
+   if(bit_test(n, 0) == 0 && n != 2)
+      return false;  // n is even
+   if(n <= 227)
+      return detail::is_small_prime(detail::cast_to_unsigned(n));
+
+   if(!detail::check_small_factors(n))
+      return false;
+
+   detail::modular_arithmetic<number_type> arith(n);
+   number_type q = n - 1;
+   unsigned k = lsb(q);
+   q >>= k;
+   if(!detail::miller_rabin_witness(arith, number_type(2), q, k))
+      return false;
+   return detail::strong_lucas_test(n, arith);
+}
+
+template <class tag, class Arg1, class Arg2, class Arg3, class Arg4>
+bool baillie_psw_test(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4> & n)
+{
+   typedef typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type number_type;
+   return baillie_psw_test(number_type(n));
+}
+
+//
+// Returns the smallest probable prime greater than or equal to n.  Candidates are sieved a window
+// at a time against a table of small primes, so only those with no small factors are tested:
+//
+template <class I, class Engine>
+typename enable_if_c<number_category<I>::value == number_kind_integer, I>::type
+   next_probable_prime(const I& n, unsigned trials, Engine& gen)
+{
+   const std::vector<boost::uint32_t>& primes = detail::sieve_prime_table::get().primes;
+   if(n <= 2)
+      return I(2);
+   if(n <= primes.back())
+      return I(*std::lower_bound(primes.begin(), primes.end(), detail::cast_to_unsigned(n)));
+   I start(n);
+   if(!bit_test(start, 0))
+      ++start;
+   return detail::sieve_candidates(start, false, detail::probable_prime_predicate<I, Engine>(trials, gen));
+}
+
+template <class I>
+typename enable_if_c<number_category<I>::value == number_kind_integer, I>::type
+   next_probable_prime(const I& n, unsigned trials)
+{
+   static mt19937 gen;
+   return next_probable_prime(n, trials, gen);
+}
+
+template <class tag, class Arg1, class Arg2, class Arg3, class Arg4, class Engine>
+typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type
+   next_probable_prime(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4> & n, unsigned trials, Engine& gen)
+{
+   typedef typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type number_type;
+   return next_probable_prime(number_type(n), trials, gen);
+}
+
+template <class tag, class Arg1, class Arg2, class Arg3, class Arg4>
+typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type
+   next_probable_prime(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4> & n, unsigned trials)
+{
+   typedef typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type number_type;
+   return next_probable_prime(number_type(n), trials);
+}
+
+//
+// Returns the smallest safe prime p >= n, that is a probable prime p for which (p - 1) / 2 is
+// also a probable prime:
+//
+template <class I, class Engine>
+typename enable_if_c<number_category<I>::value == number_kind_integer, I>::type
+   next_safe_prime(const I& n, unsigned trials, Engine& gen)
+{
+   const std::vector<boost::uint32_t>& primes = detail::sieve_prime_table::get().primes;
+   I start(n);
+   if(start <= 5)
+      return I(5);
+   if(!bit_test(start, 0))
+      ++start;
+   //
+   // The sieve would reject p with (p - 1) / 2 in the prime table, so test small values directly:
+   //
+   for(; start <= 2 * primes.back() + 1; start += 2)
+   {
+      if(miller_rabin_test(start, trials, gen) && miller_rabin_test(I(start >> 1), trials, gen))
+         return start;
+   }
+   return detail::sieve_candidates(start, true, detail::safe_prime_predicate<I, Engine>(trials, gen));
+}
+
+template <class I>
+typename enable_if_c<number_category<I>::value == number_kind_integer, I>::type
+   next_safe_prime(const I& n, unsigned trials)
+{
+   static mt19937 gen;
+   return next_safe_prime(n, trials, gen);
+}
+
+template <class tag, class Arg1, class Arg2, class Arg3, class Arg4, class Engine>
+typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type
+   next_safe_prime(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4> & n, unsigned trials, Engine& gen)
+{
+   typedef typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type number_type;
+   return next_safe_prime(number_type(n), trials, gen);
+}
+
+template <class tag, class Arg1, class Arg2, class Arg3, class Arg4>
+typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type
+   next_safe_prime(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4> & n, unsigned trials)
+{
+   typedef typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type number_type;
+   return next_safe_prime(number_type(n), trials);
+}
+
 }} // namespaces
 
 #endif
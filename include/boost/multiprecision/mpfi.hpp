@@ -313,11 +313,29 @@ struct mpfi_float_imp
    }
 protected:
    mpfi_t m_data;
-   static unsigned& get_default_precision() BOOST_NOEXCEPT
+   //
+   // The default precision is process wide, unless overridden for the current thread
+   // by a non-zero thread default precision:
+   //
+   static unsigned& get_global_default_precision() BOOST_NOEXCEPT
    {
       static unsigned val = 50;
       return val;
    }
+   static unsigned& get_thread_default_precision() BOOST_NOEXCEPT
+   {
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+      static thread_local unsigned val = 0;
+#else
+      static unsigned val = 0;
+#endif
+      return val;
+   }
+   static unsigned get_default_precision() BOOST_NOEXCEPT
+   {
+      unsigned v = get_thread_default_precision();
+      return v ? v : get_global_default_precision();
+   }
 };
 
 } // namespace detail
@@ -459,7 +477,15 @@ struct mpfi_float_backend<0> : public detail::mpfi_float_imp<0>
    }
    static void default_precision(unsigned v) BOOST_NOEXCEPT
    {
-      get_default_precision() = v;
+      get_global_default_precision() = v;
+   }
+   static unsigned thread_default_precision() BOOST_NOEXCEPT
+   {
+      return get_thread_default_precision();
+   }
+   static void thread_default_precision(unsigned v) BOOST_NOEXCEPT
+   {
+      get_thread_default_precision() = v;
    }
    unsigned precision()const BOOST_NOEXCEPT
    {
@@ -963,6 +989,14 @@ inline void eval_cos(mpfi_float_backend<Digits10>& result, const mpfi_float_back
    mpfi_cos(result.data(), arg.data());
 }
 
+template <unsigned Digits10>
+inline void eval_sincos(mpfi_float_backend<Digits10>& s, mpfi_float_backend<Digits10>& c, const mpfi_float_backend<Digits10>& arg)
+{
+   mpfi_float_backend<Digits10> t(arg);
+   mpfi_sin(s.data(), t.data());
+   mpfi_cos(c.data(), t.data());
+}
+
 template <unsigned Digits10>
 inline void eval_tan(mpfi_float_backend<Digits10>& result, const mpfi_float_backend<Digits10>& arg)
 {
@@ -1029,6 +1063,21 @@ struct number_category<detail::canonical<mpfi_t, backends::mpfi_float_backend<0>
 template <unsigned Digits10>
 struct is_interval_number<backends::mpfi_float_backend<Digits10> > : public mpl::true_ {};
 
+namespace default_ops{
+//
+// Any generic constants needed are computed at the current default precision:
+//
+template <>
+struct constant_precision<backends::mpfi_float_backend<0> >
+{
+   static unsigned value()
+   {
+      return multiprecision::detail::digits10_2_2(backends::mpfi_float_backend<0>::default_precision());
+   }
+};
+
+}
+
 using boost::multiprecision::backends::mpfi_float_backend;
 
 typedef number<mpfi_float_backend<50> >    mpfi_float_50;
@@ -1190,6 +1239,41 @@ struct mpfi_initializer
 template <class T>
 const typename mpfi_initializer<T>::init mpfi_initializer<T>::initializer;
 
+//
+// Computes a constant with one of the mpfi_const_* functions, used to initialize the
+// function local statics below so that their initialization is thread safe:
+//
+template <class T, class F>
+inline T mpfi_get_constant(F f)
+{
+   T result;
+   f(result.backend().data());
+   return result;
+}
+//
+// The variable precision type holds one value of each constant for each precision asked for, since
+// the default precision may differ from one thread or scope to the next.  Assignment copies the
+// precision of the source, so the rounding of a cached value to a lower precision is done here:
+//
+template <class T, int (*F)(mpfi_ptr)>
+inline void mpfi_calc_constant(T& result, unsigned digits2)
+{
+   mpfi_set_prec(result.backend().data(), digits2);
+   F(result.backend().data());
+}
+template <class T>
+inline void mpfi_round_constant(T& result, const T& src, unsigned /*src_digits2*/, unsigned digits2)
+{
+   mpfi_set_prec(result.backend().data(), digits2);
+   mpfi_set(result.backend().data(), src.backend().data());
+}
+template <class T, int (*F)(mpfi_ptr)>
+inline const T& mpfi_get_cached_constant()
+{
+   static boost::multiprecision::default_ops::constant_cache<T, &mpfi_calc_constant<T, F>, &mpfi_round_constant<T> > cache;
+   return cache.get(boost::multiprecision::default_ops::constant_precision<typename T::backend_type>::value());
+}
+
 template<unsigned Digits10, boost::multiprecision::expression_template_option ExpressionTemplates>
 struct constant_pi<boost::multiprecision::number<boost::multiprecision::mpfi_float_backend<Digits10>, ExpressionTemplates> >
 {
@@ -1198,13 +1282,7 @@ struct constant_pi<boost::multiprecision::number<boost::multiprecision::mpfi_flo
    static inline result_type const& get(const mpl::int_<N>&)
    {
       mpfi_initializer<result_type>::force_instantiate();
-      static result_type result;
-      static bool has_init = false;
-      if(!has_init)
-      {
-         has_init = true;
-         mpfi_const_pi(result.backend().data());
-      }
+      static const result_type result(mpfi_get_constant<result_type>(&mpfi_const_pi));
       return result;
    }
 };
@@ -1216,13 +1294,7 @@ struct constant_ln_two<boost::multiprecision::number<boost::multiprecision::mpfi
    static inline result_type const& get(const mpl::int_<N>&)
    {
       mpfi_initializer<result_type>::force_instantiate();
-      static result_type result;
-      static bool has_init = false;
-      if(!has_init)
-      {
-         has_init = true;
-         mpfi_const_log2(result.backend().data());
-      }
+      static const result_type result(mpfi_get_constant<result_type>(&mpfi_const_log2));
       return result;
    }
 };
@@ -1234,13 +1306,7 @@ struct constant_euler<boost::multiprecision::number<boost::multiprecision::mpfi_
    static inline result_type const& get(const mpl::int_<N>&)
    {
       mpfi_initializer<result_type>::force_instantiate();
-      static result_type result;
-      static bool has_init = false;
-      if(!has_init)
-      {
-         has_init = true;
-         mpfi_const_euler(result.backend().data());
-      }
+      static const result_type result(mpfi_get_constant<result_type>(&mpfi_const_euler));
       return result;
    }
 };
@@ -1252,16 +1318,50 @@ struct constant_catalan<boost::multiprecision::number<boost::multiprecision::mpf
    static inline result_type const& get(const mpl::int_<N>&)
    {
       mpfi_initializer<result_type>::force_instantiate();
-      static result_type result;
-      static bool has_init = false;
-      if(!has_init)
-      {
-         has_init = true;
-         mpfi_const_catalan(result.backend().data());
-      }
+      static const result_type result(mpfi_get_constant<result_type>(&mpfi_const_catalan));
       return result;
    }
 };
+template<boost::multiprecision::expression_template_option ExpressionTemplates>
+struct constant_pi<boost::multiprecision::number<boost::multiprecision::mpfi_float_backend<0>, ExpressionTemplates> >
+{
+   typedef boost::multiprecision::number<boost::multiprecision::mpfi_float_backend<0>, ExpressionTemplates> result_type;
+   template<int N>
+   static inline result_type const& get(const mpl::int_<N>&)
+   {
+      return mpfi_get_cached_constant<result_type, &mpfi_const_pi>();
+   }
+};
+template<boost::multiprecision::expression_template_option ExpressionTemplates>
+struct constant_ln_two<boost::multiprecision::number<boost::multiprecision::mpfi_float_backend<0>, ExpressionTemplates> >
+{
+   typedef boost::multiprecision::number<boost::multiprecision::mpfi_float_backend<0>, ExpressionTemplates> result_type;
+   template<int N>
+   static inline result_type const& get(const mpl::int_<N>&)
+   {
+      return mpfi_get_cached_constant<result_type, &mpfi_const_log2>();
+   }
+};
+template<boost::multiprecision::expression_template_option ExpressionTemplates>
+struct constant_euler<boost::multiprecision::number<boost::multiprecision::mpfi_float_backend<0>, ExpressionTemplates> >
+{
+   typedef boost::multiprecision::number<boost::multiprecision::mpfi_float_backend<0>, ExpressionTemplates> result_type;
+   template<int N>
+   static inline result_type const& get(const mpl::int_<N>&)
+   {
+      return mpfi_get_cached_constant<result_type, &mpfi_const_euler>();
+   }
+};
+template<boost::multiprecision::expression_template_option ExpressionTemplates>
+struct constant_catalan<boost::multiprecision::number<boost::multiprecision::mpfi_float_backend<0>, ExpressionTemplates> >
+{
+   typedef boost::multiprecision::number<boost::multiprecision::mpfi_float_backend<0>, ExpressionTemplates> result_type;
+   template<int N>
+   static inline result_type const& get(const mpl::int_<N>&)
+   {
+      return mpfi_get_cached_constant<result_type, &mpfi_const_catalan>();
+   }
+};
 
 }} // namespaces
 
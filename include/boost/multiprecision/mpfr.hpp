@@ -355,11 +355,29 @@ struct mpfr_float_imp<digits10, allocate_dynamic>
    }
 protected:
    mpfr_t m_data;
-   static unsigned& get_default_precision() BOOST_NOEXCEPT
+   //
+   // The default precision is process wide, unless overridden for the current thread
+   // by a non-zero thread default precision:
+   //
+   static unsigned& get_global_default_precision() BOOST_NOEXCEPT
    {
       static unsigned val = 50;
       return val;
    }
+   static unsigned& get_thread_default_precision() BOOST_NOEXCEPT
+   {
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+      static thread_local unsigned val = 0;
+#else
+      static unsigned val = 0;
+#endif
+      return val;
+   }
+   static unsigned get_default_precision() BOOST_NOEXCEPT
+   {
+      unsigned v = get_thread_default_precision();
+      return v ? v : get_global_default_precision();
+   }
 };
 
 #ifdef BOOST_MSVC
@@ -926,7 +944,15 @@ struct mpfr_float_backend<0, allocate_dynamic> : public detail::mpfr_float_imp<0
    }
    static void default_precision(unsigned v) BOOST_NOEXCEPT
    {
-      get_default_precision() = v;
+      get_global_default_precision() = v;
+   }
+   static unsigned thread_default_precision() BOOST_NOEXCEPT
+   {
+      return get_thread_default_precision();
+   }
+   static void thread_default_precision(unsigned v) BOOST_NOEXCEPT
+   {
+      get_thread_default_precision() = v;
    }
    unsigned precision()const BOOST_NOEXCEPT
    {
@@ -1372,6 +1398,12 @@ inline void eval_cos(mpfr_float_backend<Digits10, AllocateType>& result, const m
    mpfr_cos(result.data(), arg.data(), GMP_RNDN);
 }
 
+template <unsigned Digits10, mpfr_allocation_type AllocateType>
+inline void eval_sincos(mpfr_float_backend<Digits10, AllocateType>& s, mpfr_float_backend<Digits10, AllocateType>& c, const mpfr_float_backend<Digits10, AllocateType>& arg)
+{
+   mpfr_sin_cos(s.data(), c.data(), arg.data(), GMP_RNDN);
+}
+
 template <unsigned Digits10, mpfr_allocation_type AllocateType>
 inline void eval_tan(mpfr_float_backend<Digits10, AllocateType>& result, const mpfr_float_backend<Digits10, AllocateType>& arg)
 {
@@ -1436,6 +1468,21 @@ struct is_explicitly_convertible<backends::mpfr_float_backend<D1, A1>, backends:
 template<>
 struct number_category<detail::canonical<mpfr_t, backends::mpfr_float_backend<0> >::type> : public mpl::int_<number_kind_floating_point>{};
 
+namespace default_ops{
+//
+// Any generic constants needed are computed at the current default precision:
+//
+template <mpfr_allocation_type AllocationType>
+struct constant_precision<backends::mpfr_float_backend<0, AllocationType> >
+{
+   static unsigned value()
+   {
+      return multiprecision::detail::digits10_2_2(backends::mpfr_float_backend<0, AllocationType>::default_precision());
+   }
+};
+
+}
+
 using boost::multiprecision::backends::mpfr_float_backend;
 
 typedef number<mpfr_float_backend<50> >    mpfr_float_50;
@@ -1497,6 +1544,41 @@ namespace detail{
    template <class T, int N>
    typename mpfr_constant_initializer<T, N>::initializer const mpfr_constant_initializer<T, N>::init;
 
+   //
+   // Computes a constant with one of the mpfr_const_* functions, used to initialize the
+   // function local statics below so that their initialization is thread safe:
+   //
+   template <class T, class F>
+   inline T mpfr_get_constant(F f)
+   {
+      T result;
+      f(result.backend().data(), GMP_RNDN);
+      return result;
+   }
+   //
+   // The variable precision types hold one value of each constant for each precision asked for, since
+   // the default precision may differ from one thread or scope to the next.  Assignment copies the
+   // precision of the source, so the rounding of a cached value to a lower precision is done here:
+   //
+   template <class T, int (*F)(mpfr_ptr, mp_rnd_t)>
+   inline void mpfr_calc_constant(T& result, unsigned digits2)
+   {
+      mpfr_set_prec(result.backend().data(), digits2);
+      F(result.backend().data(), GMP_RNDN);
+   }
+   template <class T>
+   inline void mpfr_round_constant(T& result, const T& src, unsigned /*src_digits2*/, unsigned digits2)
+   {
+      mpfr_set_prec(result.backend().data(), digits2);
+      mpfr_set(result.backend().data(), src.backend().data(), GMP_RNDN);
+   }
+   template <class T, int (*F)(mpfr_ptr, mp_rnd_t)>
+   inline const T& mpfr_get_cached_constant()
+   {
+      static boost::multiprecision::default_ops::constant_cache<T, &mpfr_calc_constant<T, F>, &mpfr_round_constant<T> > cache;
+      return cache.get(boost::multiprecision::default_ops::constant_precision<typename T::backend_type>::value());
+   }
+
 }
 
 template<unsigned Digits10, boost::multiprecision::mpfr_allocation_type AllocateType, boost::multiprecision::expression_template_option ExpressionTemplates>
@@ -1507,13 +1589,7 @@ struct constant_pi<boost::multiprecision::number<boost::multiprecision::mpfr_flo
    static inline const result_type& get(const mpl::int_<N>&)
    {
       detail::mpfr_constant_initializer<constant_pi<boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<Digits10, AllocateType>, ExpressionTemplates> >, N>::force_instantiate();
-      static result_type result;
-      static bool has_init = false;
-      if(!has_init)
-      {
-         mpfr_const_pi(result.backend().data(), GMP_RNDN);
-         has_init = true;
-      }
+      static const result_type result(detail::mpfr_get_constant<result_type>(&mpfr_const_pi));
       return result;
    }
 };
@@ -1525,13 +1601,7 @@ struct constant_ln_two<boost::multiprecision::number<boost::multiprecision::mpfr
    static inline const result_type& get(const mpl::int_<N>&)
    {
       detail::mpfr_constant_initializer<constant_ln_two<boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<Digits10, AllocateType>, ExpressionTemplates> >, N>::force_instantiate();
-      static result_type result;
-      static bool init = false;
-      if(!init)
-      {
-         mpfr_const_log2(result.backend().data(), GMP_RNDN);
-         init = true;
-      }
+      static const result_type result(detail::mpfr_get_constant<result_type>(&mpfr_const_log2));
       return result;
    }
 };
@@ -1543,13 +1613,7 @@ struct constant_euler<boost::multiprecision::number<boost::multiprecision::mpfr_
    static inline const result_type& get(const mpl::int_<N>&)
    {
       detail::mpfr_constant_initializer<constant_euler<boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<Digits10, AllocateType>, ExpressionTemplates> >, N>::force_instantiate();
-      static result_type result;
-      static bool init = false;
-      if(!init)
-      {
-         mpfr_const_euler(result.backend().data(), GMP_RNDN);
-         init = true;
-      }
+      static const result_type result(detail::mpfr_get_constant<result_type>(&mpfr_const_euler));
       return result;
    }
 };
@@ -1561,16 +1625,50 @@ struct constant_catalan<boost::multiprecision::number<boost::multiprecision::mpf
    static inline const result_type& get(const mpl::int_<N>&)
    {
       detail::mpfr_constant_initializer<constant_catalan<boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<Digits10, AllocateType>, ExpressionTemplates> >, N>::force_instantiate();
-      static result_type result;
-      static bool init = false;
-      if(!init)
-      {
-         mpfr_const_catalan(result.backend().data(), GMP_RNDN);
-         init = true;
-      }
+      static const result_type result(detail::mpfr_get_constant<result_type>(&mpfr_const_catalan));
       return result;
    }
 };
+template<boost::multiprecision::mpfr_allocation_type AllocateType, boost::multiprecision::expression_template_option ExpressionTemplates>
+struct constant_pi<boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<0, AllocateType>, ExpressionTemplates> >
+{
+   typedef boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<0, AllocateType>, ExpressionTemplates> result_type;
+   template<int N>
+   static inline const result_type& get(const mpl::int_<N>&)
+   {
+      return detail::mpfr_get_cached_constant<result_type, &mpfr_const_pi>();
+   }
+};
+template<boost::multiprecision::mpfr_allocation_type AllocateType, boost::multiprecision::expression_template_option ExpressionTemplates>
+struct constant_ln_two<boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<0, AllocateType>, ExpressionTemplates> >
+{
+   typedef boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<0, AllocateType>, ExpressionTemplates> result_type;
+   template<int N>
+   static inline const result_type& get(const mpl::int_<N>&)
+   {
+      return detail::mpfr_get_cached_constant<result_type, &mpfr_const_log2>();
+   }
+};
+template<boost::multiprecision::mpfr_allocation_type AllocateType, boost::multiprecision::expression_template_option ExpressionTemplates>
+struct constant_euler<boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<0, AllocateType>, ExpressionTemplates> >
+{
+   typedef boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<0, AllocateType>, ExpressionTemplates> result_type;
+   template<int N>
+   static inline const result_type& get(const mpl::int_<N>&)
+   {
+      return detail::mpfr_get_cached_constant<result_type, &mpfr_const_euler>();
+   }
+};
+template<boost::multiprecision::mpfr_allocation_type AllocateType, boost::multiprecision::expression_template_option ExpressionTemplates>
+struct constant_catalan<boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<0, AllocateType>, ExpressionTemplates> >
+{
+   typedef boost::multiprecision::number<boost::multiprecision::mpfr_float_backend<0, AllocateType>, ExpressionTemplates> result_type;
+   template<int N>
+   static inline const result_type& get(const mpl::int_<N>&)
+   {
+      return detail::mpfr_get_cached_constant<result_type, &mpfr_const_catalan>();
+   }
+};
 
 }} // namespaces
 
@@ -652,6 +652,14 @@ public:
    {
       Backend::default_precision(digits10);
    }
+   static unsigned thread_default_precision() BOOST_NOEXCEPT
+   {
+      return Backend::thread_default_precision();
+   }
+   static void thread_default_precision(unsigned digits10)
+   {
+      Backend::thread_default_precision(digits10);
+   }
    unsigned precision()const BOOST_NOEXCEPT
    {
       return m_backend.precision();
@@ -688,7 +696,141 @@ private:
    template <class tag, class Arg1, class Arg2, class Arg3, class Arg4>
    void do_assign(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4>& e, const mpl::true_&)
    {
-      do_assign(e, tag());
+      typedef typename detail::is_fused_sum_of_products<detail::expression<tag, Arg1, Arg2, Arg3, Arg4>, self_type>::type fused_type;
+      do_assign_fused(e, fused_type());
+   }
+   template <class Exp>
+   void do_assign_fused(const Exp& e, const mpl::false_&)
+   {
+      do_assign(e, typename Exp::tag_type());
+   }
+   template <class Exp>
+   void do_assign_fused(const Exp& e, const mpl::true_&)
+   {
+      //
+      // A sum of products such as a*b + c*d - e*f: accumulate every term in the
+      // sum_of_products_accumulator type, without creating a temporary for each product:
+      //
+      typedef typename sum_of_products_accumulator<Backend>::type accumulator_type;
+      do_assign_sum_of_products(e, typename is_same<accumulator_type, Backend>::type());
+   }
+   template <class Exp>
+   void do_assign_sum_of_products(const Exp& e, const mpl::true_&)
+   {
+      if(contains_self(e))
+      {
+         self_type temp(e);
+         temp.swap(*this);
+      }
+      else
+         accumulate_products_first(e, false, typename Exp::tag_type());
+   }
+   template <class Exp>
+   void do_assign_sum_of_products(const Exp& e, const mpl::false_&)
+   {
+      //
+      // The accumulator is a separate variable, so there are no aliasing issues with *this,
+      // and the result is rounded just once at the end:
+      //
+      typedef typename sum_of_products_accumulator<Backend>::type accumulator_type;
+      typedef typename mpl::front<typename accumulator_type::unsigned_types>::type ui_type;
+      accumulator_type acc;
+      acc = static_cast<ui_type>(0u);
+      accumulate_products(acc, e, false, typename Exp::tag_type());
+      m_backend = acc;
+   }
+   //
+   // When accumulating in our own type the left most term is assigned to m_backend, rather than added to zero:
+   //
+   template <class Exp>
+   void accumulate_products_first(const Exp& e, bool subtract, const detail::terminal&)
+   {
+      m_backend = canonical_value(e.value());
+      if(subtract)
+         m_backend.negate();
+   }
+   template <class Exp>
+   void accumulate_products_first(const Exp& e, bool subtract, const detail::multiply_immediates&)
+   {
+      do_assign(e, detail::multiply_immediates());
+      if(subtract)
+         m_backend.negate();
+   }
+   template <class Exp>
+   void accumulate_products_first(const Exp& e, bool subtract, const detail::multiply_add&)
+   {
+      do_assign(e, detail::multiply_add());
+      if(subtract)
+         m_backend.negate();
+   }
+   template <class Exp>
+   void accumulate_products_first(const Exp& e, bool subtract, const detail::multiply_subtract&)
+   {
+      do_assign(e, detail::multiply_subtract());
+      if(subtract)
+         m_backend.negate();
+   }
+   template <class Exp>
+   void accumulate_products_first(const Exp& e, bool subtract, const detail::negate&)
+   {
+      accumulate_products_first(e.left(), !subtract, typename Exp::left_type::tag_type());
+   }
+   template <class Exp>
+   void accumulate_products_first(const Exp& e, bool subtract, const detail::plus&)
+   {
+      accumulate_products_first(e.left(), subtract, typename Exp::left_type::tag_type());
+      accumulate_products(m_backend, e.right(), subtract, typename Exp::right_type::tag_type());
+   }
+   template <class Exp>
+   void accumulate_products_first(const Exp& e, bool subtract, const detail::minus&)
+   {
+      accumulate_products_first(e.left(), subtract, typename Exp::left_type::tag_type());
+      accumulate_products(m_backend, e.right(), !subtract, typename Exp::right_type::tag_type());
+   }
+   template <class Acc, class Exp>
+   static void accumulate_products(Acc& acc, const Exp& e, bool subtract, const detail::terminal&)
+   {
+      using default_ops::eval_accumulate;
+      eval_accumulate(acc, canonical_value(e.value()), subtract);
+   }
+   template <class Acc, class Exp>
+   static void accumulate_products(Acc& acc, const Exp& e, bool subtract, const detail::multiply_immediates&)
+   {
+      using default_ops::eval_accumulate_product;
+      eval_accumulate_product(acc, canonical_value(e.left().value()), canonical_value(e.right().value()), subtract);
+   }
+   template <class Acc, class Exp>
+   static void accumulate_products(Acc& acc, const Exp& e, bool subtract, const detail::multiply_add&)
+   {
+      using default_ops::eval_accumulate_product;
+      using default_ops::eval_accumulate;
+      eval_accumulate_product(acc, canonical_value(e.left().value()), canonical_value(e.middle().value()), subtract);
+      eval_accumulate(acc, canonical_value(e.right().value()), subtract);
+   }
+   template <class Acc, class Exp>
+   static void accumulate_products(Acc& acc, const Exp& e, bool subtract, const detail::multiply_subtract&)
+   {
+      using default_ops::eval_accumulate_product;
+      using default_ops::eval_accumulate;
+      eval_accumulate_product(acc, canonical_value(e.left().value()), canonical_value(e.middle().value()), subtract);
+      eval_accumulate(acc, canonical_value(e.right().value()), !subtract);
+   }
+   template <class Acc, class Exp>
+   static void accumulate_products(Acc& acc, const Exp& e, bool subtract, const detail::negate&)
+   {
+      accumulate_products(acc, e.left(), !subtract, typename Exp::left_type::tag_type());
+   }
+   template <class Acc, class Exp>
+   static void accumulate_products(Acc& acc, const Exp& e, bool subtract, const detail::plus&)
+   {
+      accumulate_products(acc, e.left(), subtract, typename Exp::left_type::tag_type());
+      accumulate_products(acc, e.right(), subtract, typename Exp::right_type::tag_type());
+   }
+   template <class Acc, class Exp>
+   static void accumulate_products(Acc& acc, const Exp& e, bool subtract, const detail::minus&)
+   {
+      accumulate_products(acc, e.left(), subtract, typename Exp::left_type::tag_type());
+      accumulate_products(acc, e.right(), !subtract, typename Exp::right_type::tag_type());
    }
    template <class tag, class Arg1, class Arg2, class Arg3, class Arg4>
    void do_assign(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4>& e, const mpl::false_&)
@@ -1680,6 +1822,28 @@ public:
 
 };
 
+//
+// Sets the default precision of variable precision type Number for the current thread
+// for the lifetime of this object, restoring the previous setting on destruction:
+//
+template <class Number>
+class scoped_default_precision
+{
+public:
+   explicit scoped_default_precision(unsigned digits10) : m_old(Number::thread_default_precision())
+   {
+      Number::thread_default_precision(digits10);
+   }
+   ~scoped_default_precision()
+   {
+      Number::thread_default_precision(m_old);
+   }
+private:
+   scoped_default_precision(const scoped_default_precision&);
+   scoped_default_precision& operator=(const scoped_default_precision&);
+   unsigned m_old;
+};
+
 template <class Backend, expression_template_option ExpressionTemplates>
 inline std::ostream& operator << (std::ostream& os, const number<Backend, ExpressionTemplates>& r)
 {
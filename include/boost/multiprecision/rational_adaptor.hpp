@@ -11,6 +11,9 @@
 #include <sstream>
 #include <boost/cstdint.hpp>
 #include <boost/multiprecision/number.hpp>
+//
+// boost::rational is no longer used here, but including our headers has always made it available:
+//
 #ifdef BOOST_MSVC
 #  pragma warning(push)
 #  pragma warning(disable:4512 4127)
@@ -24,61 +27,89 @@ namespace boost{
 namespace multiprecision{
 namespace backends{
 
+//
+// The value is held as an integer numerator and denominator, always in lowest terms with a positive
+// denominator (so zero is 0/1).  The arithmetic routines keep it that way without taking the gcd of the
+// full sized result: the cross-gcd identities in Knuth, TAOCP vol 2 4.5.1 reduce the smaller pieces before
+// they're combined, and values with a denominator of 1 skip the gcd's altogether.
+//
 template <class IntBackend>
 struct rational_adaptor
 {
-   typedef number<IntBackend>                integer_type;
-   typedef boost::rational<integer_type>        rational_type;
+   typedef number<IntBackend>                   integer_type;
 
    typedef typename IntBackend::signed_types    signed_types;
    typedef typename IntBackend::unsigned_types  unsigned_types;
    typedef typename IntBackend::float_types     float_types;
+private:
+   typedef typename mpl::front<unsigned_types>::type ui_type;
+public:
 
-   rational_adaptor() BOOST_MP_NOEXCEPT_IF(noexcept(rational_type())) {}
-   rational_adaptor(const rational_adaptor& o) BOOST_MP_NOEXCEPT_IF(noexcept(std::declval<rational_type&>() = std::declval<const rational_type&>()))
+   rational_adaptor()
+   {
+      m_den = static_cast<ui_type>(1u);
+   }
+   rational_adaptor(const rational_adaptor& o) : m_num(o.m_num), m_den(o.m_den) {}
+   rational_adaptor(const IntBackend& o) : m_num(o)
    {
-      m_value = o.m_value;
+      m_den = static_cast<ui_type>(1u);
    }
-   rational_adaptor(const IntBackend& o) BOOST_MP_NOEXCEPT_IF(noexcept(rational_type(std::declval<const IntBackend&>()))) : m_value(o) {}
 
    template <class U>
    rational_adaptor(const U& u, typename enable_if_c<is_convertible<U, IntBackend>::value>::type* = 0) 
-      : m_value(static_cast<integer_type>(u)){}
+      : m_num(u)
+   {
+      m_den = static_cast<ui_type>(1u);
+   }
    template <class U>
    explicit rational_adaptor(const U& u, 
       typename enable_if_c<
          boost::multiprecision::detail::is_explicitly_convertible<U, IntBackend>::value && !is_convertible<U, IntBackend>::value
       >::type* = 0) 
-      : m_value(IntBackend(u)){}
+      : m_num(u)
+   {
+      m_den = static_cast<ui_type>(1u);
+   }
    template <class U>
    typename enable_if_c<(boost::multiprecision::detail::is_explicitly_convertible<U, IntBackend>::value && !is_arithmetic<U>::value), rational_adaptor&>::type operator = (const U& u) 
    {
-      m_value = IntBackend(u);
+      m_num = IntBackend(u);
+      m_den = static_cast<ui_type>(1u);
+      return *this;
    }
 
 #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
-   rational_adaptor(rational_adaptor&& o) BOOST_MP_NOEXCEPT_IF(noexcept(rational_type(std::declval<rational_type>()))) : m_value(static_cast<rational_type&&>(o.m_value)) {}
-   rational_adaptor(IntBackend&& o) BOOST_MP_NOEXCEPT_IF(noexcept(rational_type(std::declval<IntBackend>()))) : m_value(static_cast<IntBackend&&>(o)) {}
-   rational_adaptor& operator = (rational_adaptor&& o) BOOST_MP_NOEXCEPT_IF(noexcept(std::declval<rational_type&>() = std::declval<rational_type>()))
+   rational_adaptor(rational_adaptor&& o) BOOST_MP_NOEXCEPT_IF(noexcept(IntBackend(std::declval<IntBackend>())))
+      : m_num(static_cast<IntBackend&&>(o.m_num)), m_den(static_cast<IntBackend&&>(o.m_den)) {}
+   rational_adaptor(IntBackend&& o) : m_num(static_cast<IntBackend&&>(o))
+   {
+      m_den = static_cast<ui_type>(1u);
+   }
+   rational_adaptor& operator = (rational_adaptor&& o) BOOST_MP_NOEXCEPT_IF(noexcept(std::declval<IntBackend&>() = std::declval<IntBackend>()))
    {
-      m_value = static_cast<rational_type&&>(o.m_value);
+      m_num = static_cast<IntBackend&&>(o.m_num);
+      m_den = static_cast<IntBackend&&>(o.m_den);
       return *this;
    }
 #endif
    rational_adaptor& operator = (const rational_adaptor& o)
    {
-      m_value = o.m_value;
+      m_num = o.m_num;
+      m_den = o.m_den;
       return *this;
    }
    rational_adaptor& operator = (const IntBackend& o)
    {
-      m_value = o;
+      m_num = o;
+      m_den = static_cast<ui_type>(1u);
       return *this;
    }
    template <class Int>
    typename enable_if<is_integral<Int>, rational_adaptor&>::type operator = (Int i)
    {
-      m_value = i;
+      typedef typename boost::multiprecision::detail::canonical<Int, IntBackend>::type canonical_type;
+      m_num = static_cast<canonical_type>(i);
+      m_den = static_cast<ui_type>(1u);
       return *this;
    }
    template <class Float>
@@ -98,7 +129,9 @@ struct rational_adaptor
       {
          denom <<= -e;
       }
-      m_value.assign(num, denom);
+      m_num.swap(num.backend());
+      m_den.swap(denom.backend());
+      normalize();
       return *this;
    }
    rational_adaptor& operator = (const char* s)
@@ -136,38 +169,61 @@ struct rational_adaptor
       {
          BOOST_THROW_EXCEPTION(std::runtime_error(std::string("Could not parse the string \"") + p + std::string("\" as a valid rational number.")));
       }
-      data().assign(v1, v2);
+      m_num.swap(v1.backend());
+      m_den.swap(v2.backend());
+      normalize();
       return *this;
    }
    void swap(rational_adaptor& o)
    {
-      std::swap(m_value, o.m_value);
+      m_num.swap(o.m_num);
+      m_den.swap(o.m_den);
    }
    std::string str(std::streamsize digits, std::ios_base::fmtflags f)const
    {
       //
       // We format the string ourselves so we can match what GMP's mpq type does:
       //
-      std::string result = data().numerator().str(digits, f);
-      if(data().denominator() != 1)
+      std::string result = m_num.str(digits, f);
+      if(!is_integer())
       {
          result.append(1, '/');
-         result.append(data().denominator().str(digits, f));
+         result.append(m_den.str(digits, f));
       }
       return result;
    }
    void negate()
    {
-      m_value = -m_value;
+      m_num.negate();
    }
    int compare(const rational_adaptor& o)const
    {
-      return m_value > o.m_value ? 1 : (m_value < o.m_value ? -1 : 0);
+      using default_ops::eval_get_sign;
+      using default_ops::eval_multiply;
+      int s = eval_get_sign(m_num);
+      int os = eval_get_sign(o.m_num);
+      if(s != os)
+         return s < os ? -1 : 1;
+      if(is_integer() && o.is_integer())
+         return m_num.compare(o.m_num);
+      //
+      // The denominators are positive so we can cross multiply:
+      //
+      IntBackend t1, t2;
+      eval_multiply(t1, m_num, o.m_den);
+      eval_multiply(t2, o.m_num, m_den);
+      return t1.compare(t2);
    }
    template <class Arithmatic>
    typename enable_if_c<is_arithmetic<Arithmatic>::value && !is_floating_point<Arithmatic>::value, int>::type compare(Arithmatic i)const
    {
-      return m_value > i ? 1 : (m_value < i ? -1 : 0);
+      using default_ops::eval_multiply;
+      typedef typename boost::multiprecision::detail::canonical<Arithmatic, IntBackend>::type canonical_type;
+      IntBackend t;
+      t = static_cast<canonical_type>(i);
+      if(!is_integer())
+         eval_multiply(t, m_den);
+      return m_num.compare(t);
    }
    template <class Arithmatic>
    typename enable_if_c<is_floating_point<Arithmatic>::value, int>::type compare(Arithmatic i)const
@@ -176,14 +232,68 @@ struct rational_adaptor
       r = i;
       return this->compare(r);
    }
-   rational_type& data() { return m_value; }
-   const rational_type& data()const { return m_value; }
+   //
+   // Direct access to the numerator and denominator, anyone changing these must either
+   // preserve the invariants above or call normalize() afterwards:
+   //
+   IntBackend& num() { return m_num; }
+   const IntBackend& num()const { return m_num; }
+   IntBackend& denom() { return m_den; }
+   const IntBackend& denom()const { return m_den; }
+   //
+   // Deprecated: the value used to be stored as a boost::rational, this now returns a copy of it, so
+   // unlike the old member it can't be used to modify the value:
+   //
+   typedef boost::rational<integer_type> rational_type;
+   rational_type data()const
+   {
+      return rational_type(integer_type(m_num), integer_type(m_den));
+   }
+
+   bool is_integer()const
+   {
+      using default_ops::eval_eq;
+      return eval_eq(m_den, static_cast<ui_type>(1u));
+   }
+   //
+   // Reduces num()/denom() to lowest terms with a positive denominator, this is the only place
+   // we ever need the gcd of a complete numerator and denominator:
+   //
+   void normalize()
+   {
+      using default_ops::eval_is_zero;
+      using default_ops::eval_get_sign;
+      using default_ops::eval_gcd;
+      using default_ops::eval_eq;
+      using default_ops::eval_divide;
+      if(eval_is_zero(m_den))
+      {
+         BOOST_THROW_EXCEPTION(std::overflow_error("Divide by zero."));
+      }
+      if(eval_is_zero(m_num))
+      {
+         m_den = static_cast<ui_type>(1u);
+         return;
+      }
+      IntBackend g;
+      eval_gcd(g, m_num, m_den);
+      if(!eval_eq(g, static_cast<ui_type>(1u)))
+      {
+         eval_divide(m_num, g);
+         eval_divide(m_den, g);
+      }
+      if(eval_get_sign(m_den) < 0)
+      {
+         m_num.negate();
+         m_den.negate();
+      }
+   }
 
    template <class Archive>
    void serialize(Archive& ar, const mpl::true_&)
    {
       // Saving
-      integer_type n(m_value.numerator()), d(m_value.denominator());
+      integer_type n(m_num), d(m_den);
       ar & n;
       ar & d;
    }
@@ -194,7 +304,9 @@ struct rational_adaptor
       integer_type n, d;
       ar & n;
       ar & d;
-      m_value.assign(n, d);
+      m_num.swap(n.backend());
+      m_den.swap(d.backend());
+      normalize();
    }
    template <class Archive>
    void serialize(Archive& ar, const unsigned int /*version*/)
@@ -203,33 +315,229 @@ struct rational_adaptor
       serialize(ar, tag());
    }
 private:
-   rational_type m_value;
+   IntBackend m_num, m_den;
 };
 
+namespace detail{
+
 template <class IntBackend>
-inline void eval_add(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& o)
+inline bool is_unit(const IntBackend& val)
 {
-   result.data() += o.data();
+   typedef typename mpl::front<typename IntBackend::unsigned_types>::type ui_type;
+   using default_ops::eval_eq;
+   return eval_eq(val, static_cast<ui_type>(1u));
 }
+
+//
+// result = a/b + c/d, or a/b - c/d when subtract is true:
+//
 template <class IntBackend>
-inline void eval_subtract(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& o)
+void rational_add(rational_adaptor<IntBackend>& result, const IntBackend& a, const IntBackend& b, const IntBackend& c, const IntBackend& d, bool subtract)
 {
-   result.data() -= o.data();
+   using default_ops::eval_add;
+   using default_ops::eval_subtract;
+   using default_ops::eval_multiply;
+   using default_ops::eval_divide;
+   using default_ops::eval_gcd;
+   using default_ops::eval_is_zero;
+   typedef typename mpl::front<typename IntBackend::unsigned_types>::type ui_type;
+
+   bool b_unit = is_unit(b);
+   bool d_unit = is_unit(d);
+   IntBackend n, t;
+   if(d_unit)
+   {
+      //
+      // (a + cb) / b is already in lowest terms as gcd(a + cb, b) = gcd(a, b):
+      //
+      if(b_unit)
+         subtract ? eval_subtract(n, a, c) : eval_add(n, a, c);
+      else
+      {
+         eval_multiply(t, c, b);
+         subtract ? eval_subtract(n, a, t) : eval_add(n, a, t);
+      }
+      result.num().swap(n);
+      if(&result.denom() != &b)
+         result.denom() = b;
+      return;
+   }
+   if(b_unit)
+   {
+      eval_multiply(t, a, d);
+      subtract ? eval_subtract(n, t, c) : eval_add(n, t, c);
+      result.num().swap(n);
+      if(&result.denom() != &d)
+         result.denom() = d;
+      return;
+   }
+   IntBackend g;
+   eval_gcd(g, b, d);
+   if(is_unit(g))
+   {
+      //
+      // Coprime denominators: the result is (ad + cb) / bd and is already in lowest terms:
+      //
+      eval_multiply(n, a, d);
+      eval_multiply(t, c, b);
+      subtract ? eval_subtract(n, t) : eval_add(n, t);
+      eval_multiply(t, b, d);
+      result.num().swap(n);
+      result.denom().swap(t);
+      return;
+   }
+   //
+   // With b = b1g and d = d1g the result is (a d1 + c b1) / (b1 d1 g), and any common factor
+   // of the new numerator and denominator must divide g:
+   //
+   IntBackend b1, d1;
+   eval_divide(b1, b, g);
+   eval_divide(d1, d, g);
+   eval_multiply(n, a, d1);
+   eval_multiply(t, c, b1);
+   subtract ? eval_subtract(n, t) : eval_add(n, t);
+   if(eval_is_zero(n))
+   {
+      result.num().swap(n);
+      result.denom() = static_cast<ui_type>(1u);
+      return;
+   }
+   eval_gcd(t, n, g);
+   if(!is_unit(t))
+   {
+      eval_divide(n, t);
+      eval_divide(d1, d, t);
+      eval_multiply(t, b1, d1);
+   }
+   else
+      eval_multiply(t, b1, d);
+   result.num().swap(n);
+   result.denom().swap(t);
 }
+//
+// result = (a/b) * (c/d), except that the sign of d may be negative, as happens when dividing:
+//
 template <class IntBackend>
-inline void eval_multiply(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& o)
+void rational_multiply(rational_adaptor<IntBackend>& result, const IntBackend& a, const IntBackend& b, const IntBackend& c, const IntBackend& d)
 {
-   result.data() *= o.data();
+   using default_ops::eval_multiply;
+   using default_ops::eval_divide;
+   using default_ops::eval_gcd;
+   using default_ops::eval_is_zero;
+   using default_ops::eval_get_sign;
+   typedef typename mpl::front<typename IntBackend::unsigned_types>::type ui_type;
+
+   if(eval_is_zero(a) || eval_is_zero(c))
+   {
+      result.num() = static_cast<ui_type>(0u);
+      result.denom() = static_cast<ui_type>(1u);
+      return;
+   }
+   //
+   // Since gcd(a, b) == gcd(c, d) == 1, removing gcd(a, d) and gcd(c, b) leaves the product
+   // in lowest terms, and there's nothing to remove from a unit denominator:
+   //
+   IntBackend n, t, g, x, y;
+   const IntBackend* pa = &a;
+   const IntBackend* pb = &b;
+   const IntBackend* pc = &c;
+   const IntBackend* pd = &d;
+   if(!is_unit(d))
+   {
+      eval_gcd(g, a, d);
+      if(!is_unit(g))
+      {
+         eval_divide(x, a, g);
+         eval_divide(y, d, g);
+         pa = &x;
+         pd = &y;
+      }
+   }
+   if(!is_unit(b))
+   {
+      eval_gcd(g, c, b);
+      if(!is_unit(g))
+      {
+         eval_divide(n, c, g);
+         eval_divide(t, b, g);
+         eval_multiply(n, *pa);
+         eval_multiply(t, *pd);
+      }
+      else
+      {
+         eval_multiply(n, *pa, c);
+         eval_multiply(t, b, *pd);
+      }
+   }
+   else
+   {
+      eval_multiply(n, *pa, *pc);
+      eval_multiply(t, *pb, *pd);
+   }
+   if(eval_get_sign(t) < 0)
+   {
+      n.negate();
+      t.negate();
+   }
+   result.num().swap(n);
+   result.denom().swap(t);
 }
+
+} // namespace detail
+
 template <class IntBackend>
-inline void eval_divide(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& o)
+inline void eval_add(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& a, const rational_adaptor<IntBackend>& b)
+{
+   detail::rational_add(result, a.num(), a.denom(), b.num(), b.denom(), false);
+}
+template <class IntBackend>
+inline void eval_subtract(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& a, const rational_adaptor<IntBackend>& b)
+{
+   detail::rational_add(result, a.num(), a.denom(), b.num(), b.denom(), true);
+}
+template <class IntBackend>
+inline void eval_multiply(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& a, const rational_adaptor<IntBackend>& b)
+{
+   detail::rational_multiply(result, a.num(), a.denom(), b.num(), b.denom());
+}
+template <class IntBackend>
+inline void eval_divide(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& a, const rational_adaptor<IntBackend>& b)
 {
    using default_ops::eval_is_zero;
-   if(eval_is_zero(o))
+   if(eval_is_zero(b))
    {
       BOOST_THROW_EXCEPTION(std::overflow_error("Divide by zero."));
    }
-   result.data() /= o.data();
+   detail::rational_multiply(result, a.num(), a.denom(), b.denom(), b.num());
+}
+template <class IntBackend>
+inline void eval_add(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& o)
+{
+   eval_add(result, result, o);
+}
+template <class IntBackend>
+inline void eval_subtract(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& o)
+{
+   eval_subtract(result, result, o);
+}
+template <class IntBackend>
+inline void eval_multiply(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& o)
+{
+   eval_multiply(result, result, o);
+}
+template <class IntBackend>
+inline void eval_divide(rational_adaptor<IntBackend>& result, const rational_adaptor<IntBackend>& o)
+{
+   eval_divide(result, result, o);
+}
+//
+// Both values are in lowest terms, so they're equal only if their numerators and denominators are:
+//
+template <class IntBackend>
+inline bool eval_eq(const rational_adaptor<IntBackend>& a, const rational_adaptor<IntBackend>& b)
+{
+   using default_ops::eval_eq;
+   return eval_eq(a.num(), b.num()) && eval_eq(a.denom(), b.denom());
 }
 
 template <class R, class IntBackend>
@@ -245,8 +553,8 @@ template <class R, class IntBackend>
 inline typename enable_if_c<(number_category<R>::value != number_kind_integer) && (number_category<R>::value != number_kind_floating_point)>::type eval_convert_to(R* result, const rational_adaptor<IntBackend>& backend)
 {
    typedef typename component_type<number<rational_adaptor<IntBackend> > >::type comp_t;
-   comp_t num(backend.data().numerator());
-   comp_t denom(backend.data().denominator());
+   comp_t num(backend.num());
+   comp_t denom(backend.denom());
    *result = num.template convert_to<R>();
    *result /= denom.template convert_to<R>();
 }
@@ -255,26 +563,38 @@ template <class R, class IntBackend>
 inline typename enable_if_c<number_category<R>::value == number_kind_integer>::type eval_convert_to(R* result, const rational_adaptor<IntBackend>& backend)
 {
    typedef typename component_type<number<rational_adaptor<IntBackend> > >::type comp_t;
-   comp_t t = backend.data().numerator();
-   t /= backend.data().denominator();
+   comp_t t(backend.num());
+   t /= comp_t(backend.denom());
    *result = t.template convert_to<R>();
 }
 
 template <class IntBackend>
 inline bool eval_is_zero(const rational_adaptor<IntBackend>& val)
 {
-   return eval_is_zero(val.data().numerator().backend());
+   using default_ops::eval_is_zero;
+   return eval_is_zero(val.num());
 }
 template <class IntBackend>
 inline int eval_get_sign(const rational_adaptor<IntBackend>& val)
 {
-   return eval_get_sign(val.data().numerator().backend());
+   using default_ops::eval_get_sign;
+   return eval_get_sign(val.num());
 }
 
 template<class IntBackend, class V>
 inline void assign_components(rational_adaptor<IntBackend>& result, const V& v1, const V& v2)
 {
-   result.data().assign(v1, v2);
+   number<IntBackend> n(v1), d(v2);
+   result.num().swap(n.backend());
+   result.denom().swap(d.backend());
+   result.normalize();
+}
+template<class IntBackend>
+inline void assign_components(rational_adaptor<IntBackend>& result, const IntBackend& v1, const IntBackend& v2)
+{
+   result.num() = v1;
+   result.denom() = v2;
+   result.normalize();
 }
 
 } // namespace backends
@@ -296,12 +616,12 @@ struct component_type<rational_adaptor<T> >
 template <class IntBackend, expression_template_option ET>
 inline number<IntBackend, ET> numerator(const number<rational_adaptor<IntBackend>, ET>& val)
 {
-   return val.backend().data().numerator();
+   return val.backend().num();
 }
 template <class IntBackend, expression_template_option ET>
 inline number<IntBackend, ET> denominator(const number<rational_adaptor<IntBackend>, ET>& val)
 {
-   return val.backend().data().denominator();
+   return val.backend().denom();
 }
 
 #ifdef BOOST_NO_SFINAE_EXPR
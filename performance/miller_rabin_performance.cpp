@@ -121,6 +121,51 @@ boost::chrono::duration<double> test_miller_rabin(const char* name)
    return t;
 }
 
+template <class IntType>
+void test_prime_search(const char* name)
+{
+   using namespace boost::random;
+   //
+   // Compare finding the next prime after a random value by testing successive odd
+   // values, with the sieved search in next_probable_prime:
+   //
+   independent_bits_engine<mt11213b, 256, IntType> gen;
+   mt19937 gen2;
+   stopwatch<boost::chrono::high_resolution_clock> c;
+   for(unsigned i = 0; i < 100; ++i)
+   {
+      IntType n = gen();
+      if(!bit_test(n, 0))
+         ++n;
+      while(!boost::multiprecision::miller_rabin_test(n, 25, gen2))
+         n += 2;
+   }
+   double d1 = boost::chrono::duration<double>(c.elapsed()).count();
+   gen.seed();
+   c.reset();
+   for(unsigned i = 0; i < 100; ++i)
+   {
+      IntType n = gen();
+      n = boost::multiprecision::next_probable_prime(n, 25, gen2);
+   }
+   double d2 = boost::chrono::duration<double>(c.elapsed()).count();
+   std::cout << "Time for " << std::setw(30) << std::left << name << " prime search = " << d1 << " (successive odd values) " << d2 << " (sieved)" << std::endl;
+   //
+   // And the Baillie-PSW test on the same random values as test_miller_rabin:
+   //
+   independent_bits_engine<mt11213b, 256, IntType> gen3;
+   unsigned result_count = 0;
+   c.reset();
+   for(unsigned i = 0; i < 1000; ++i)
+   {
+      IntType n = gen3();
+      if(boost::multiprecision::baillie_psw_test(n))
+         ++result_count;
+   }
+   std::cout << "Time for " << std::setw(30) << std::left << name << " Baillie-PSW = " << boost::chrono::duration<double>(c.elapsed()).count() << std::endl;
+   std::cout << "Number of primes found = " << result_count << std::endl;
+}
+
 void generate_quickbook()
 {
    std::cout << "[table\n[[Integer Type][Relative Performance (Actual time in parenthesis)]]\n";
@@ -149,11 +194,14 @@ int main()
    test_miller_rabin<number<cpp_int_backend<1024> > >("cpp_int (1024-bit cache)");
    test_miller_rabin<int1024_t>("int1024_t");
    test_miller_rabin<checked_int1024_t>("checked_int1024_t");
+   test_prime_search<cpp_int>("cpp_int");
+   test_prime_search<int1024_t>("int1024_t");
 #endif
 #ifdef TEST_MPZ
    test_miller_rabin<number<gmp_int, et_off> >("mpz_int (no Expression templates)");
    test_miller_rabin<mpz_int>("mpz_int");
    std::cout << "Time for mpz_int (native Miller Rabin Test) = " << test_miller_rabin_gmp() << std::endl;
+   test_prime_search<mpz_int>("mpz_int");
 #endif
 #ifdef TEST_TOMMATH
    test_miller_rabin<number<boost::multiprecision::tommath_int, et_off> >("tom_int (no Expression templates)");
@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Check that numbers allocated from an arena give the same results as heap allocated ones, and that once
+// a calculation has been run through once, repeating it makes no further calls to operator new:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/multiprecision/arena_allocator.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <cstdlib>
+#include <vector>
+#include "test.hpp"
+
+static unsigned long allocation_count = 0;
+
+#ifdef BOOST_NO_CXX11_NOEXCEPT
+void* operator new(std::size_t n) throw(std::bad_alloc)
+#else
+void* operator new(std::size_t n)
+#endif
+{
+   ++allocation_count;
+   void* p = std::malloc(n ? n : 1);
+   if(!p)
+      throw std::bad_alloc();
+   return p;
+}
+//
+// Kept out of line, otherwise gcc sees free() called directly on memory from operator new and warns:
+//
+BOOST_NOINLINE void operator delete(void* p) BOOST_NOEXCEPT_OR_NOTHROW
+{
+   std::free(p);
+}
+BOOST_NOINLINE void operator delete(void* p, std::size_t) BOOST_NOEXCEPT_OR_NOTHROW
+{
+   ::operator delete(p);
+}
+
+//
+// Temporaries come from the scratch pool, which needs thread_local support to cache anything:
+//
+#if !defined(BOOST_NO_CXX11_THREAD_LOCAL) && BOOST_MP_SCRATCH_POOL_SIZE
+#  define CHECK_NO_ALLOCATION(n) BOOST_CHECK_EQUAL(n, 0u)
+#else
+#  define CHECK_NO_ALLOCATION(n)
+#endif
+
+static boost::random::mt19937 gen;
+
+template <class T>
+T generate_random(unsigned words)
+{
+   T val = 0;
+   for(unsigned i = 0; i < words; ++i)
+   {
+      val *= (gen.max)();
+      val += gen();
+   }
+   if(gen() & 1)
+      val = -val;
+   if(!std::numeric_limits<T>::is_integer)
+      val /= static_cast<unsigned>(gen() | 1u);
+   return val;
+}
+
+template <class T>
+std::string to_string(const T& val)
+{
+   return val.str(std::numeric_limits<T>::is_integer ? 0 : std::numeric_limits<T>::max_digits10, std::ios_base::scientific);
+}
+
+//
+// Computes the same values for heap allocated type Ref and arena allocated type T:
+//
+template <class T, class Ref>
+void test_arena(unsigned words)
+{
+   using namespace boost::multiprecision;
+   std::vector<Ref> values(20);
+   for(unsigned i = 0; i < values.size(); ++i)
+      values[i] = generate_random<Ref>(words);
+   Ref ref_sum = 0, ref_product = 1, ref_quotient = 0;
+   for(unsigned i = 0; i < values.size(); ++i)
+   {
+      ref_sum += values[i] * values[(i + 1) % values.size()];
+      ref_product *= values[i];
+      ref_quotient += ref_product / values[(i + 3) % values.size()];
+   }
+
+   arena a(256);
+   BOOST_CHECK(arena_scope::current() == 0);
+   for(unsigned pass = 0; pass < 3; ++pass)
+   {
+      {
+         arena_scope scope(a);
+         BOOST_CHECK(arena_scope::current() == &a);
+         std::vector<T> v(values.size());
+         for(unsigned i = 0; i < values.size(); ++i)
+            v[i] = T(to_string(values[i]));
+         unsigned long before = allocation_count;
+         T sum = 0, product = 1, quotient = 0;
+         for(unsigned i = 0; i < v.size(); ++i)
+         {
+            sum += v[i] * v[(i + 1) % v.size()];
+            product *= v[i];
+            quotient += product / v[(i + 3) % v.size()];
+         }
+         unsigned long count = allocation_count - before;
+         if(pass)
+            CHECK_NO_ALLOCATION(count);
+         BOOST_CHECK(a.used() > 0);
+         BOOST_CHECK(a.capacity() >= a.used());
+         BOOST_CHECK_EQUAL(to_string(sum), to_string(ref_sum));
+         BOOST_CHECK_EQUAL(to_string(product), to_string(ref_product));
+         BOOST_CHECK_EQUAL(to_string(quotient), to_string(ref_quotient));
+      }
+      BOOST_CHECK(arena_scope::current() == 0);
+      a.release();
+      BOOST_CHECK_EQUAL(a.used(), 0u);
+   }
+   //
+   // A value escapes the arena by assignment to one created outside of it:
+   //
+   T outside;
+   {
+      arena_scope scope(a);
+      T x(to_string(values[0]));
+      x *= T(to_string(values[1]));
+      outside = x;
+      x = 0;
+   }
+   a.release();
+   {
+      arena_scope scope(a);
+      T junk(to_string(values[2]));
+      junk *= junk;
+      junk *= junk;
+   }
+   BOOST_CHECK_EQUAL(to_string(outside), to_string(Ref(values[0] * values[1])));
+   //
+   // Swapping exchanges the allocators along with the storage, so each buffer is still freed by the allocator
+   // it came from.  The arena outlives h, which ends up using it:
+   //
+   {
+      T h(to_string(ref_product));
+      {
+         arena_scope scope(a);
+         T x(to_string(ref_sum));
+         x.swap(h);
+         BOOST_CHECK_EQUAL(to_string(x), to_string(ref_product));
+         BOOST_CHECK_EQUAL(to_string(h), to_string(ref_sum));
+      }
+      h *= h;
+      BOOST_CHECK_EQUAL(to_string(h), to_string(Ref(ref_sum * ref_sum)));
+   }
+   //
+   // Nested scopes:
+   //
+   arena b;
+   {
+      arena_scope scope(a);
+      {
+         arena_scope inner(b);
+         BOOST_CHECK(arena_scope::current() == &b);
+         T x(to_string(ref_sum));
+         x *= x;
+         BOOST_CHECK(b.used() > 0);
+      }
+      BOOST_CHECK(arena_scope::current() == &a);
+   }
+}
+
+//
+// Temporaries inside the arithmetic routines come from the scratch pool, even for values that use the
+// default allocator.  Sizes are large enough to use the subquadratic multiplication and division routines:
+//
+template <class T>
+void test_scratch(unsigned words)
+{
+   T a = generate_random<T>(words), b = generate_random<T>(words / 2), r, q, m, p1, p2, p3, p4, p5;
+   for(unsigned pass = 0; pass < 3; ++pass)
+   {
+      unsigned long before = allocation_count;
+      r = a * b;
+      r *= a;
+      p1 = r;
+      r = a;
+      r *= r;
+      p2 = r;
+      q = r / b;
+      m = r % b;
+      p3 = q;
+      p4 = m;
+      r = a;
+      r /= b;
+      p5 = r;
+      unsigned long count = allocation_count - before;
+      if(pass)
+      {
+         CHECK_NO_ALLOCATION(count);
+      }
+      BOOST_CHECK_EQUAL(p1, T(a * b * a));
+      BOOST_CHECK_EQUAL(p2, T(a * a));
+      BOOST_CHECK_EQUAL(T(p3 * b + p4), p2);
+      BOOST_CHECK_EQUAL(p5, T(a / b));
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+   test_arena<number<cpp_int_backend<0, 0, signed_magnitude, unchecked, arena_allocator<limb_type> > >, cpp_int>(6);
+   test_arena<number<cpp_int_backend<0, 0, signed_magnitude, unchecked, arena_allocator<limb_type> >, et_off>, cpp_int>(50);
+   test_arena<number<cpp_bin_float<50, digit_base_10, arena_allocator<void> > >, cpp_bin_float_50>(5);
+   test_arena<number<cpp_bin_float<500, digit_base_10, arena_allocator<void> > >, number<cpp_bin_float<500> > >(50);
+   test_arena<number<cpp_dec_float<50, boost::int32_t, arena_allocator<void> > >, cpp_dec_float_50>(5);
+   test_scratch<cpp_int>(600);
+   test_scratch<cpp_int>(1500);
+   return boost::report_errors();
+}
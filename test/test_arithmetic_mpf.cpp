@@ -10,6 +10,9 @@
 #include <boost/multiprecision/gmp.hpp>
 
 #include "test_arithmetic.hpp"
+#ifndef BOOST_NO_CXX11_HDR_THREAD
+#include <thread>
+#endif
 
 template <unsigned D>
 struct related_type<boost::multiprecision::number< boost::multiprecision::gmp_float<D> > >
@@ -22,10 +25,36 @@ struct related_type<boost::multiprecision::mpf_float >
    typedef boost::multiprecision::mpz_int type;
 };
 
+void test_thread_default_precision()
+{
+   typedef boost::multiprecision::mpf_float T;
+   BOOST_CHECK_EQUAL(T::thread_default_precision(), 0);
+   {
+      boost::multiprecision::scoped_default_precision<T> guard(30);
+      BOOST_CHECK_EQUAL(T::default_precision(), 30);
+      T a(2);
+      BOOST_CHECK(a.precision() < 100);
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+#ifndef BOOST_NO_CXX11_HDR_THREAD
+      //
+      // Other threads are unaffected:
+      //
+      unsigned other = 0;
+      std::thread t([&other]() { other = T::default_precision(); });
+      t.join();
+      BOOST_CHECK_EQUAL(other, 1000);
+#endif
+#endif
+   }
+   BOOST_CHECK_EQUAL(T::thread_default_precision(), 0);
+   BOOST_CHECK_EQUAL(T::default_precision(), 1000);
+}
+
 int main()
 {
    boost::multiprecision::mpf_float::default_precision(1000);
    BOOST_CHECK_EQUAL(boost::multiprecision::mpf_float::default_precision() ,  1000);
+   test_thread_default_precision();
    test<boost::multiprecision::mpf_float>();
    return boost::report_errors();
 }
@@ -8,6 +8,7 @@
 #endif
 
 #include <boost/multiprecision/mpfr.hpp>
+#include <boost/math/constants/constants.hpp>
 #define TEST_MPFR
 #include "test_arithmetic.hpp"
 
@@ -17,8 +18,48 @@ struct related_type<boost::multiprecision::number< boost::multiprecision::mpfr_f
    typedef boost::multiprecision::number< boost::multiprecision::mpfr_float_backend<D/2> > type;
 };
 
+//
+// The constants follow the default precision in effect when they are asked for, whether or not
+// they have already been computed at some other precision:
+//
+void test_constants_precision()
+{
+   typedef boost::multiprecision::mpfr_float T;
+   T pi_50 = boost::math::constants::pi<T>();
+   BOOST_CHECK_EQUAL(pi_50.precision(), 50);
+   for(unsigned i = 0; i < 2; ++i)
+   {
+      {
+         boost::multiprecision::scoped_default_precision<T> guard(30);
+         const T& pi_30 = boost::math::constants::pi<T>();
+         BOOST_CHECK_EQUAL(pi_30.precision(), 30);
+         BOOST_CHECK(abs(pi_30 - pi_50) < 1e-28);
+         BOOST_CHECK_EQUAL(boost::math::constants::ln_two<T>().precision(), 30);
+      }
+      {
+         boost::multiprecision::scoped_default_precision<T> guard(200);
+         const T& pi_200 = boost::math::constants::pi<T>();
+         BOOST_CHECK_EQUAL(pi_200.precision(), 200);
+         BOOST_CHECK(abs(pi_200 - pi_50) < 1e-48);
+         BOOST_CHECK(pi_200 != pi_50);
+         BOOST_CHECK_EQUAL(boost::math::constants::euler<T>().precision(), 200);
+         BOOST_CHECK_EQUAL(boost::math::constants::catalan<T>().precision(), 200);
+      }
+   }
+   BOOST_CHECK_EQUAL(boost::math::constants::pi<T>(), pi_50);
+   BOOST_CHECK_EQUAL(boost::math::constants::pi<T>().precision(), 50);
+}
+
 int main()
 {
+   {
+      boost::multiprecision::scoped_default_precision<boost::multiprecision::mpfr_float> guard(30);
+      BOOST_CHECK_EQUAL(boost::multiprecision::mpfr_float::default_precision(), 30);
+      BOOST_CHECK_EQUAL(boost::multiprecision::mpfr_float().precision(), 30);
+   }
+   BOOST_CHECK_EQUAL(boost::multiprecision::mpfr_float::thread_default_precision(), 0);
+   BOOST_CHECK_EQUAL(boost::multiprecision::mpfr_float::default_precision(), 50);
+   test_constants_precision();
    test<boost::multiprecision::mpfr_float>();
    return boost::report_errors();
 }
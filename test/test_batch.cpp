@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Check that add_n, subtract_n, multiply_n and multiply_add_n give exactly the same results as the scalar expressions:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <vector>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+template <class T>
+T generate_random(unsigned words)
+{
+   T val = 0;
+   for(unsigned i = 0; i < words; ++i)
+   {
+      val *= (gen.max)();
+      val += gen();
+   }
+   if(std::numeric_limits<T>::is_signed && (gen() & 1))
+      val = T(0) - val;
+   if(!std::numeric_limits<T>::is_integer)
+      val /= static_cast<unsigned>(gen() | 1u);
+   return val;
+}
+
+template <class T>
+void test(unsigned max_words)
+{
+   for(unsigned i = 0; i < 20; ++i)
+   {
+      unsigned n = i * 5;
+      std::vector<T> a(n + 1), b(n + 1), c(n + 1), r(n + 1);
+      for(unsigned j = 0; j < n; ++j)
+      {
+         a[j] = generate_random<T>(gen() % max_words + 1);
+         b[j] = generate_random<T>(gen() % max_words + 1);
+         c[j] = generate_random<T>(gen() % max_words + 1);
+         if(!std::numeric_limits<T>::is_signed && (b[j] > a[j]))
+            std::swap(a[j], b[j]);
+      }
+      // Leave one value at the end of each sequence which should not be touched:
+      a[n] = b[n] = c[n] = r[n] = 2;
+
+      BOOST_CHECK(add_n(r.begin(), a.begin(), b.begin(), n) == r.begin() + n);
+      for(unsigned j = 0; j < n; ++j)
+         BOOST_CHECK_EQUAL(r[j], T(a[j] + b[j]));
+      BOOST_CHECK(subtract_n(&r[0], &a[0], &b[0], n) == &r[0] + n);
+      for(unsigned j = 0; j < n; ++j)
+         BOOST_CHECK_EQUAL(r[j], T(a[j] - b[j]));
+      BOOST_CHECK(multiply_n(r.begin(), a.begin(), b.begin(), n) == r.begin() + n);
+      for(unsigned j = 0; j < n; ++j)
+         BOOST_CHECK_EQUAL(r[j], T(a[j] * b[j]));
+      BOOST_CHECK(multiply_add_n(r.begin(), a.begin(), b.begin(), c.begin(), n) == r.begin() + n);
+      for(unsigned j = 0; j < n; ++j)
+         BOOST_CHECK_EQUAL(r[j], T(a[j] * b[j] + c[j]));
+      BOOST_CHECK_EQUAL(r[n], 2);
+      //
+      // In place:
+      //
+      std::vector<T> x(a);
+      multiply_add_n(x.begin(), x.begin(), b.begin(), x.begin(), n);
+      for(unsigned j = 0; j < n; ++j)
+         BOOST_CHECK_EQUAL(x[j], T(a[j] * b[j] + a[j]));
+      x = a;
+      multiply_n(x.begin(), x.begin(), x.begin(), n);
+      for(unsigned j = 0; j < n; ++j)
+         BOOST_CHECK_EQUAL(x[j], T(a[j] * a[j]));
+      x = b;
+      add_n(x.begin(), a.begin(), x.begin(), n);
+      for(unsigned j = 0; j < n; ++j)
+         BOOST_CHECK_EQUAL(x[j], T(a[j] + b[j]));
+      x = a;
+      subtract_n(x.begin(), x.begin(), b.begin(), n);
+      for(unsigned j = 0; j < n; ++j)
+         BOOST_CHECK_EQUAL(x[j], T(a[j] - b[j]));
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+   test<uint256_t>(8);
+   test<int256_t>(8);
+   test<uint512_t>(16);
+   test<int1024_t>(32);
+   test<cpp_int>(40);
+   test<number<cpp_int_backend<256, 256, signed_magnitude, unchecked, void>, et_on> >(8);
+   test<cpp_bin_float_quad>(4);
+   test<cpp_bin_float_50>(8);
+   test<number<cpp_bin_float<50>, et_on> >(8);
+   test<cpp_dec_float_50>(8);
+   return boost::report_errors();
+}
@@ -9,10 +9,11 @@
 #  define _SCL_SECURE_NO_WARNINGS
 #endif
 
-#if !defined(TEST_MPF_50) && !defined(TEST_CPP_DEC_FLOAT) && !defined(TEST_MPFR_50)
+#if !defined(TEST_MPF_50) && !defined(TEST_CPP_DEC_FLOAT) && !defined(TEST_MPFR_50) && !defined(TEST_CPP_BIN_FLOAT)
 #  define TEST_MPF_50
 #  define TEST_CPP_DEC_FLOAT
 #  define TEST_MPFR_50
+#  define TEST_CPP_BIN_FLOAT
 
 #ifdef _MSC_VER
 #pragma message("CAUTION!!: No backend type specified so testing everything.... this will take some time!!")
@@ -32,6 +33,9 @@
 #ifdef TEST_CPP_DEC_FLOAT
 #include <boost/multiprecision/cpp_dec_float.hpp>
 #endif
+#ifdef TEST_CPP_BIN_FLOAT
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#endif
 
 #include "test.hpp"
 
@@ -170,6 +174,12 @@ template <class T>
 void test()
 {
    typedef typename T::backend_type backend_type;
+   //
+   // Once computed, the cached constants are never moved or changed:
+   //
+   const backend_type* ppi = &boost::multiprecision::default_ops::get_constant_pi<backend_type>();
+   boost::multiprecision::precompute_constants<T>();
+   BOOST_CHECK(ppi == &boost::multiprecision::default_ops::get_constant_pi<backend_type>());
    T num, expect;
    num.backend() = boost::multiprecision::default_ops::get_constant_pi<backend_type>();
    expect = static_cast<T>(pi);
@@ -182,6 +192,43 @@ void test()
    BOOST_CHECK_CLOSE_FRACTION(num, expect, std::numeric_limits<T>::epsilon() * (is_mpfr(num) ? 2 : 1));
 }
 
+#ifdef TEST_MPF_50
+//
+// Variable precision constants are computed at the current default precision,
+// and a lower precision reuses (rounds) the most precise value computed so far:
+//
+void test_variable_precision()
+{
+   typedef boost::multiprecision::mpf_float T;
+   typedef T::backend_type backend_type;
+   unsigned digits[] = { 2000, 300, 1500, 2000 };
+   const backend_type* ppi = 0;
+   for(unsigned i = 0; i < sizeof(digits) / sizeof(digits[0]); ++i)
+   {
+      T::default_precision(digits[i]);
+      if(digits[i] == 2000)
+      {
+         // The value for each precision is kept, not recomputed:
+         if(!ppi)
+            ppi = &boost::multiprecision::default_ops::get_constant_pi<backend_type>();
+         BOOST_CHECK(ppi == &boost::multiprecision::default_ops::get_constant_pi<backend_type>());
+      }
+      T num, expect;
+      num.backend() = boost::multiprecision::default_ops::get_constant_pi<backend_type>();
+      BOOST_CHECK_EQUAL(mpf_get_prec(boost::multiprecision::default_ops::get_constant_pi<backend_type>().data()), mpf_get_prec(num.backend().data()));
+      expect = static_cast<T>(pi);
+      BOOST_CHECK_LE(abs(num - expect) / expect, T(ldexp(T(1), -static_cast<int>(boost::multiprecision::detail::digits10_2_2(digits[i])))) * 2);
+      num.backend() = boost::multiprecision::default_ops::get_constant_ln2<backend_type>();
+      expect = static_cast<T>(ln2);
+      BOOST_CHECK_LE(abs(num - expect) / expect, T(ldexp(T(1), -static_cast<int>(boost::multiprecision::detail::digits10_2_2(digits[i])))) * 2);
+      num.backend() = boost::multiprecision::default_ops::get_constant_e<backend_type>();
+      expect = static_cast<T>(e);
+      BOOST_CHECK_LE(abs(num - expect) / expect, T(ldexp(T(1), -static_cast<int>(boost::multiprecision::detail::digits10_2_2(digits[i])))) * 2);
+   }
+   T::default_precision(50);
+}
+#endif
+
 int main()
 {
 #ifdef TEST_MPFR_50
@@ -192,6 +239,10 @@ int main()
 #endif
 #ifdef TEST_MPF_50
    test<boost::multiprecision::number<boost::multiprecision::gmp_float<2000> > >();
+   test_variable_precision();
+#endif
+#ifdef TEST_CPP_BIN_FLOAT
+   test<boost::multiprecision::number<boost::multiprecision::cpp_bin_float<2000> > >();
 #endif
    return boost::report_errors();
 }
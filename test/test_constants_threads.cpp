@@ -0,0 +1,276 @@
+// Copyright John Maddock 2012.
+
+// Use, modification and distribution are subject to the
+// Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+//
+// Checks that the cached constants may be requested from several threads at once: every thread
+// must see the same, correct, value and each precision must be computed and inserted exactly once.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include "test.hpp"
+
+#if defined(BOOST_MP_THREAD_SAFE_CONSTANTS) && !defined(BOOST_NO_CXX11_HDR_THREAD) && !defined(BOOST_NO_CXX11_LAMBDAS)
+
+#include <thread>
+#include <map>
+#include <vector>
+
+static const char* pi =
+"3.141592653589793238462643383279502884197169399375105820974944592307816406286208"
+"99862803482534211706798214808651328230664709384460955058223172535940812848111745"
+"02841027019385211055596446229489549303819644288109756659334461284756482337867831"
+"65271201909145648566923460348610454326648213393607260249141273724587006606315588"
+"17488152092096282925409171536436789259036001133053054882046652138414695194151160"
+"94330572703657595919530921861173819326117931051185480744623799627495673518857527"
+"24891227938183011949129833673362440656643086021394946395224737190702179860943702"
+"77053921717629317675238467481846766940513200056812714526356082778577134275778960"
+"91736371787214684409012249534301465495853710507922796892589235420199561121290219"
+"60864034418159813629774771309960518707211349999998372978049951059731732816096318"
+"59502445945534690830264252230825334468503526193118817101000313783875288658753320"
+"83814206171776691473035982534904287554687311595628638823537875937519577818577805"
+"32171226806613001927876611195909216420198938095257201065485863278865936153381827"
+"96823030195203530185296899577362259941389124972177528347913151557485724245415069"
+"59508295331168617278558890750983817546374649393192550604009277016711390098488240"
+"12858361603563707660104710181942955596198946767837449448255379774726847104047534"
+"64620804668425906949129331367702898915210475216205696602405803815019351125338243"
+"00355876402474964732639141992726042699227967823547816360093417216412199245863150"
+"30286182974555706749838505494588586926995690927210797509302955321165344987202755"
+"96023648066549911988183479775356636980742654252786255181841757467289097777279380"
+"00816470600161452491921732172147723501414419735685481613611573525521334757418494"
+"68438523323907394143334547762416862518983569485562099219222184272550254256887671"
+"79049460165346680498862723279178608578438382796797668145410095388378636095068006"
+"42251252051173929848960841284886269456042419652850222106611863067442786220391949"
+"45047123713786960956364371917287467764657573962413890865832645995813390478027590"
+"09";
+
+static const char* e =
+"2.718281828459045235360287471352662497757247093699959574966967627724076630353547"
+"59457138217852516642742746639193200305992181741359662904357290033429526059563073"
+"81323286279434907632338298807531952510190115738341879307021540891499348841675092"
+"44761460668082264800168477411853742345442437107539077744992069551702761838606261"
+"33138458300075204493382656029760673711320070932870912744374704723069697720931014"
+"16928368190255151086574637721112523897844250569536967707854499699679468644549059"
+"87931636889230098793127736178215424999229576351482208269895193668033182528869398"
+"49646510582093923982948879332036250944311730123819706841614039701983767932068328"
+"23764648042953118023287825098194558153017567173613320698112509961818815930416903"
+"51598888519345807273866738589422879228499892086805825749279610484198444363463244"
+"96848756023362482704197862320900216099023530436994184914631409343173814364054625"
+"31520961836908887070167683964243781405927145635490613031072085103837505101157477"
+"04171898610687396965521267154688957035035402123407849819334321068170121005627880"
+"23519303322474501585390473041995777709350366041699732972508868769664035557071622"
+"68447162560798826517871341951246652010305921236677194325278675398558944896970964"
+"09754591856956380236370162112047742722836489613422516445078182442352948636372141"
+"74023889344124796357437026375529444833799801612549227850925778256209262264832627"
+"79333865664816277251640191059004916449982893150566047258027786318641551956532442"
+"58698294695930801915298721172556347546396447910145904090586298496791287406870504"
+"89585867174798546677575732056812884592054133405392200011378630094556068816674001"
+"69842055804033637953764520304024322566135278369511778838638744396625322498506549"
+"95886234281899707733276171783928034946501434558897071942586398772754710962953741"
+"52111513683506275260232648472870392076431005958411661205452970302364725492966693"
+"81151373227536450988890313602057248176585118063036442812314965507047510254465011"
+"72721155519486685080036853228183152196003735625279449515828418829478761085263981"
+"39";
+
+static const char* ln2 =
+"0.693147180559945309417232121458176568075500134360255254120680009493393621969694"
+"71560586332699641868754200148102057068573368552023575813055703267075163507596193"
+"07275708283714351903070386238916734711233501153644979552391204751726815749320651"
+"55524734139525882950453007095326366642654104239157814952043740430385500801944170"
+"64167151864471283996817178454695702627163106454615025720740248163777338963855069"
+"52606683411372738737229289564935470257626520988596932019650585547647033067936544"
+"32547632744951250406069438147104689946506220167720424524529612687946546193165174"
+"68139267250410380254625965686914419287160829380317271436778265487756648508567407"
+"76484514644399404614226031930967354025744460703080960850474866385231381816767514"
+"38667476647890881437141985494231519973548803751658612753529166100071053558249879"
+"41472950929311389715599820565439287170007218085761025236889213244971389320378439"
+"35308877482597017155910708823683627589842589185353024363421436706118923678919237"
+"23146723217205340164925687274778234453534764811494186423867767744060695626573796"
+"00867076257199184734022651462837904883062033061144630073719489002743643965002580"
+"93651944304119115060809487930678651588709006052034684297361938412896525565396860"
+"22194122924207574321757489097706752687115817051137009158942665478595964890653058"
+"46025866838294002283300538207400567705304678700184162404418833232798386349001563"
+"12188956065055315127219939833203075140842609147900126516824344389357247278820548"
+"62715527418772430024897945401961872339808608316648114909306675193393128904316413"
+"70681397776498176974868903887789991296503619270710889264105230924783917373501229"
+"84242049956893599220660220465494151061391878857442455775102068370308666194808964"
+"12186807790208181588580001688115973056186676199187395200766719214592236720602539"
+"59543654165531129517598994005600036651356756905124592682574394648316833262490180"
+"38242408242314523061409638057007025513877026817851630690255137032340538021450190"
+"15374029509942262995779647427138157363801729873940704242179972266962979939312706"
+"93";
+
+static const unsigned thread_count = 8;
+//
+// All the threads spin on this until every one of them has started, so that their first requests
+// for a constant really do overlap:
+//
+static std::atomic<unsigned> threads_ready(0);
+
+static void wait_for_all_threads()
+{
+   ++threads_ready;
+   while(threads_ready.load() < thread_count)
+      std::this_thread::yield();
+}
+
+typedef boost::multiprecision::cpp_bin_float<2000> cache_backend;
+typedef boost::multiprecision::number<cache_backend> cache_number;
+
+static std::mutex insertions_mutex;
+static std::map<unsigned, unsigned> insertions;
+
+static void record_insertion(unsigned bits)
+{
+   std::lock_guard<std::mutex> l(insertions_mutex);
+   ++insertions[bits];
+}
+//
+// The constant_cache calls exactly one of these each time it inserts a new precision:
+//
+void counted_calc_pi(cache_backend& result, unsigned bits)
+{
+   record_insertion(bits);
+   boost::multiprecision::default_ops::calc_pi(result, bits);
+}
+void counted_round(cache_backend& result, const cache_backend& src, unsigned src_bits, unsigned bits)
+{
+   record_insertion(bits);
+   boost::multiprecision::default_ops::round_constant(result, src, src_bits, bits);
+}
+
+typedef boost::multiprecision::default_ops::constant_cache<cache_backend, &counted_calc_pi, &counted_round> counted_cache;
+
+void test_cache()
+{
+   //
+   // Both below and above the precision at which pi is computed rather than parsed from a string,
+   // several threads ask for each precision at the same time, starting at different points in the list:
+   //
+   static const unsigned bits[] = { 64, 113, 500, 2000, 4000, 6000 };
+   static const unsigned bits_count = sizeof(bits) / sizeof(bits[0]);
+   counted_cache cache;
+   std::vector<std::vector<const cache_backend*> > results(thread_count);
+   std::vector<std::thread> threads;
+   threads_ready = 0;
+   for(unsigned i = 0; i < thread_count; ++i)
+   {
+      threads.push_back(std::thread([&cache, &results, i]()
+      {
+         results[i].resize(bits_count);
+         wait_for_all_threads();
+         for(unsigned j = 0; j < bits_count; ++j)
+         {
+            unsigned k = (i / 2 + j) % bits_count;
+            results[i][k] = &cache.get(bits[k]);
+         }
+      }));
+   }
+   for(unsigned i = 0; i < thread_count; ++i)
+      threads[i].join();
+
+   BOOST_CHECK_EQUAL(insertions.size(), bits_count);
+   for(unsigned k = 0; k < bits_count; ++k)
+   {
+      BOOST_CHECK_EQUAL(insertions[bits[k]], 1);
+      for(unsigned i = 1; i < thread_count; ++i)
+         BOOST_CHECK(results[i][k] == results[0][k]);
+      BOOST_CHECK(results[0][k] == &cache.get(bits[k]));
+      cache_number val, expect(pi);
+      val.backend() = *results[0][k];
+      BOOST_CHECK_LE(abs(val - expect) / expect, ldexp(cache_number(1), 2 - static_cast<int>(bits[k])));
+   }
+   BOOST_CHECK_EQUAL(insertions.size(), bits_count);
+}
+//
+// The library's own caches, for several types at once.  Each thread records the address of every
+// constant it's given, which must be the same across all the threads:
+//
+template <class T>
+void get_constants(std::vector<const void*>& addresses)
+{
+   typedef typename T::backend_type backend_type;
+   addresses.push_back(&boost::multiprecision::default_ops::get_constant_pi<backend_type>());
+   addresses.push_back(&boost::multiprecision::default_ops::get_constant_e<backend_type>());
+   addresses.push_back(&boost::multiprecision::default_ops::get_constant_ln2<backend_type>());
+}
+
+template <class T>
+void check_constants()
+{
+   typedef typename T::backend_type backend_type;
+   T num;
+   num.backend() = boost::multiprecision::default_ops::get_constant_pi<backend_type>();
+   BOOST_CHECK_CLOSE_FRACTION(num, T(pi), std::numeric_limits<T>::epsilon() * 2);
+   num.backend() = boost::multiprecision::default_ops::get_constant_e<backend_type>();
+   BOOST_CHECK_CLOSE_FRACTION(num, T(e), std::numeric_limits<T>::epsilon() * 2);
+   num.backend() = boost::multiprecision::default_ops::get_constant_ln2<backend_type>();
+   BOOST_CHECK_CLOSE_FRACTION(num, T(ln2), std::numeric_limits<T>::epsilon() * 2);
+}
+
+void test_library_constants()
+{
+   using namespace boost::multiprecision;
+   typedef number<cpp_bin_float<50> > bin_50;
+   typedef number<cpp_bin_float<300> > bin_300;
+   typedef number<cpp_bin_float<1500> > bin_1500;
+   typedef number<cpp_dec_float<100> > dec_100;
+
+   std::vector<std::vector<const void*> > results(thread_count);
+   std::vector<std::thread> threads;
+   threads_ready = 0;
+   for(unsigned i = 0; i < thread_count; ++i)
+   {
+      threads.push_back(std::thread([&results, i]()
+      {
+         wait_for_all_threads();
+         if(i & 1)
+         {
+            get_constants<bin_1500>(results[i]);
+            get_constants<bin_300>(results[i]);
+         }
+         else
+         {
+            get_constants<bin_300>(results[i]);
+            get_constants<bin_1500>(results[i]);
+         }
+         get_constants<bin_50>(results[i]);
+         get_constants<dec_100>(results[i]);
+         if(i & 1)
+            std::swap_ranges(results[i].begin(), results[i].begin() + 3, results[i].begin() + 3);
+      }));
+   }
+   for(unsigned i = 0; i < thread_count; ++i)
+      threads[i].join();
+   for(unsigned i = 1; i < thread_count; ++i)
+      BOOST_CHECK(results[i] == results[0]);
+
+   check_constants<bin_50>();
+   check_constants<bin_300>();
+   check_constants<bin_1500>();
+   check_constants<dec_100>();
+}
+
+int main()
+{
+   test_cache();
+   test_library_constants();
+   return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+   return 0;
+}
+
+#endif
@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Check that cpp_bin_float_accumulator returns the correctly rounded sum, whatever the order of the
+// additions and however the partial sums are merged, by comparing against sums computed exactly:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <algorithm>
+#include <vector>
+#include "test.hpp"
+
+//
+// Large enough to hold every sum below exactly, and with a wider exponent range than any of the types tested:
+//
+typedef boost::multiprecision::number<boost::multiprecision::cpp_bin_float<2000, boost::multiprecision::digit_base_2, void, boost::long_long_type> > reference_type;
+
+static boost::random::mt19937 gen;
+
+template <class T>
+T generate_random(int exponent_range)
+{
+   T val = gen();
+   T prev_val = -1;
+   while(val != prev_val)
+   {
+      val *= (gen.max)();
+      prev_val = val;
+      val += gen();
+   }
+   int e;
+   val = frexp(val, &e);
+   if(gen() & 1)
+      val = -val;
+   return ldexp(val, static_cast<int>(gen() % (2 * exponent_range)) - exponent_range);
+}
+
+template <class T>
+T accumulate(const std::vector<T>& v)
+{
+   typedef typename T::backend_type backend_type;
+   boost::multiprecision::cpp_bin_float_accumulator<backend_type> acc;
+   for(unsigned i = 0; i < v.size(); ++i)
+      acc += v[i];
+   return acc.sum();
+}
+
+template <class T>
+void test_random(int exponent_range)
+{
+   typedef typename T::backend_type backend_type;
+   for(unsigned i = 0; i < 100; ++i)
+   {
+      unsigned n = (i % 10) * 30 + 1;
+      std::vector<T> v(n);
+      reference_type exact = 0;
+      for(unsigned j = 0; j < n; ++j)
+      {
+         v[j] = generate_random<T>(exponent_range);
+         if((i & 1) && (j & 1))
+            v[j] = -v[j - 1];
+         exact += reference_type(v[j]);
+      }
+      T sum = accumulate(v);
+      BOOST_CHECK_EQUAL(sum, T(exact));
+      //
+      // Order independence:
+      //
+      std::reverse(v.begin(), v.end());
+      BOOST_CHECK_EQUAL(accumulate(v), sum);
+      for(unsigned j = n; j > 1; --j)
+         std::swap(v[j - 1], v[gen() % j]);
+      BOOST_CHECK_EQUAL(accumulate(v), sum);
+      //
+      // Merged partial sums:
+      //
+      boost::multiprecision::cpp_bin_float_accumulator<backend_type> a, b, c;
+      for(unsigned j = 0; j < n; ++j)
+         (j % 3 ? a : b) += v[j];
+      c += b;
+      c += a;
+      BOOST_CHECK_EQUAL(T(c.sum()), sum);
+      a += b;
+      BOOST_CHECK_EQUAL(T(a.sum()), sum);
+      //
+      // Subtraction:
+      //
+      for(unsigned j = 0; j < n; ++j)
+         c -= v[j];
+      BOOST_CHECK_EQUAL(T(c.sum()), 0);
+      c.clear();
+      for(unsigned j = 0; j < n; ++j)
+         c -= v[j];
+      BOOST_CHECK_EQUAL(T(c.sum()), -sum);
+   }
+}
+
+template <class T>
+void test_special_values()
+{
+   typedef typename T::backend_type backend_type;
+   typedef boost::multiprecision::cpp_bin_float_accumulator<backend_type> accumulator_type;
+   T one(1), inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+   T big = (std::numeric_limits<T>::max)(), small = (std::numeric_limits<T>::min)();
+   T eps = std::numeric_limits<T>::epsilon();
+   //
+   // The digits span the range of exponents added, so keep that range modest for types with very wide exponents:
+   //
+   T huge = std::numeric_limits<T>::max_exponent > 20000 ? T(ldexp(one, 3000)) : big;
+   T tiny = std::numeric_limits<T>::max_exponent > 20000 ? T(ldexp(one, -3000)) : small;
+
+   accumulator_type acc;
+   BOOST_CHECK_EQUAL(T(acc.sum()), 0);
+   acc += one;
+   acc += inf;
+   BOOST_CHECK_EQUAL(T(acc.sum()), inf);
+   acc -= inf;
+   BOOST_CHECK((boost::math::isnan)(T(acc.sum())));
+   acc.clear();
+   acc -= inf;
+   BOOST_CHECK_EQUAL(T(acc.sum()), -inf);
+   acc.clear();
+   acc += nan;
+   acc += one;
+   BOOST_CHECK((boost::math::isnan)(T(acc.sum())));
+   accumulator_type acc2;
+   acc2 += one;
+   acc2 += acc;
+   BOOST_CHECK((boost::math::isnan)(T(acc2.sum())));
+   //
+   // Intermediate overflow is recovered from, but a final overflow is not:
+   //
+   acc.clear();
+   acc += big;
+   acc += big;
+   BOOST_CHECK_EQUAL(T(acc.sum()), inf);
+   acc -= big;
+   BOOST_CHECK_EQUAL(T(acc.sum()), big);
+   acc.clear();
+   acc -= big;
+   acc -= big;
+   BOOST_CHECK_EQUAL(T(acc.sum()), -inf);
+   //
+   // Underflow:
+   //
+   acc.clear();
+   acc += small;
+   BOOST_CHECK_EQUAL(T(acc.sum()), small);
+   acc += T(small * 2);
+   acc -= T(small * 5 / 2);
+   BOOST_CHECK_EQUAL(T(acc.sum()), 0);
+   //
+   // Tiny values far below the precision of the sum:
+   //
+   acc.clear();
+   acc += one;
+   acc += tiny;
+   BOOST_CHECK_EQUAL(T(acc.sum()), one);
+   acc += T(eps / 2);
+   BOOST_CHECK_EQUAL(T(acc.sum()), T(one + eps));
+   acc -= tiny;
+   BOOST_CHECK_EQUAL(T(acc.sum()), one);
+   acc -= tiny;
+   BOOST_CHECK_EQUAL(T(acc.sum()), one);
+   acc -= T(eps / 4);
+   BOOST_CHECK_EQUAL(T(acc.sum()), T(one - eps / 2));
+   //
+   // The range of the digits grows in both directions:
+   //
+   acc.clear();
+   acc += one;
+   acc += huge;
+   acc += tiny;
+   acc -= huge;
+   acc -= one;
+   BOOST_CHECK_EQUAL(T(acc.sum()), tiny);
+}
+
+//
+// Enough additions of the same value to force several rounds of carry propagation:
+//
+template <class T>
+void test_carries()
+{
+   typedef typename T::backend_type backend_type;
+   boost::multiprecision::cpp_bin_float_accumulator<backend_type> acc, neg;
+   T x = -(std::numeric_limits<T>::max)() / 65536;
+   reference_type exact = 0;
+   for(unsigned i = 0; i < 1000; ++i)
+   {
+      acc += x;
+      neg -= x;
+      exact += reference_type(x);
+   }
+   BOOST_CHECK_EQUAL(T(acc.sum()), T(exact));
+   BOOST_CHECK_EQUAL(T(neg.sum()), T(-exact));
+   acc += neg;
+   BOOST_CHECK_EQUAL(T(acc.sum()), 0);
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+   test_random<cpp_bin_float_50>(100);
+   test_random<cpp_bin_float_50>(600);
+   test_random<cpp_bin_float_single>(40);
+   test_random<cpp_bin_float_double>(300);
+   test_random<cpp_bin_float_quad>(300);
+   test_random<number<cpp_bin_float<35, digit_base_10, std::allocator<void> > > >(200);
+   test_random<number<cpp_bin_float<200, digit_base_2, void, boost::long_long_type> > >(300);
+   test_special_values<cpp_bin_float_single>();
+   test_special_values<cpp_bin_float_double>();
+   test_special_values<cpp_bin_float_quad>();
+   test_special_values<cpp_bin_float_50>();
+   test_carries<cpp_bin_float_single>();
+   test_carries<cpp_bin_float_quad>();
+   test_carries<cpp_bin_float_100>();
+   return boost::report_errors();
+}
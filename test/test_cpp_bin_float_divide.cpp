@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Check that division (which goes via a Newton reciprocal for large values), and division
+// by a cpp_bin_float_reciprocal, are correctly rounded by comparing against exact integer division:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+template <class T>
+T generate_random()
+{
+   static boost::random::mt19937 gen;
+   T val = gen();
+   T prev_val = -1;
+   while(val != prev_val)
+   {
+      val *= (gen.max)();
+      prev_val = val;
+      val += gen();
+   }
+   int e;
+   val = frexp(val, &e);
+   return ldexp(val, static_cast<int>(gen() % 200) - 100);
+}
+
+//
+// Returns the mantissa of x as an integer with exactly digits bits:
+//
+template <class T>
+boost::multiprecision::cpp_int mantissa(const T& x, int* e)
+{
+   return ldexp(frexp(x, e), std::numeric_limits<T>::digits).template convert_to<boost::multiprecision::cpp_int>();
+}
+
+template <class T>
+T reference_divide(const T& u, const T& v)
+{
+   using namespace boost::multiprecision;
+   static const int digits = std::numeric_limits<T>::digits;
+   int eu, ev;
+   cpp_int a = mantissa(T(abs(u)), &eu), b = mantissa(T(abs(v)), &ev), q, r;
+   //
+   // q has digits + 1 or digits + 2 bits, round it to digits bits by hand, ties to even:
+   //
+   a <<= digits + 1;
+   divide_qr(a, b, q, r);
+   unsigned shift = msb(q) + 1 - digits;
+   cpp_int rem = q & ((cpp_int(1) << shift) - 1), half = cpp_int(1) << (shift - 1);
+   q >>= shift;
+   if((rem > half) || ((rem == half) && ((r != 0) || bit_test(q, 0))))
+      ++q;
+   T result(q);
+   result = ldexp(result, eu - ev - digits - 1 + static_cast<int>(shift));
+   return u.sign() != v.sign() ? T(-result) : result;
+}
+
+template <class Backend>
+void test()
+{
+   typedef boost::multiprecision::number<Backend> T;
+   for(unsigned i = 0; i < 500; ++i)
+   {
+      T u = generate_random<T>();
+      T v = generate_random<T>();
+      if(i % 5 == 0)
+         v = ldexp(T(i + 1), static_cast<int>(i % 7));
+      if(i % 7 == 0)
+         u = v * (i + 3);
+      if(i & 1)
+         u = -u;
+      if(i & 2)
+         v = -v;
+      T q = u / v;
+      BOOST_CHECK_EQUAL(q, reference_divide(u, v));
+      boost::multiprecision::cpp_bin_float_reciprocal<Backend> r(v);
+      BOOST_CHECK_EQUAL(q, T(u / r));
+      T t(u);
+      t /= r;
+      BOOST_CHECK_EQUAL(q, t);
+      BOOST_CHECK_EQUAL(q, T(u / reciprocal(v)));
+      // Aliased arguments:
+      t = u;
+      t /= t;
+      BOOST_CHECK_EQUAL(t, 1);
+   }
+   //
+   // Special values:
+   //
+   T one(1), zero(0), inf = std::numeric_limits<T>::infinity();
+   BOOST_CHECK(boost::math::isnan(T(zero / reciprocal(zero))));
+   BOOST_CHECK_EQUAL(T(one / reciprocal(zero)), inf);
+   BOOST_CHECK_EQUAL(T(one / reciprocal(inf)), 0);
+   BOOST_CHECK_EQUAL(T(one / reciprocal(-one)), -1);
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+   test<cpp_bin_float<113, digit_base_2> >();
+   test<cpp_bin_float<300, digit_base_2> >();
+   test<cpp_bin_float<2000, digit_base_2> >();
+   test<cpp_bin_float<5000, digit_base_2> >();
+   return boost::report_errors();
+}
+
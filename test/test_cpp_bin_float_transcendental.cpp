@@ -0,0 +1,293 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Check the fixed point exp, log, atan and sin/cos kernels used by cpp_bin_float against cpp_dec_float
+// evaluated at a much higher precision, at several precisions including ones which aren't a multiple
+// of the limb size.  Large sin/cos arguments are reduced by hand in the reference type, so that they
+// check the exact argument reduction as well:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+//
+// The largest error seen for each type, in units of epsilon, is reported at the end:
+//
+static double max_error_seen = 0;
+
+template <class T>
+T generate_random_mantissa()
+{
+   static boost::random::mt19937 gen;
+   T val = gen();
+   T prev_val = -1;
+   while(val != prev_val)
+   {
+      val *= (gen.max)();
+      prev_val = val;
+      val += gen();
+   }
+   int e;
+   return frexp(val, &e);
+}
+
+//
+// Returns the error in result relative to the reference value in units of T's epsilon:
+//
+template <class T, class R>
+double error_in_epsilon(const T& result, const R& reference)
+{
+   R r(result.str(std::numeric_limits<R>::digits10, std::ios_base::scientific));
+   R err = abs(r - reference);
+   if(reference != 0)
+      err /= abs(reference);
+   err /= R(std::numeric_limits<T>::epsilon().str(std::numeric_limits<R>::digits10, std::ios_base::scientific));
+   return err.template convert_to<double>();
+}
+
+//
+// Returns the value one ulp above (direction 1) or below (direction -1) x > 0:
+//
+template <class T>
+T neighbour(const T& x, int direction)
+{
+   int e;
+   T m = frexp(x, &e);
+   if((direction < 0) && (m == 0.5))
+      --e;
+   return x + direction * ldexp(T(1), e - std::numeric_limits<T>::digits);
+}
+
+template <class T, class R>
+R to_reference(const T& x)
+{
+   return R(x.str(std::numeric_limits<R>::digits10, std::ios_base::scientific));
+}
+
+template <class T, class R>
+void check(const char* name, const T& arg, const T& result, const R& reference, double tolerance)
+{
+   double err = error_in_epsilon(result, reference);
+   if(err > max_error_seen)
+      max_error_seen = err;
+   if(err > tolerance)
+   {
+      BOOST_ERROR("Error too large");
+      std::cout << name << "(" << arg.str(0, std::ios_base::scientific) << ") with "
+         << std::numeric_limits<T>::digits << " bits was in error by " << err << " epsilon" << std::endl;
+   }
+}
+
+//
+// Larger exp arguments are dominated by the argument reduction and squaring, which are
+// unchanged and checked by test_exp.cpp, so these all go straight to the Taylor series kernel:
+//
+template <class T, class R>
+void test_exp(double tolerance)
+{
+   static const int exponents[] = { -1000, -200, -100, -40, -20, -5, -1, 0 };
+   for(unsigned i = 0; i < sizeof(exponents) / sizeof(exponents[0]); ++i)
+   {
+      for(unsigned j = 0; j < 4; ++j)
+      {
+         T x = ldexp(generate_random_mantissa<T>(), exponents[i]);
+         if(j & 1)
+            x = -x;
+         check("exp", x, T(exp(x)), R(exp(to_reference<T, R>(x))), tolerance);
+      }
+   }
+}
+
+//
+// Near 1 the reference sums log(1 + d) = d - d^2/2 + d^3/3 ... directly, with d = x - 1 formed exactly
+// in T: neither x itself nor cpp_dec_float's log keep d's relative precision there:
+//
+template <class T, class R>
+R reference_log(const T& x)
+{
+   T dx = x - 1;
+   if((dx == 0) || (abs(dx) > ldexp(T(1), -20)))
+      return log(to_reference<T, R>(x));
+   R d = to_reference<T, R>(dx);
+   R result = d, power = d, term;
+   for(unsigned n = 2; ; ++n)
+   {
+      power *= -d;
+      term = power / n;
+      if(abs(term) < abs(result) * std::numeric_limits<R>::epsilon())
+         break;
+      result += term;
+   }
+   return result;
+}
+
+template <class T, class R>
+void test_log(double tolerance)
+{
+   static const int digits = std::numeric_limits<T>::digits;
+   //
+   // Either side of 1, including the closest representable values, which need the scaled
+   // series argument to keep their relative precision:
+   //
+   static const int near_one[] = { 1, 2, 5, 17, 40, 64, 100, 200, 500 };
+   for(unsigned i = 0; i < sizeof(near_one) / sizeof(near_one[0]); ++i)
+   {
+      if(near_one[i] >= digits)
+         continue;
+      T d = ldexp(T(1), -near_one[i]);
+      T x = 1 + d;
+      check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+      x = 1 - d;
+      check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+      x = 1 + d * generate_random_mantissa<T>();
+      check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+   }
+   T x = 1 + std::numeric_limits<T>::epsilon();
+   check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+   x = 1 - std::numeric_limits<T>::epsilon() / 2;
+   check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+   //
+   // Either side of the switch at sqrt(2), and arguments with large and small exponents:
+   //
+   x = sqrt(T(2));
+   check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+   x = neighbour(x, -1);
+   check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+   x = sqrt(T(0.5));
+   check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+   x = neighbour(x, -1);
+   check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+   static const int exponents[] = { -3000, -100, -10, -1, 0, 1, 2, 10, 100, 3000 };
+   for(unsigned i = 0; i < sizeof(exponents) / sizeof(exponents[0]); ++i)
+   {
+      for(unsigned j = 0; j < 3; ++j)
+      {
+         x = ldexp(generate_random_mantissa<T>(), exponents[i]);
+         check("log", x, T(log(x)), reference_log<T, R>(x), tolerance);
+      }
+   }
+}
+
+template <class T, class R>
+void test_atan(double tolerance)
+{
+   //
+   // |x| < 1 with both the double precision estimate and the plain series (below about 1e-9),
+   // the tiny arguments left to the generic code, |x| > 1 and |x| >> 1 including values
+   // so large that atan(1/x) vanishes entirely:
+   //
+   static const int exponents[] = { -3000, -100, -40, -33, -32, -31, -30, -20, -5, -1, 0, 1, 2, 5, 20, 60, 100, 500, 3000 };
+   for(unsigned i = 0; i < sizeof(exponents) / sizeof(exponents[0]); ++i)
+   {
+      for(unsigned j = 0; j < 4; ++j)
+      {
+         T x = ldexp(generate_random_mantissa<T>(), exponents[i]);
+         if(j & 1)
+            x = -x;
+         check("atan", x, T(atan(x)), R(atan(to_reference<T, R>(x))), tolerance);
+      }
+   }
+   static const char* values[] = { "1", "-1", "0.5", "0.99999999999999999999", "1.00000000000000000001", "1e-9", "5e-10" };
+   for(unsigned i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+   {
+      T x(values[i]);
+      check("atan", x, T(atan(x)), R(atan(to_reference<T, R>(x))), tolerance);
+   }
+}
+
+//
+// Reference sin and cos, with the argument reduced modulo 2pi in the reference type, which has enough
+// digits to hold the integer part of the largest argument exactly:
+//
+template <class R>
+void reference_sin_cos(const R& x, R& s, R& c)
+{
+   R two_pi;
+   two_pi.backend() = boost::multiprecision::default_ops::get_constant_pi<typename R::backend_type>();
+   two_pi *= 2;
+   R r = x - two_pi * round(x / two_pi);
+   s = sin(r);
+   c = cos(r);
+}
+
+template <class T, class R>
+void check_sin_cos(const T& x, double tolerance)
+{
+   R s, c;
+   reference_sin_cos(to_reference<T, R>(x), s, c);
+   check("sin", x, T(sin(x)), s, tolerance);
+   check("cos", x, T(cos(x)), c, tolerance);
+}
+
+template <class T, class R>
+void test_sin_cos(double tolerance)
+{
+   //
+   // Tiny arguments either side of the switch to the generic code, arguments which need no reduction,
+   // and large arguments up to 2^850, which all go through the exact (Payne-Hanek) reduction:
+   //
+   static const int exponents[] = { -3000, -100, -40, -33, -32, -31, -30, -10, -1, 0, 1, 2, 4, 10, 30, 60, 100, 200, 500, 850 };
+   for(unsigned i = 0; i < sizeof(exponents) / sizeof(exponents[0]); ++i)
+   {
+      for(unsigned j = 0; j < 4; ++j)
+      {
+         T x = ldexp(generate_random_mantissa<T>(), exponents[i]);
+         if(j & 1)
+            x = -x;
+         check_sin_cos<T, R>(x, tolerance);
+      }
+   }
+   //
+   // Values close to multiples of pi/2, where the result loses many bits to cancellation
+   // unless the reduction is exact:
+   //
+   static const char* values[] = { "0.78539816339744830961566084581987572104929234984377645524373614807695410157155224965700870633552926699553702162832057666177346115238764555793133985203212027936257102567548463027638991115573723873259549110720274391648336153211891205844669579131780047728641214173086508715261358166205334840181506228531843114675165157889704372038023024070731352292884109197314759000283263263720511663034603673798537790235826431759143989798827304189", "355", "-355", "103993", "104348", "1e22" };
+   for(unsigned i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+   {
+      T x(values[i]);
+      check_sin_cos<T, R>(x, tolerance);
+      check_sin_cos<T, R>(neighbour(abs(x), 1) * x.sign(), tolerance);
+      check_sin_cos<T, R>(neighbour(abs(x), -1) * x.sign(), tolerance);
+   }
+   //
+   // The double closest to a multiple of pi/2, from Muller, Elementary Functions, 2006:
+   //
+   T x = ldexp(T(6381956970095103uLL), 797);
+   check_sin_cos<T, R>(x, tolerance);
+}
+
+template <class T, class R>
+void test(double tolerance)
+{
+   max_error_seen = 0;
+   test_exp<T, R>(tolerance);
+   test_log<T, R>(tolerance);
+   test_atan<T, R>(tolerance);
+   test_sin_cos<T, R>(tolerance);
+   std::cout << "Max error with " << std::numeric_limits<T>::digits << " bits was " << max_error_seen << " epsilon" << std::endl;
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+   //
+   // The reference type has about 300 more decimal digits than the type under test, enough to hold the
+   // integer part of a 2^850 argument and still reduce it accurately:
+   //
+   test<number<cpp_bin_float<64, digit_base_2> >, number<cpp_dec_float<320> > >(2);
+   test<number<cpp_bin_float<113, digit_base_2> >, number<cpp_dec_float<340> > >(2);
+   test<number<cpp_bin_float<200, digit_base_2> >, number<cpp_dec_float<360> > >(2);
+   test<number<cpp_bin_float<333, digit_base_2> >, number<cpp_dec_float<400> > >(2);
+   test<cpp_bin_float_50, number<cpp_dec_float<350> > >(2);
+   test<number<cpp_bin_float<1001, digit_base_2> >, number<cpp_dec_float<600> > >(2);
+   return boost::report_errors();
+}
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+
+//
+// Check that ldexp and frexp (which go via the table of powers of 2 and its
+// extension to large exponents) give exact results whenever the result is
+// representable:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include "test.hpp"
+
+template <class Number>
+void test(int max_exp, bool exact)
+{
+   Number up(1), down(1);
+   const Number tol = exact ? Number(0) : Number(std::numeric_limits<Number>::epsilon());
+   for(int i = 0; i <= max_exp; ++i)
+   {
+      if(exact)
+      {
+         BOOST_CHECK_EQUAL(Number(ldexp(Number(1), i)), up);
+         BOOST_CHECK_EQUAL(Number(ldexp(Number(1), -i)), down);
+         BOOST_CHECK_EQUAL(Number(ldexp(Number(3), -i)), Number(3 * down));
+         BOOST_CHECK_EQUAL(Number(ldexp(up, -i)), Number(1));
+         BOOST_CHECK_EQUAL(Number(ldexp(down, i)), Number(1));
+      }
+      else
+      {
+         BOOST_CHECK_CLOSE_FRACTION(Number(ldexp(Number(1), i)), up, std::numeric_limits<Number>::epsilon());
+         BOOST_CHECK_CLOSE_FRACTION(Number(ldexp(Number(1), -i)), down, std::numeric_limits<Number>::epsilon());
+         BOOST_CHECK_CLOSE_FRACTION(Number(ldexp(Number(3), -i)), Number(3 * down), std::numeric_limits<Number>::epsilon());
+      }
+      int e;
+      Number f = frexp(3 * up, &e);
+      BOOST_CHECK_EQUAL(e, i + 2);
+      BOOST_CHECK_CLOSE_FRACTION(f, Number(0.75), tol);
+      f = frexp(3 * down, &e);
+      BOOST_CHECK_EQUAL(e, 2 - i);
+      BOOST_CHECK_CLOSE_FRACTION(f, Number(0.75), tol);
+
+      up *= 2;
+      down /= 2;
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+   //
+   // 2^-n has n significant decimal digits, so these are exact:
+   //
+   test<number<cpp_dec_float<1000> > >(600, true);
+   test<number<cpp_dec_float<150> > >(120, true);
+   //
+   // And these are not:
+   //
+   test<cpp_dec_float_50>(600, false);
+   test<cpp_dec_float_100>(600, false);
+   return boost::report_errors();
+}
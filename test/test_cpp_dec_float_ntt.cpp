@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Compare the results of large cpp_dec_float multiplications (which go via the
+// number theoretic transform code path) against exact integer products from GMP:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+template <class T>
+T generate_random(unsigned digits_wanted)
+{
+   static boost::random::mt19937 gen;
+   T val = 0;
+   for(unsigned i = 0; i < digits_wanted; i += 9)
+   {
+      val *= 1000000000u;
+      val += gen() % 1000000000u;
+   }
+   return val % pow(T(10), digits_wanted);
+}
+
+template <class Number>
+void test_multiply(unsigned digits_a, unsigned digits_b)
+{
+   using namespace boost::multiprecision;
+
+   mpz_int a = generate_random<mpz_int>(digits_a);
+   mpz_int b = generate_random<mpz_int>(digits_b);
+   Number a1(a.str()), b1(b.str());
+   //
+   // These products are exactly representable in Number:
+   //
+   BOOST_CHECK_EQUAL(Number(mpz_int(a * b).str()), a1 * b1);
+   BOOST_CHECK_EQUAL(Number(mpz_int(-a * b).str()), -a1 * b1);
+   Number t(a1);
+   if(2 * digits_a <= digits_a + digits_b)
+   {
+      BOOST_CHECK_EQUAL(Number(mpz_int(a * a).str()), a1 * a1);
+      t *= t;
+      BOOST_CHECK_EQUAL(Number(mpz_int(a * a).str()), t);
+      t = a1;
+   }
+   t *= b1;
+   BOOST_CHECK_EQUAL(Number(mpz_int(a * b).str()), t);
+   //
+   // Shifting the decimal point doesn't change the digits:
+   //
+   Number sa("1e-37"), sb("1e2001");
+   BOOST_CHECK_EQUAL(Number(mpz_int(a * b).str()) * Number("1e1964"), (a1 * sa) * (b1 * sb));
+   //
+   // Values with long runs of all-nines or all-zero elements, these stress the carry propagation:
+   //
+   mpz_int c = pow(mpz_int(10), digits_a) - 1;
+   mpz_int d = pow(mpz_int(10), digits_b) - 1;
+   Number c1(c.str()), d1(d.str());
+   BOOST_CHECK_EQUAL(Number(mpz_int(c * d).str()), c1 * d1);
+   if(2 * digits_a <= digits_a + digits_b)
+      BOOST_CHECK_EQUAL(Number(mpz_int(c * c).str()), c1 * c1);
+   c += 2;
+   c1 += 2;
+   BOOST_CHECK_EQUAL(Number(mpz_int(c * d).str()), c1 * d1);
+}
+
+template <class Number>
+void test_truncated(unsigned digits)
+{
+   using namespace boost::multiprecision;
+   //
+   // Full precision arguments whose product must be truncated, the result should
+   // be within a couple of epsilon of the exact product:
+   //
+   mpz_int a = generate_random<mpz_int>(digits);
+   mpz_int b = generate_random<mpz_int>(digits);
+   Number a1(a.str()), b1(b.str());
+   Number exact(mpz_int(a * b).str());
+   BOOST_CHECK_LE(abs(a1 * b1 - exact), exact * std::numeric_limits<Number>::epsilon() * 2);
+   exact = Number(mpz_int(a * a).str());
+   BOOST_CHECK_LE(abs(a1 * a1 - exact), exact * std::numeric_limits<Number>::epsilon() * 2);
+}
+
+template <unsigned Digits10>
+void test()
+{
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_dec_float<Digits10> > number_type;
+   for(unsigned i = 0; i < 5; ++i)
+   {
+      test_multiply<number_type>(Digits10 / 2, Digits10 / 2);
+      test_multiply<number_type>(Digits10 / 3, 2 * Digits10 / 3);
+      test_multiply<number_type>(Digits10 - 10, 9);
+      test_truncated<number_type>(Digits10);
+   }
+}
+
+int main()
+{
+   test<100>();
+   test<1000>();
+   test<12000>();
+   //
+   // Precisions beyond the reach of the long multiplication:
+   //
+   test<16000>();
+   test<40000>();
+   return boost::report_errors();
+}
@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Compare the results of large divisions (which go via the recursive
+// Burnikel-Ziegler code path) against GMP:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include "test.hpp"
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   typedef boost::random::mt19937::result_type random_type;
+
+   T max_val = T(1) << bits_wanted;
+   unsigned bits_per_r_val = std::numeric_limits<random_type>::digits - 1;
+   while((random_type(1) << bits_per_r_val) > (gen.max)()) --bits_per_r_val;
+
+   unsigned terms_needed = bits_wanted / bits_per_r_val + 1;
+
+   T val = 0;
+   for(unsigned i = 0; i < terms_needed; ++i)
+   {
+      val *= (gen.max)();
+      val += gen();
+   }
+   val %= max_val;
+   return val;
+}
+
+template <class Number>
+void check_divide(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& b)
+{
+   using namespace boost::multiprecision;
+
+   Number a1(a.str()), b1(b.str());
+
+   BOOST_CHECK_EQUAL(mpz_int(a / b).str(), Number(a1 / b1).str());
+   BOOST_CHECK_EQUAL(mpz_int(a % b).str(), Number(a1 % b1).str());
+   BOOST_CHECK_EQUAL(mpz_int(-a / b).str(), Number(-a1 / b1).str());
+   BOOST_CHECK_EQUAL(mpz_int(a % -b).str(), Number(a1 % -b1).str());
+   BOOST_CHECK_EQUAL(mpz_int(-a % b).str(), Number(-a1 % b1).str());
+   Number q, r;
+   divide_qr(a1, b1, q, r);
+   BOOST_CHECK_EQUAL(mpz_int(a / b).str(), q.str());
+   BOOST_CHECK_EQUAL(mpz_int(a % b).str(), r.str());
+   // Aliased arguments:
+   q = a1;
+   divide_qr(q, b1, q, r);
+   BOOST_CHECK_EQUAL(mpz_int(a / b).str(), q.str());
+   BOOST_CHECK_EQUAL(mpz_int(a % b).str(), r.str());
+   r = b1;
+   divide_qr(a1, r, q, r);
+   BOOST_CHECK_EQUAL(mpz_int(a / b).str(), q.str());
+   BOOST_CHECK_EQUAL(mpz_int(a % b).str(), r.str());
+   // Exact division:
+   Number p = a1 * b1;
+   divide_qr(p, b1, q, r);
+   BOOST_CHECK_EQUAL(q, a1);
+   BOOST_CHECK_EQUAL(r, 0);
+}
+
+template <class Number>
+void test_divide(unsigned bits_a, unsigned bits_b)
+{
+   using namespace boost::multiprecision;
+
+   mpz_int a = generate_random<mpz_int>(bits_a);
+   mpz_int b = generate_random<mpz_int>(bits_b);
+   if(b == 0)
+      b = 1;
+   check_divide<Number>(a, b);
+   //
+   // Divisors that are powers of 2 or one less than a power of 2, and numerators
+   // which are all ones, these exercise the quotient correction steps:
+   //
+   check_divide<Number>(a, mpz_int(1) << bits_b);
+   check_divide<Number>(a, (mpz_int(1) << bits_b) - 1);
+   check_divide<Number>((mpz_int(1) << bits_a) - 1, b);
+   check_divide<Number>((mpz_int(1) << bits_a) - 1, (mpz_int(1) << bits_b) - 1);
+   check_divide<Number>((mpz_int(1) << bits_a) - 1, (mpz_int(1) << bits_b) + 1);
+}
+
+template <class Number>
+void test()
+{
+   static const unsigned sizes[] = { 64, 1000, 3840, 4000, 4096, 8000, 8192, 12000, 16384, 30000 };
+   static const unsigned n = sizeof(sizes) / sizeof(sizes[0]);
+   for(unsigned i = 0; i < n; ++i)
+   {
+      for(unsigned j = 0; j <= i; ++j)
+      {
+         test_divide<Number>(sizes[i], sizes[j]);
+         test_divide<Number>(sizes[i] + 31 * j, sizes[j] + 7 * i);
+      }
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_int>();
+   test<number<cpp_int_backend<0, 0, signed_magnitude, checked> > >();
+   test<number<cpp_int_backend<0, 0, signed_magnitude, unchecked>, et_off> >();
+   return boost::report_errors();
+}
+
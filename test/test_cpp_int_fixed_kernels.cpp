@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Check the unrolled add, subtract and multiply kernels used by small unchecked fixed
+// precision types against the same operations in arbitrary precision, reduced modulo 2^bits:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+//
+// Returns the value of x as held by T, for unsigned types negative values wrap around:
+//
+template <class T>
+T reduce(boost::multiprecision::cpp_int x)
+{
+   using namespace boost::multiprecision;
+   static const unsigned bits = std::numeric_limits<T>::digits;
+   bool neg = x < 0;
+   x = abs(x);
+   x &= (cpp_int(1) << bits) - 1;
+   if(std::numeric_limits<T>::is_signed)
+   {
+      T r(x);
+      return neg ? T(T(0) - r) : r;
+   }
+   if(neg && x)
+      x = (cpp_int(1) << bits) - x;
+   return T(x);
+}
+
+template <class T>
+void test()
+{
+   using namespace boost::multiprecision;
+   static boost::random::mt19937 gen;
+   static const unsigned limbs32 = std::numeric_limits<T>::digits / 32;
+   for(unsigned i = 0; i < 5000; ++i)
+   {
+      //
+      // Mix values which fill the type, which go through the kernels, with narrower values which don't:
+      //
+      cpp_int a = 0, b = 0;
+      unsigned la = (i & 4) ? limbs32 : gen() % (limbs32 + 1);
+      unsigned lb = (i & 8) ? limbs32 : gen() % (limbs32 + 1);
+      for(unsigned j = 0; j < la; ++j)
+         a = (a << 32) | gen();
+      for(unsigned j = 0; j < lb; ++j)
+         b = (b << 32) | gen();
+      if(i % 16 == 3)
+         b = a;
+      if(std::numeric_limits<T>::is_signed)
+      {
+         if(i & 1)
+            a = -a;
+         if(i & 2)
+            b = -b;
+      }
+      T ta = reduce<T>(a), tb = reduce<T>(b);
+      BOOST_CHECK_EQUAL(T(ta + tb), reduce<T>(a + b));
+      BOOST_CHECK_EQUAL(T(ta - tb), reduce<T>(a - b));
+      BOOST_CHECK_EQUAL(T(ta * tb), reduce<T>(a * b));
+      // Aliased arguments:
+      T t(ta);
+      t += t;
+      BOOST_CHECK_EQUAL(t, reduce<T>(a + a));
+      t = ta;
+      t -= tb;
+      BOOST_CHECK_EQUAL(t, reduce<T>(a - b));
+      t = tb;
+      t = ta - t;
+      BOOST_CHECK_EQUAL(t, reduce<T>(a - b));
+      t = ta;
+      t *= t;
+      BOOST_CHECK_EQUAL(t, reduce<T>(a * a));
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+   test<int128_t>();
+   test<uint128_t>();
+   test<int256_t>();
+   test<uint256_t>();
+   test<int512_t>();
+   test<uint512_t>();
+   test<int1024_t>();
+   test<uint1024_t>();
+   // A partial top limb, and a type too large for the kernels:
+   test<number<cpp_int_backend<200, 200, signed_magnitude, unchecked, void> > >();
+   test<number<cpp_int_backend<200, 200, unsigned_magnitude, unchecked, void> > >();
+   test<number<cpp_int_backend<2048, 2048, unsigned_magnitude, unchecked, void> > >();
+   return boost::report_errors();
+}
+
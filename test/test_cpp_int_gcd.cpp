@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Compare the results of gcd (which goes via Lehmer's algorithm and the half-gcd
+// for large values) and of extended_gcd against GMP:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include "test.hpp"
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   typedef boost::random::mt19937::result_type random_type;
+
+   T max_val = T(1) << bits_wanted;
+   unsigned bits_per_r_val = std::numeric_limits<random_type>::digits - 1;
+   while((random_type(1) << bits_per_r_val) > (gen.max)()) --bits_per_r_val;
+
+   unsigned terms_needed = bits_wanted / bits_per_r_val + 1;
+
+   T val = 0;
+   for(unsigned i = 0; i < terms_needed; ++i)
+   {
+      val *= (gen.max)();
+      val += gen();
+   }
+   val %= max_val;
+   return val;
+}
+
+template <class Number>
+void test_gcd(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& b)
+{
+   using namespace boost::multiprecision;
+   Number a1(a.str()), b1(b.str());
+   mpz_int g = gcd(a, b);
+   BOOST_CHECK_EQUAL(g.str(), Number(gcd(a1, b1)).str());
+   BOOST_CHECK_EQUAL(g.str(), Number(gcd(b1, a1)).str());
+   mpz_int l = lcm(a, b);
+   if(!std::numeric_limits<Number>::is_bounded || (l == 0) || (msb(l) < (unsigned)std::numeric_limits<Number>::digits))
+      BOOST_CHECK_EQUAL(l.str(), Number(lcm(a1, b1)).str());
+}
+
+template <class Number>
+void test_extended_gcd(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& b)
+{
+   using namespace boost::multiprecision;
+   Number a1(a.str()), b1(b.str()), x, y;
+   Number g = extended_gcd(a1, b1, x, y);
+   mpz_int mg = gcd(a, b);
+   BOOST_CHECK_EQUAL(mg.str(), g.str());
+   BOOST_CHECK_EQUAL(mg.str(), mpz_int(a * mpz_int(x.str()) + b * mpz_int(y.str())).str());
+   if(b != 0)
+   {
+      //
+      // x is normalised to [0, |b| / g):
+      //
+      BOOST_CHECK(x >= 0);
+      BOOST_CHECK(mpz_int(x.str()) < mpz_int(abs(b) / mg));
+   }
+}
+
+template <class Number>
+void test(unsigned max_bits)
+{
+   using namespace boost::multiprecision;
+
+   static const unsigned sizes[] = { 3, 64, 65, 128, 129, 200, 512, 1000, 1024, 2048, 4000, 8192, 20000, 50000 };
+   static const unsigned n = sizeof(sizes) / sizeof(sizes[0]);
+   for(unsigned i = 0; i < n; ++i)
+   {
+      if(sizes[i] > max_bits)
+         break;
+      for(unsigned j = 0; j < 4; ++j)
+      {
+         mpz_int a = generate_random<mpz_int>(sizes[i]);
+         mpz_int b = generate_random<mpz_int>(sizes[i]);
+         test_gcd<Number>(a, b);
+         test_extended_gcd<Number>(a, b);
+         //
+         // Values with a large common factor:
+         //
+         mpz_int c = generate_random<mpz_int>(sizes[i] / 2 + 1) + 1;
+         test_gcd<Number>((a >> (sizes[i] / 2)) * c, (b >> (sizes[i] / 2)) * c);
+         test_extended_gcd<Number>((a >> (sizes[i] / 2)) * c, (b >> (sizes[i] / 2)) * c);
+         //
+         // Values of very different sizes:
+         //
+         test_gcd<Number>(a, b >> (sizes[i] / 2));
+         test_extended_gcd<Number>(a, b >> (sizes[i] / 2));
+         test_extended_gcd<Number>(b >> (sizes[i] / 2), a);
+         //
+         // Powers of two:
+         //
+         test_gcd<Number>(a << 7, b << 13);
+         //
+         // Single limb arguments:
+         //
+         test_gcd<Number>(a, b & 0xFFFFFFFFu);
+         test_gcd<Number>(a, (b & 0xFFFFFFFFu) * 12);
+      }
+      //
+      // Consecutive Fibonacci numbers, which have all quotients one:
+      //
+      mpz_int f0(0), f1(1);
+      while(msb(f1) < sizes[i] - 1)
+      {
+         f0 += f1;
+         f0.swap(f1);
+      }
+      test_gcd<Number>(f1, f0);
+      test_extended_gcd<Number>(f1, f0);
+      test_gcd<Number>(f1 * 3, f0 * 3);
+   }
+   //
+   // Corner cases:
+   //
+   Number x, y;
+   BOOST_CHECK_EQUAL(gcd(Number(0), Number(0)), 0);
+   BOOST_CHECK_EQUAL(extended_gcd(Number(0), Number(0), x, y), 0);
+   BOOST_CHECK_EQUAL(extended_gcd(Number(0), Number(-5), x, y), 5);
+   BOOST_CHECK_EQUAL(y, -1);
+   BOOST_CHECK_EQUAL(extended_gcd(Number(-7), Number(0), x, y), 7);
+   BOOST_CHECK_EQUAL(x, -1);
+   BOOST_CHECK_EQUAL(y, 0);
+   BOOST_CHECK_EQUAL(extended_gcd(Number(240), Number(46), x, y), 2);
+   BOOST_CHECK_EQUAL(x, 14);
+   BOOST_CHECK_EQUAL(y, -73);
+   BOOST_CHECK_EQUAL(extended_gcd(Number(-240), Number(46), x, y), 2);
+   BOOST_CHECK_EQUAL(x, 9);
+   BOOST_CHECK_EQUAL(y, 47);
+
+   mpz_int a = generate_random<mpz_int>(max_bits < 1000 ? max_bits - 1 : 1000);
+   mpz_int b = generate_random<mpz_int>(max_bits < 1000 ? max_bits - 1 : 1000);
+   test_gcd<Number>(-a, b);
+   test_extended_gcd<Number>(-a, b);
+   test_extended_gcd<Number>(a, -b);
+   test_extended_gcd<Number>(-a, -b);
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_int>(100000);
+   test<number<cpp_int_backend<0, 0, signed_magnitude, checked> > >(20000);
+   test<number<cpp_int_backend<0, 0, signed_magnitude, unchecked>, et_off> >(20000);
+   test<int1024_t>(1000);
+   test<checked_int1024_t>(1000);
+   test<number<cpp_int_backend<8192, 8192, signed_magnitude, unchecked, void> > >(8000);
+   return boost::report_errors();
+}
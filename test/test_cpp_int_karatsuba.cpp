@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Compare the results of large multiplications (which go via the Karatsuba
+// and Toom-3 code paths) against GMP:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include "test.hpp"
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   typedef boost::random::mt19937::result_type random_type;
+
+   T max_val = T(1) << bits_wanted;
+   unsigned bits_per_r_val = std::numeric_limits<random_type>::digits - 1;
+   while((random_type(1) << bits_per_r_val) > (gen.max)()) --bits_per_r_val;
+
+   unsigned terms_needed = bits_wanted / bits_per_r_val + 1;
+
+   T val = 0;
+   for(unsigned i = 0; i < terms_needed; ++i)
+   {
+      val *= (gen.max)();
+      val += gen();
+   }
+   val %= max_val;
+   return val;
+}
+
+template <class Number>
+void test_multiply(unsigned bits_a, unsigned bits_b)
+{
+   using namespace boost::multiprecision;
+
+   mpz_int a = generate_random<mpz_int>(bits_a);
+   mpz_int b = generate_random<mpz_int>(bits_b);
+   Number a1(a.str()), b1(b.str());
+
+   BOOST_CHECK_EQUAL(mpz_int(a * b).str(), Number(a1 * b1).str());
+   BOOST_CHECK_EQUAL(mpz_int(-a * b).str(), Number(-a1 * b1).str());
+   BOOST_CHECK_EQUAL(mpz_int(b * -a).str(), Number(b1 * -a1).str());
+   BOOST_CHECK_EQUAL(mpz_int(a * a).str(), Number(a1 * a1).str());
+   BOOST_CHECK_EQUAL((mpz_int(a) *= b).str(), (Number(a1) *= b1).str());
+   Number t(a1);
+   t *= t;
+   BOOST_CHECK_EQUAL(mpz_int(a * a).str(), t.str());
+   //
+   // Values with long runs of all-ones or all-zero limbs, these stress the carry propagation:
+   //
+   Number c = (Number(1) << bits_a) - 1;
+   Number d = (Number(1) << bits_b) - 1;
+   mpz_int c2 = (mpz_int(1) << bits_a) - 1;
+   mpz_int d2 = (mpz_int(1) << bits_b) - 1;
+   BOOST_CHECK_EQUAL(mpz_int(c2 * d2).str(), Number(c * d).str());
+   BOOST_CHECK_EQUAL(mpz_int(c2 * c2).str(), Number(c * c).str());
+   t = -a1;
+   BOOST_CHECK_EQUAL(mpz_int(a * a).str(), Number(t * t).str());
+   c = (Number(1) << bits_a) + 1;
+   c2 = (mpz_int(1) << bits_a) + 1;
+   BOOST_CHECK_EQUAL(mpz_int(c2 * d2).str(), Number(c * d).str());
+}
+
+template <class Number>
+void test()
+{
+   static const unsigned sizes[] = { 64, 1000, 2500, 2560, 4096, 5000, 8192, 12000, 16384, 30000 };
+   static const unsigned n = sizeof(sizes) / sizeof(sizes[0]);
+   for(unsigned i = 0; i < n; ++i)
+   {
+      for(unsigned j = 0; j < n; ++j)
+      {
+         test_multiply<Number>(sizes[i], sizes[j]);
+         test_multiply<Number>(sizes[i] + 17 * j, sizes[j] + 5 * i);
+      }
+   }
+}
+
+//
+// Squaring of fixed precision types, which uses the dedicated squaring code when the result
+// fits and long multiplication (which truncates or throws) otherwise:
+//
+template <class Number>
+void test_fixed_square()
+{
+   using namespace boost::multiprecision;
+   static const unsigned bits = std::numeric_limits<Number>::digits;
+   mpz_int mask = (mpz_int(1) << bits) - 1;
+   for(unsigned i = 1; i < bits; i += 37)
+   {
+      mpz_int a = generate_random<mpz_int>(i);
+      Number a1(a.str());
+      if(2 * i < bits)
+      {
+         BOOST_CHECK_EQUAL(mpz_int(a * a).str(), Number(a1 * a1).str());
+         a1 *= a1;
+         BOOST_CHECK_EQUAL(mpz_int(a * a).str(), a1.str());
+      }
+      else if(!std::numeric_limits<Number>::is_signed)
+         BOOST_CHECK_EQUAL(mpz_int((a * a) & mask).str(), Number(a1 * a1).str());
+   }
+   Number m = (std::numeric_limits<Number>::max)() >> (bits / 2);
+   mpz_int m2(m.str());
+   BOOST_CHECK_EQUAL(mpz_int(m2 * m2).str(), Number(m * m).str());
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_int>();
+   test<number<cpp_int_backend<0, 0, signed_magnitude, checked> > >();
+   test<number<cpp_int_backend<0, 0, signed_magnitude, unchecked>, et_off> >();
+   // Bounded but allocated types use Karatsuba, but not Toom-3:
+   test<number<cpp_int_backend<0, 65536, signed_magnitude, checked> > >();
+   test_fixed_square<uint1024_t>();
+   test_fixed_square<int1024_t>();
+   test_fixed_square<checked_int1024_t>();
+   test_fixed_square<number<cpp_int_backend<1000, 1000, unsigned_magnitude, unchecked, void> > >();
+   return boost::report_errors();
+}
+
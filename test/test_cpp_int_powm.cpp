@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Compare the results of powm (which goes via Montgomery multiplication for
+// odd moduli) and of montgomery_context against GMP:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include "test.hpp"
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   typedef boost::random::mt19937::result_type random_type;
+
+   T max_val = T(1) << bits_wanted;
+   unsigned bits_per_r_val = std::numeric_limits<random_type>::digits - 1;
+   while((random_type(1) << bits_per_r_val) > (gen.max)()) --bits_per_r_val;
+
+   unsigned terms_needed = bits_wanted / bits_per_r_val + 1;
+
+   T val = 0;
+   for(unsigned i = 0; i < terms_needed; ++i)
+   {
+      val *= (gen.max)();
+      val += gen();
+   }
+   val %= max_val;
+   return val;
+}
+
+template <class Number>
+void test_powm(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& p, const boost::multiprecision::mpz_int& m)
+{
+   using namespace boost::multiprecision;
+   Number a1(a.str()), p1(p.str()), m1(m.str());
+   BOOST_CHECK_EQUAL(mpz_int(powm(a, p, m)).str(), Number(powm(a1, p1, m1)).str());
+   BOOST_CHECK_EQUAL(mpz_int(powm(a, 65537u, m)).str(), Number(powm(a1, 65537u, m1)).str());
+   BOOST_CHECK_EQUAL(mpz_int(powm(a, 2, m)).str(), Number(powm(a1, 2, m1)).str());
+   BOOST_CHECK_EQUAL(mpz_int(powm(a, 0u, m)).str(), Number(powm(a1, 0u, m1)).str());
+}
+
+template <class Number>
+void test_context(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& b, const boost::multiprecision::mpz_int& p, const boost::multiprecision::mpz_int& m)
+{
+   using namespace boost::multiprecision;
+   typedef typename Number::backend_type backend_type;
+   Number a1(a.str()), b1(b.str()), p1(p.str()), m1(m.str());
+
+   montgomery_context<backend_type> ctx(m1);
+   BOOST_CHECK_EQUAL(ctx.modulus().compare(m1.backend()), 0);
+   BOOST_CHECK_EQUAL(mpz_int(powm(a, p, m)).str(), ctx.powm(a1, p1).str());
+   BOOST_CHECK_EQUAL(mpz_int(powm(b, p, m)).str(), ctx.powm(b1, p1).str());
+   //
+   // Round trip through Montgomery form, and multiplication in Montgomery form:
+   //
+   Number am, bm, r;
+   ctx.to_montgomery(am.backend(), a1.backend());
+   ctx.to_montgomery(bm.backend(), b1.backend());
+   BOOST_CHECK(am < m1);
+   ctx.from_montgomery(r.backend(), am.backend());
+   BOOST_CHECK_EQUAL(mpz_int(a % m).str(), r.str());
+   ctx.multiply(r.backend(), am.backend(), bm.backend());
+   ctx.from_montgomery(r.backend(), r.backend());
+   BOOST_CHECK_EQUAL(mpz_int((a * b) % m).str(), r.str());
+   ctx.multiply(am.backend(), am.backend(), am.backend());
+   ctx.from_montgomery(r.backend(), am.backend());
+   BOOST_CHECK_EQUAL(mpz_int((a * a) % m).str(), r.str());
+}
+
+template <class Number>
+void test(unsigned max_bits)
+{
+   using namespace boost::multiprecision;
+
+   static const unsigned sizes[] = { 3, 64, 65, 128, 200, 512, 1024, 2048, 2600, 4096, 8192 };
+   static const unsigned n = sizeof(sizes) / sizeof(sizes[0]);
+   for(unsigned i = 0; i < n; ++i)
+   {
+      if(sizes[i] >= max_bits)
+         break;
+      mpz_int m = generate_random<mpz_int>(sizes[i]);
+      bit_set(m, sizes[i] - 1);
+      bit_set(m, 0);
+      mpz_int a = generate_random<mpz_int>(sizes[i]) % m;
+      mpz_int b = generate_random<mpz_int>(sizes[i] + 10);
+      mpz_int p = generate_random<mpz_int>(sizes[i] < 1024 ? sizes[i] : 1024);
+      test_powm<Number>(a, p, m);
+      test_powm<Number>(b % m, p, m);
+      test_powm<Number>(a, p, m - 1);  // Even modulus, uses the generic code
+      test_powm<Number>(a, p + 1, m);
+      test_context<Number>(a, b % m, p, m);
+      //
+      // Moduli close to a power of the limb size:
+      //
+      m = (mpz_int(1) << sizes[i]) - 1;
+      test_powm<Number>(a, p, m);
+      test_context<Number>(a, m - 1, p, m);
+      m = (mpz_int(1) << sizes[i]) + 1;
+      test_powm<Number>(a, p, m);
+      test_context<Number>(a, m - 1, p, m);
+   }
+   //
+   // Corner cases:
+   //
+   BOOST_CHECK_EQUAL(powm(Number(5), Number(3), Number(1)), 0);
+   BOOST_CHECK_EQUAL(powm(Number(0), Number(3), Number(7)), 0);
+   BOOST_CHECK_EQUAL(powm(Number(0), Number(0), Number(7)), 1);
+   BOOST_CHECK_EQUAL(powm(Number(12), Number(0), Number(7)), 1);
+   BOOST_CHECK_THROW(montgomery_context<typename Number::backend_type>(Number(10)), std::domain_error);
+   BOOST_CHECK_THROW(montgomery_context<typename Number::backend_type>(Number(1)), std::domain_error);
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_int>(10000);
+   test<number<cpp_int_backend<0, 0, signed_magnitude, checked> > >(10000);
+   test<number<cpp_int_backend<0, 0, signed_magnitude, unchecked>, et_off> >(10000);
+   test<uint1024_t>(1024);
+   test<checked_int1024_t>(1024);
+   test<number<cpp_int_backend<4096, 4096, unsigned_magnitude, unchecked, void> > >(4096);
+   return boost::report_errors();
+}
+
@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Compare decimal string conversion of large values (which go via the
+// divide and conquer code paths) against GMP:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include "test.hpp"
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   typedef boost::random::mt19937::result_type random_type;
+
+   T max_val = T(1) << bits_wanted;
+   unsigned bits_per_r_val = std::numeric_limits<random_type>::digits - 1;
+   while((random_type(1) << bits_per_r_val) > (gen.max)()) --bits_per_r_val;
+
+   unsigned terms_needed = bits_wanted / bits_per_r_val + 1;
+
+   T val = 0;
+   for(unsigned i = 0; i < terms_needed; ++i)
+   {
+      val *= (gen.max)();
+      val += gen();
+   }
+   val %= max_val;
+   return val;
+}
+
+template <class Number>
+void check_round_trip(const boost::multiprecision::mpz_int& a)
+{
+   std::string s = a.str();
+   Number a1(s);
+   BOOST_CHECK_EQUAL(s, a1.str());
+   BOOST_CHECK_EQUAL(boost::multiprecision::mpz_int(a1.str(0, std::ios_base::hex | std::ios_base::showbase)), a);
+   BOOST_CHECK_EQUAL(a.str(0, std::ios_base::showpos), a1.str(0, std::ios_base::showpos));
+   a1 = -a1;
+   BOOST_CHECK_EQUAL(boost::multiprecision::mpz_int(-a).str(), a1.str());
+   BOOST_CHECK_EQUAL(Number(boost::multiprecision::mpz_int(-a).str()), a1);
+}
+
+template <class Number>
+void test_string(unsigned bits)
+{
+   using namespace boost::multiprecision;
+
+   check_round_trip<Number>(generate_random<mpz_int>(bits));
+   //
+   // Values whose decimal representation contains long runs of zeros or nines, and values
+   // which are exact powers of the block divisors used internally:
+   //
+   mpz_int p = pow(mpz_int(10), bits / 3);
+   check_round_trip<Number>(p);
+   check_round_trip<Number>(p - 1);
+   check_round_trip<Number>(p + 1);
+   check_round_trip<Number>(p * generate_random<mpz_int>(bits / 2) + 7);
+   check_round_trip<Number>((mpz_int(1) << bits) - 1);
+   check_round_trip<Number>(mpz_int(1) << bits);
+   for(unsigned k = 1; k < 8; ++k)
+   {
+      mpz_int q = pow(mpz_int(10), 19u << k);
+      if(msb(q) < bits)
+      {
+         check_round_trip<Number>(q);
+         check_round_trip<Number>(q - 1);
+         check_round_trip<Number>(q * q + 1);
+      }
+   }
+}
+
+template <class Number>
+void test()
+{
+   static const unsigned sizes[] = { 64, 200, 1000, 1920, 2000, 4096, 5000, 10000, 30000, 65000 };
+   static const unsigned n = sizeof(sizes) / sizeof(sizes[0]);
+   for(unsigned i = 0; i < n; ++i)
+   {
+      test_string<Number>(sizes[i]);
+      test_string<Number>(sizes[i] + 31 * i + 1);
+   }
+   //
+   // Invalid characters must still be detected in the middle of long strings:
+   //
+   BOOST_CHECK_THROW(Number(std::string(2000, '1') + "x" + std::string(2000, '1')), std::runtime_error);
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_int>();
+   test<number<cpp_int_backend<0, 0, signed_magnitude, checked> > >();
+   test<number<cpp_int_backend<0, 0, signed_magnitude, unchecked>, et_off> >();
+   return boost::report_errors();
+}
+
@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Compare modular arithmetic with cpp_mod_int_backend (using both Montgomery
+// and Barrett contexts) against GMP:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_mod_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include "test.hpp"
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   typedef boost::random::mt19937::result_type random_type;
+
+   T max_val = T(1) << bits_wanted;
+   unsigned bits_per_r_val = std::numeric_limits<random_type>::digits - 1;
+   while((random_type(1) << bits_per_r_val) > (gen.max)()) --bits_per_r_val;
+
+   unsigned terms_needed = bits_wanted / bits_per_r_val + 1;
+
+   T val = 0;
+   for(unsigned i = 0; i < terms_needed; ++i)
+   {
+      val *= (gen.max)();
+      val += gen();
+   }
+   val %= max_val;
+   return val;
+}
+
+boost::multiprecision::mpz_int reduce(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& m)
+{
+   boost::multiprecision::mpz_int r = a % m;
+   if(r < 0)
+      r += m;
+   return r;
+}
+
+template <class ModInt>
+void test_values(const boost::multiprecision::mpz_int& m, const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& b, const boost::multiprecision::mpz_int& c)
+{
+   using namespace boost::multiprecision;
+   typedef typename ModInt::backend_type::context_type context_type;
+   typedef typename ModInt::backend_type::int_backend_type int_backend_type;
+   typedef number<int_backend_type> int_type;
+
+   context_type ctx(int_type(m.str()));
+   ModInt x(ctx), y(ctx), z(ctx), r;
+   x = int_type(a.str());
+   y = int_type(b.str());
+   z = int_type(c.str());
+
+   BOOST_CHECK_EQUAL(reduce(a, m).str(), x.str());
+   BOOST_CHECK_EQUAL(reduce(a, m).str(), residue(x).str());
+   r = x * y;
+   BOOST_CHECK_EQUAL(reduce(a * b, m).str(), r.str());
+   r = x * y + z;
+   BOOST_CHECK_EQUAL(reduce(a * b + c, m).str(), r.str());
+   r = x * y - z;
+   BOOST_CHECK_EQUAL(reduce(a * b - c, m).str(), r.str());
+   r = x + y + z;
+   BOOST_CHECK_EQUAL(reduce(a + b + c, m).str(), r.str());
+   r = z - x - y;
+   BOOST_CHECK_EQUAL(reduce(c - a - b, m).str(), r.str());
+   r = -x;
+   BOOST_CHECK_EQUAL(reduce(-a, m).str(), r.str());
+   r = x * x * x - y * y + 3 * z - 7;
+   BOOST_CHECK_EQUAL(reduce(a * a * a - b * b + 3 * c - 7, m).str(), r.str());
+   r = x;
+   r *= r;
+   r += r;
+   r -= y;
+   BOOST_CHECK_EQUAL(reduce(2 * a * a - b, m).str(), r.str());
+   r = pow(x, 17);
+   BOOST_CHECK_EQUAL(mpz_int(powm(reduce(a, m), 17, m)).str(), r.str());
+   //
+   // Comparison:
+   //
+   BOOST_CHECK(x == x);
+   BOOST_CHECK_EQUAL(x == y, reduce(a, m) == reduce(b, m));
+   BOOST_CHECK_EQUAL(x < y, reduce(a, m) < reduce(b, m));
+   r = x - x;
+   BOOST_CHECK(r == 0);
+   BOOST_CHECK(r.is_zero());
+   r += 1;
+   BOOST_CHECK(r == 1);
+   //
+   // Negative values are reduced into [0, m):
+   //
+   r = ModInt(ctx);
+   r = -int_type(a.str());
+   BOOST_CHECK_EQUAL(reduce(-a, m).str(), r.str());
+   r = -5;
+   BOOST_CHECK_EQUAL(reduce(mpz_int(-5), m).str(), r.str());
+   //
+   // A second context with the same modulus is compatible, one with a different modulus is not:
+   //
+   context_type ctx2(int_type(m.str()));
+   ModInt w(ctx2);
+   w = int_type(c.str());
+   r = x * w;
+   BOOST_CHECK_EQUAL(reduce(a * c, m).str(), r.str());
+   context_type ctx3(int_type(mpz_int(m - 2).str()));
+   ModInt v(ctx3);
+   v = 2;
+   BOOST_CHECK_THROW(ModInt(x * v), std::runtime_error);
+   //
+   // Rebinding:
+   //
+   r = x;
+   r.backend().bind(ctx3);
+   BOOST_CHECK_EQUAL(reduce(reduce(a, m), mpz_int(m - 2)).str(), r.str());
+}
+
+template <class ModInt>
+void test(const unsigned* sizes, unsigned n, bool odd_only, unsigned max_bits)
+{
+   using namespace boost::multiprecision;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      for(unsigned k = 0; k < 3; ++k)
+      {
+         mpz_int m = generate_random<mpz_int>(sizes[i]);
+         bit_set(m, sizes[i] - 1);
+         if(odd_only || k)
+            bit_set(m, 0);
+         else
+            bit_unset(m, 0);
+         mpz_int a = generate_random<mpz_int>((std::min)(sizes[i] + 20 * k, max_bits));
+         mpz_int b = generate_random<mpz_int>(sizes[i]);
+         mpz_int c = generate_random<mpz_int>(sizes[i] / 2 + 1);
+         test_values<ModInt>(m, a, b, c);
+      }
+      //
+      // Moduli close to powers of the limb size:
+      //
+      test_values<ModInt>((mpz_int(1) << sizes[i]) - 1, generate_random<mpz_int>(sizes[i]), (mpz_int(1) << sizes[i]) - 2, 1);
+      test_values<ModInt>((mpz_int(1) << (sizes[i] - 1)) + 1, generate_random<mpz_int>(sizes[i]), mpz_int(1) << (sizes[i] - 1), 1);
+      if(!odd_only)
+         test_values<ModInt>(mpz_int(1) << (sizes[i] - 1), generate_random<mpz_int>((std::min)(2 * sizes[i], max_bits)), (mpz_int(1) << (sizes[i] - 1)) - 1, 3);
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   static const unsigned sizes[] = { 3, 64, 65, 128, 200, 1000, 2560, 3000, 8000 };
+   static const unsigned n = sizeof(sizes) / sizeof(sizes[0]);
+
+   test<cpp_montgomery_int>(sizes, n, true, 100000);
+   test<cpp_barrett_int>(sizes, n, false, 100000);
+   test<number<cpp_mod_int_backend<montgomery_context<cpp_int_backend<0, 0, signed_magnitude, checked> > >, et_off> >(sizes, n, true, 100000);
+   test<number<cpp_mod_int_backend<barrett_context<cpp_int_backend<0, 0, signed_magnitude, checked> > >, et_off> >(sizes, n, false, 100000);
+   //
+   // Fixed precision types, the modulus may use all the available bits:
+   //
+   static const unsigned fixed_sizes[] = { 3, 64, 65, 500, 1024 };
+   static const unsigned fixed_n = sizeof(fixed_sizes) / sizeof(fixed_sizes[0]);
+   test<number<cpp_mod_int_backend<montgomery_context<int1024_t::backend_type> > > >(fixed_sizes, fixed_n, true, 1024);
+   test<number<cpp_mod_int_backend<barrett_context<checked_int1024_t::backend_type> > > >(fixed_sizes, fixed_n, false, 1024);
+   return boost::report_errors();
+}
+
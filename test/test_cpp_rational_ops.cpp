@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Check the rational_adaptor arithmetic, which reduces its operands by cross-gcd's rather than
+// normalizing each result, against boost::rational, and check that every result is in lowest terms:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/rational.hpp>
+#include "test.hpp"
+
+typedef boost::rational<boost::multiprecision::cpp_int> reference_type;
+
+boost::multiprecision::cpp_int generate_integer(unsigned limbs)
+{
+   static boost::random::mt19937 gen;
+   boost::multiprecision::cpp_int result = 0;
+   for(unsigned i = 0; i < limbs; ++i)
+      result = (result << 32) | gen();
+   switch(gen() % 4)
+   {
+   case 0:
+      // Small values, which share factors often:
+      result = gen() % 1000 + 1;
+      break;
+   case 1:
+      // Highly composite values:
+      result *= 720720u;
+      break;
+   }
+   return result;
+}
+
+reference_type generate_random(unsigned i)
+{
+   using boost::multiprecision::cpp_int;
+   cpp_int n = generate_integer(i % 4 + 1);
+   cpp_int d = (i % 5 == 0) ? cpp_int(1) : generate_integer(i % 3 + 1);
+   if(d == 0)
+      d = 1;
+   if(i % 11 == 0)
+      n = 0;
+   if(i & 1)
+      n = -n;
+   return reference_type(n, d);
+}
+
+template <class T>
+void check(const T& val, const reference_type& ref)
+{
+   typedef typename boost::multiprecision::component_type<T>::type integer_type;
+   integer_type n = numerator(val), d = denominator(val);
+   BOOST_CHECK_EQUAL(boost::multiprecision::cpp_int(n), ref.numerator());
+   BOOST_CHECK_EQUAL(boost::multiprecision::cpp_int(d), ref.denominator());
+   // Lowest terms with a positive denominator:
+   BOOST_CHECK(d > 0);
+   BOOST_CHECK_EQUAL(gcd(n, d), 1);
+}
+
+template <class T>
+T convert(const reference_type& r)
+{
+   typedef typename boost::multiprecision::component_type<T>::type integer_type;
+   return T(integer_type(r.numerator()), integer_type(r.denominator()));
+}
+
+template <class T>
+void test()
+{
+   for(unsigned i = 0; i < 3000; ++i)
+   {
+      reference_type ra = generate_random(i), rb = generate_random(i * 7 + 3);
+      if(i % 13 == 0)
+         rb = ra;
+      else if(i % 17 == 0)
+         rb = -ra;
+      T a = convert<T>(ra), b = convert<T>(rb);
+      check(a, ra);
+      check(T(a + b), ra + rb);
+      check(T(a - b), ra - rb);
+      check(T(a * b), ra * rb);
+      if(rb != 0)
+         check(T(a / b), ra / rb);
+      BOOST_CHECK_EQUAL(a == b, ra == rb);
+      BOOST_CHECK_EQUAL(a < b, ra < rb);
+      BOOST_CHECK_EQUAL(a > b, ra > rb);
+      // Mixed with integers:
+      int k = static_cast<int>(i % 50) - 25;
+      check(T(a + k), ra + k);
+      check(T(a * k), ra * k);
+      if(k)
+         check(T(a / k), ra / k);
+      BOOST_CHECK_EQUAL(a < k, ra < k);
+      BOOST_CHECK_EQUAL(a == k, ra == k);
+      // Aliased arguments:
+      T t(a);
+      t += t;
+      check(t, ra + ra);
+      t = a;
+      t -= t;
+      check(t, reference_type(0));
+      t = a;
+      t *= t;
+      check(t, ra * ra);
+      t = b;
+      t = a - t;
+      check(t, ra - rb);
+      t = b;
+      t = a * t;
+      check(t, ra * rb);
+      if(ra != 0)
+      {
+         t = a;
+         t /= t;
+         check(t, reference_type(1));
+         t = a;
+         t = b / t;
+         check(t, rb / ra);
+      }
+   }
+   //
+   // Construction and assignment normalize their arguments:
+   //
+   check(T(6, -4), reference_type(-3, 2));
+   check(T(0, -7), reference_type(0));
+   check(T("-10/4"), reference_type(-5, 2));
+   check(T(0.375), reference_type(3, 8));
+   check(T(-12.0), reference_type(-12));
+   BOOST_CHECK_EQUAL(T(5, 3).str(), "5/3");
+   BOOST_CHECK_EQUAL(T(-8, 4).str(), "-2");
+   //
+   // The deprecated data() member still returns the value as a boost::rational:
+   //
+   BOOST_CHECK_EQUAL(T(-6, 4).backend().data().numerator(), -3);
+   BOOST_CHECK_EQUAL(T(-6, 4).backend().data().denominator(), 2);
+#ifndef BOOST_NO_EXCEPTIONS
+   T one(1), zero(0);
+   BOOST_CHECK_THROW(T(1, 0), std::overflow_error);
+   BOOST_CHECK_THROW(T(one / zero), std::overflow_error);
+#endif
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+   test<cpp_rational>();
+   test<checked_cpp_rational>();
+   test<number<rational_adaptor<int1024_t::backend_type> > >();
+   return boost::report_errors();
+}
+
@@ -216,6 +216,31 @@ void test()
 }
 
 
+//
+// At high precision log is evaluated by the AGM, except very close to 1, check both
+// against exp which is computed independently:
+//
+template <class T>
+void test_high_precision()
+{
+   unsigned max_err = 0;
+   T eps = ldexp(T(1), -20);
+   for(unsigned k = 1; k < 40; ++k)
+   {
+      T x = T(k) / 7;
+      T val = exp(log(x));
+      unsigned err = relative_error(val, x).template convert_to<unsigned>();
+      if(err > max_err)
+         max_err = err;
+      val = exp(log(1 + eps * k));
+      err = relative_error(val, T(1 + eps * k)).template convert_to<unsigned>();
+      if(err > max_err)
+         max_err = err;
+   }
+   std::cout << "Max error was: " << max_err << std::endl;
+   BOOST_TEST(max_err < 20);
+}
+
 int main()
 {
 #ifdef TEST_BACKEND
@@ -250,12 +275,14 @@ int main()
    test<boost::multiprecision::number<boost::multiprecision::cpp_dec_float<9> > >();
    test<boost::multiprecision::number<boost::multiprecision::cpp_dec_float<18> > >();
 #endif
+   test_high_precision<boost::multiprecision::number<boost::multiprecision::cpp_dec_float<1000> > >();
 #endif
 #ifdef TEST_FLOAT128
    test<boost::multiprecision::float128>();
 #endif
 #ifdef TEST_CPP_BIN_FLOAT
    test<boost::multiprecision::cpp_bin_float_50>();
+   test_high_precision<boost::multiprecision::number<boost::multiprecision::cpp_bin_float<1000> > >();
 #endif
    return boost::report_errors();
 }
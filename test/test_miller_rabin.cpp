@@ -67,6 +67,52 @@ void test()
       if(is_prime_boost != is_gmp_prime)
          std::cout << std::hex << std::showbase << "n = " << n << std::endl;
       BOOST_CHECK_EQUAL(is_prime_boost, is_gmp_prime);
+      BOOST_CHECK_EQUAL(baillie_psw_test(n), is_gmp_prime);
+   }
+   //
+   // Baillie-PSW must reject strong pseudoprimes to base 2, and agree with GMP on all
+   // the odd values in a range:
+   //
+   if(std::numeric_limits<test_type>::digits >= 79)
+   {
+      test_type spsp = static_cast<test_type>(mpz_int("318665857834031151167461"));
+      BOOST_CHECK(!baillie_psw_test(spsp));
+   }
+   if(std::numeric_limits<test_type>::digits >= 42)
+   {
+      // 6763 * 10627 * 29947 is a strong pseudoprime to base 2 with no factor in the trial division tables:
+      test_type spsp = static_cast<test_type>(mpz_int("2152302898747"));
+      BOOST_CHECK(!baillie_psw_test(spsp));
+   }
+   BOOST_CHECK(!baillie_psw_test(test_type(3215031751u)));
+   BOOST_CHECK(!baillie_psw_test(test_type(4099u * 4099u)));
+   for(unsigned i = 229; i < 20000; i += 2)
+   {
+      BOOST_CHECK_EQUAL(baillie_psw_test(test_type(i)), mpz_probab_prime_p(mpz_int(i).backend().data(), 25) ? true : false);
+   }
+   //
+   // The sieved prime search must find the same primes as GMP:
+   //
+   for(unsigned i = 0; i < 10100; ++i)
+   {
+      test_type n = i < 10000 ? test_type(i) : test_type(gen() >> 1);
+      mpz_int p, z(n);
+      mpz_nextprime(p.backend().data(), mpz_int(z - 1).backend().data());
+      BOOST_CHECK_EQUAL(mpz_int(next_probable_prime(n, 25, gen2)), p);
+   }
+   //
+   // And next_safe_prime must return the first p >= n for which p and (p - 1) / 2 are both prime:
+   //
+   for(unsigned i = 0; i < 5; ++i)
+   {
+      test_type n = i ? test_type(gen() >> (test_bits / 2)) : test_type(i);
+      mpz_int p(next_safe_prime(n, 25, gen2));
+      BOOST_CHECK(mpz_probab_prime_p(p.backend().data(), 25));
+      BOOST_CHECK(mpz_probab_prime_p(mpz_int(p >> 1).backend().data(), 25));
+      for(mpz_int z(n); z < p; ++z)
+      {
+         BOOST_CHECK(!mpz_probab_prime_p(z.backend().data(), 25) || !mpz_probab_prime_p(mpz_int(z >> 1).backend().data(), 25));
+      }
    }
 }
 
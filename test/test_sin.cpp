@@ -299,6 +299,25 @@ void test()
    }
    std::cout << "Max error was: " << max_err << std::endl;
    BOOST_TEST(max_err < 20);
+   //
+   // And again computing sin and cos together:
+   //
+   max_err = 0;
+   for(unsigned k = 0; k < sincos.size(); k++)
+   {
+      T s, c;
+      boost::multiprecision::sincos(sincos[k][0], s, c);
+      T e = relative_error(s, sincos[k][1]);
+      unsigned err = e.template convert_to<unsigned>();
+      if(err > max_err)
+         max_err = err;
+      e = relative_error(c, sincos[k][2]);
+      err = e.template convert_to<unsigned>();
+      if(err > max_err)
+         max_err = err;
+   }
+   std::cout << "Max error was: " << max_err << std::endl;
+   BOOST_TEST(max_err < 20);
 
 }
 
@@ -176,6 +176,16 @@ void test()
       {
          max_err = err;
       }
+      if(k)
+      {
+         val = rsqrt(pi * k);
+         e = relative_error(val, T(1 / T(data[k])));
+         err = e.template convert_to<unsigned>();
+         if(err > max_err)
+         {
+            max_err = err;
+         }
+      }
    }
    std::cout << "Max error was: " << max_err << std::endl;
 #if defined(BOOST_INTEL) && defined(TEST_FLOAT128)
@@ -188,6 +198,15 @@ void test()
    //
    BOOST_CHECK((boost::math::isfinite)(sqrt((std::numeric_limits<T>::max)())));
    BOOST_CHECK((boost::math::isfinite)(sqrt((std::numeric_limits<T>::min)())));
+   BOOST_CHECK((boost::math::isfinite)(rsqrt((std::numeric_limits<T>::max)())));
+   BOOST_CHECK((boost::math::isfinite)(rsqrt((std::numeric_limits<T>::min)())));
+   BOOST_CHECK(relative_error(T(rsqrt(T(4))), T(0.5)) < 2);
+   BOOST_CHECK_EQUAL(rsqrt(T(1)), 1);
+   if(std::numeric_limits<T>::has_infinity)
+   {
+      BOOST_CHECK_EQUAL(rsqrt(T(0)), std::numeric_limits<T>::infinity());
+      BOOST_CHECK_EQUAL(rsqrt(std::numeric_limits<T>::infinity()), 0);
+   }
 }
 
 
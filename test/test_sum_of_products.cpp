@@ -0,0 +1,289 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Check sum_of_products, and the fused evaluation of expressions such as a*b + c*d, against
+// sums computed exactly at much higher precision:
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <vector>
+#include "test.hpp"
+
+//
+// A user supplied accumulator more than twice as wide as the type it accumulates:
+//
+namespace boost{ namespace multiprecision{
+
+template <>
+struct sum_of_products_accumulator<backends::cpp_bin_float<64, backends::digit_base_2> >
+{
+   typedef backends::cpp_bin_float<256, backends::digit_base_2, void, boost::long_long_type> type;
+};
+
+}}
+
+//
+// Large enough to hold every sum below exactly:
+//
+typedef boost::multiprecision::number<boost::multiprecision::cpp_bin_float<1500, boost::multiprecision::digit_base_2> > reference_type;
+
+template <class T>
+T generate_random()
+{
+   static boost::random::mt19937 gen;
+   T val = gen();
+   T prev_val = -1;
+   while(val != prev_val)
+   {
+      val *= (gen.max)();
+      prev_val = val;
+      val += gen();
+   }
+   int e;
+   val = frexp(val, &e);
+   return ldexp(val, static_cast<int>(gen() % 200) - 100);
+}
+
+template <class T>
+reference_type reference_sum(const std::vector<T>& a, const std::vector<T>& b, reference_type* abs_sum)
+{
+   reference_type sum = 0;
+   *abs_sum = 0;
+   for(unsigned i = 0; i < a.size(); ++i)
+   {
+      reference_type p = reference_type(a[i]) * reference_type(b[i]);
+      sum += p;
+      *abs_sum += abs(p);
+   }
+   return sum;
+}
+
+template <class T>
+void test_accuracy()
+{
+   static const reference_type eps = std::numeric_limits<T>::epsilon();
+   for(unsigned i = 0; i < 200; ++i)
+   {
+      unsigned n = i % 40 + 1;
+      std::vector<T> a(n), b(n);
+      for(unsigned j = 0; j < n; ++j)
+      {
+         a[j] = generate_random<T>();
+         b[j] = generate_random<T>();
+         if((i & 1) && (j & 1))
+            a[j] = -a[j];
+      }
+      if((i & 1) && (n > 2))
+      {
+         // Force cancellation of the two largest terms:
+         a[1] = -a[0];
+         b[1] = b[0];
+      }
+      reference_type abs_sum;
+      reference_type exact = reference_sum(a, b, &abs_sum);
+      T r = sum_of_products(a, b);
+      BOOST_CHECK_EQUAL(r, sum_of_products(a.begin(), a.end(), b.begin()));
+      //
+      // One rounding at the end, plus the rounding of each partial sum in the double width accumulator:
+      //
+      reference_type err = abs(reference_type(r) - exact);
+      reference_type bound = eps * abs(exact) + n * eps * eps * abs_sum;
+      BOOST_CHECK(err <= bound);
+      if(!(i & 1))
+      {
+         // With no cancellation the result is within 1ulp:
+         BOOST_CHECK(err <= eps * abs(exact));
+      }
+   }
+}
+
+template <class T>
+void test_expressions()
+{
+   for(unsigned i = 0; i < 200; ++i)
+   {
+      T a = generate_random<T>(), b = generate_random<T>(), c = generate_random<T>();
+      T d = generate_random<T>(), e = generate_random<T>(), f = generate_random<T>();
+      if(i % 3 == 0)
+      {
+         c = -a;
+         d = b;
+      }
+      std::vector<T> x(3), y(3);
+      x[0] = a; x[1] = c; x[2] = e;
+      y[0] = b; y[1] = d; y[2] = f;
+      BOOST_CHECK_EQUAL(T(a * b + c * d + e * f), sum_of_products(x, y));
+      T t = a * b + c * d + e * f;
+      BOOST_CHECK_EQUAL(t, sum_of_products(x, y));
+      y[1] = -d;
+      y[2] = -f;
+      BOOST_CHECK_EQUAL(T(a * b - c * d - e * f), sum_of_products(x, y));
+      BOOST_CHECK_EQUAL(T(-(c * d) + a * b - e * f), sum_of_products(x, y));
+      y[2] = -1;
+      x[2] = e;
+      BOOST_CHECK_EQUAL(T(a * b - c * d - e), sum_of_products(x, y));
+      BOOST_CHECK_EQUAL(T(a * b - (c * d + e)), sum_of_products(x, y));
+      // Aliased arguments:
+      t = a;
+      t = t * b - c * d - e;
+      BOOST_CHECK_EQUAL(t, sum_of_products(x, y));
+      // Expressions with just one product are unchanged:
+      BOOST_CHECK_EQUAL(T(a * b + c), T(T(a * b) + c));
+   }
+}
+
+template <class T>
+void test_special_values()
+{
+   T one(1), zero(0), inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+   T big = (std::numeric_limits<T>::max)(), small = (std::numeric_limits<T>::min)();
+   std::vector<T> a(2), b(2);
+   a[0] = inf; b[0] = one; a[1] = one; b[1] = one;
+   BOOST_CHECK_EQUAL(sum_of_products(a, b), inf);
+   a[1] = -inf;
+   BOOST_CHECK((boost::math::isnan)(sum_of_products(a, b)));
+   a[1] = one; b[0] = zero;
+   BOOST_CHECK((boost::math::isnan)(sum_of_products(a, b)));
+   a[0] = nan; b[0] = one;
+   BOOST_CHECK((boost::math::isnan)(sum_of_products(a, b)));
+   a[0] = zero; b[0] = zero; a[1] = zero; b[1] = -one;
+   BOOST_CHECK_EQUAL(sum_of_products(a, b), 0);
+   // Overflow and underflow of the result, and of an intermediate which the final sum recovers from:
+   a[0] = big; b[0] = big; a[1] = one; b[1] = one;
+   BOOST_CHECK_EQUAL(sum_of_products(a, b), inf);
+   a[0] = small; b[0] = small;
+   BOOST_CHECK_EQUAL(sum_of_products(a, b), 1);
+   a[0] = big; b[0] = 2; a[1] = -big; b[1] = 2;
+   BOOST_CHECK_EQUAL(sum_of_products(a, b), 0);
+   a[1] = big; b[1] = -1;
+   BOOST_CHECK_EQUAL(sum_of_products(a, b), big);
+   a[0] = small; b[0] = small; a[1] = small; b[1] = -small;
+   BOOST_CHECK_EQUAL(sum_of_products(a, b), 0);
+   BOOST_CHECK_EQUAL(sum_of_products(a.begin(), a.begin(), b.begin()), 0);
+}
+
+//
+// Special values keep their meaning when converted between precisions:
+//
+template <class T, class U>
+void test_conversions()
+{
+   T one(1), inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+   BOOST_CHECK_EQUAL(U(inf), std::numeric_limits<U>::infinity());
+   BOOST_CHECK_EQUAL(U(-inf), -std::numeric_limits<U>::infinity());
+   BOOST_CHECK((boost::math::isnan)(U(nan)));
+   BOOST_CHECK_EQUAL(U(T(0)), 0);
+   BOOST_CHECK_EQUAL(U(one), 1);
+   U u;
+   u.assign(inf);
+   BOOST_CHECK_EQUAL(u, std::numeric_limits<U>::infinity());
+   u.assign(nan);
+   BOOST_CHECK((boost::math::isnan)(u));
+   u.assign(T(one / 3));
+   if(std::numeric_limits<U>::digits < std::numeric_limits<T>::digits)
+   {
+      BOOST_CHECK_EQUAL(u, U(U(1) / 3));
+   }
+   else
+   {
+      BOOST_CHECK_EQUAL(T(u), T(one / 3));
+   }
+}
+
+//
+// Every product of two T's fits exactly in an accumulator of at least twice the width, so accumulating
+// one product into zero must give it exactly, however much wider the accumulator is:
+//
+template <class T, class Accumulator>
+void test_wide_accumulator()
+{
+   typedef boost::multiprecision::number<Accumulator> accumulator_number;
+   accumulator_number acc;
+   T a(3), b(5);
+   acc = 0;
+   boost::multiprecision::default_ops::eval_accumulate_product(acc.backend(), a.backend(), b.backend(), false);
+   BOOST_CHECK_EQUAL(acc, 15);
+   boost::multiprecision::default_ops::eval_accumulate_product(acc.backend(), a.backend(), a.backend(), true);
+   BOOST_CHECK_EQUAL(acc, 6);
+   for(unsigned i = 0; i < 200; ++i)
+   {
+      a = generate_random<T>();
+      b = generate_random<T>();
+      if(i & 1)
+         a = -a;
+      acc = 0;
+      boost::multiprecision::default_ops::eval_accumulate_product(acc.backend(), a.backend(), b.backend(), false);
+      BOOST_CHECK_EQUAL(reference_type(acc), reference_type(a) * reference_type(b));
+   }
+}
+
+//
+// Types without a wider accumulator just add up their products, check the results are exact for integers:
+//
+template <class T>
+void test_generic()
+{
+   static boost::random::mt19937 gen;
+   for(unsigned i = 0; i < 100; ++i)
+   {
+      std::vector<T> a(i % 20 + 1), b(i % 20 + 1);
+      long long sum = 0;
+      for(unsigned j = 0; j < a.size(); ++j)
+      {
+         int x = static_cast<int>(gen() % 20000) - 10000, y = static_cast<int>(gen() % 20000) - 10000;
+         a[j] = x;
+         b[j] = y;
+         sum += static_cast<long long>(x) * y;
+      }
+      BOOST_CHECK_EQUAL(sum_of_products(a, b), sum);
+      if(a.size() >= 3)
+      {
+         long long expected = static_cast<long long>(a[0].template convert_to<int>()) * b[0].template convert_to<int>()
+            - static_cast<long long>(a[1].template convert_to<int>()) * b[1].template convert_to<int>() - a[2].template convert_to<int>();
+         BOOST_CHECK_EQUAL(T(a[0] * b[0] - a[1] * b[1] - a[2]), expected);
+         T t = a[0];
+         t = t * b[0] - a[1] * b[1] - a[2];
+         BOOST_CHECK_EQUAL(t, expected);
+      }
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+   typedef number<cpp_bin_float<113, digit_base_2>, et_on> float128_type;
+   typedef number<cpp_bin_float<300, digit_base_2>, et_on> float300_type;
+   test_accuracy<float128_type>();
+   test_accuracy<float300_type>();
+   test_accuracy<cpp_bin_float_50>();
+   test_accuracy<number<cpp_bin_float<64, digit_base_2, void, boost::long_long_type, -100000, 100000> > >();
+   test_expressions<float128_type>();
+   test_expressions<float300_type>();
+   test_expressions<number<cpp_bin_float<50>, et_on> >();
+   test_special_values<float128_type>();
+   test_special_values<cpp_bin_float_100>();
+   test_conversions<float128_type, float300_type>();
+   test_conversions<float300_type, float128_type>();
+   test_conversions<cpp_bin_float_50, number<cpp_bin_float<200, digit_base_2, void, boost::long_long_type> > >();
+   test_wide_accumulator<float128_type, cpp_bin_float<226, digit_base_2> >();
+   test_wide_accumulator<float128_type, cpp_bin_float<300, digit_base_2> >();
+   test_wide_accumulator<number<cpp_bin_float<64, digit_base_2> >, cpp_bin_float<256, digit_base_2, void, boost::long_long_type> >();
+   test_accuracy<number<cpp_bin_float<64, digit_base_2> > >();
+   test_expressions<number<cpp_bin_float<64, digit_base_2>, et_on> >();
+   test_generic<cpp_dec_float_50>();
+   test_generic<number<cpp_dec_float<50>, et_on> >();
+   test_generic<cpp_int>();
+   test_generic<int128_t>();
+   return boost::report_errors();
+}
+